@@ -9,7 +9,7 @@ pub fn build(b: *std.Build) void {
 
     // Embedded config: -Dmax_layout_elements=64 (default 4096)
     // For embedded systems: use 64-256 elements to fit in <32KB RAM
-    const max_layout_elements = b.option(u32, "max_layout_elements", "Maximum layout elements (default 4096, embedded: 64-256)") orelse 4096;
+    const max_layout_elements = b.option(u32, "max_layout_elements", "Capacity of fixed-storage layout engines (default 4096, embedded: 64-256)") orelse 4096;
 
     // Create build options module for compile-time configuration
     const build_options = b.addOptions();
@@ -17,7 +17,6 @@ pub fn build(b: *std.Build) void {
     build_options.addOption(u32, "max_layout_elements", max_layout_elements);
 
     // Create zig-gui module for examples to import
-    // Note: zlay is now integrated into src/layout/ instead of separate module
     const zig_gui_mod = b.addModule("zig-gui", .{
         .root_source_file = b.path("src/root.zig"),
     });
@@ -146,6 +145,7 @@ pub fn build(b: *std.Build) void {
         .target = target,
         .optimize = .ReleaseFast, // Always optimize for accurate benchmarks
     });
+    multi_res_benchmark_exe.root_module.addImport("zig-gui", zig_gui_mod);
     b.installArtifact(multi_res_benchmark_exe);
 
     const multi_res_benchmark_run = b.addRunArtifact(multi_res_benchmark_exe);
@@ -154,6 +154,130 @@ pub fn build(b: *std.Build) void {
     const multi_res_benchmark_step = b.step("multi-res-benchmark", "Run multi-resolution benchmark (mobile/desktop/4K)");
     multi_res_benchmark_step.dependOn(&multi_res_benchmark_run.step);
 
+    // Parallel layout benchmark (fixed-size subtrees on 1..N threads)
+    const parallel_layout_benchmark_exe = b.addExecutable(.{
+        .name = "parallel_layout_benchmark",
+        .root_source_file = b.path("examples/parallel_layout_benchmark.zig"),
+        .target = target,
+        .optimize = .ReleaseFast, // Always optimize for accurate benchmarks
+    });
+    parallel_layout_benchmark_exe.root_module.addImport("zig-gui", zig_gui_mod);
+    b.installArtifact(parallel_layout_benchmark_exe);
+
+    const parallel_layout_benchmark_run = b.addRunArtifact(parallel_layout_benchmark_exe);
+    parallel_layout_benchmark_run.step.dependOn(b.getInstallStep());
+
+    const parallel_layout_benchmark_step = b.step("parallel-layout-benchmark", "Run parallel layout benchmark (scaling 1..N threads)");
+    parallel_layout_benchmark_step.dependOn(&parallel_layout_benchmark_run.step);
+
+    // Flex-wrap benchmark (1K children in a wrapping container)
+    const flex_wrap_benchmark_exe = b.addExecutable(.{
+        .name = "flex_wrap_benchmark",
+        .root_source_file = b.path("examples/flex_wrap_benchmark.zig"),
+        .target = target,
+        .optimize = .ReleaseFast, // Always optimize for accurate benchmarks
+    });
+    flex_wrap_benchmark_exe.root_module.addImport("zig-gui", zig_gui_mod);
+    b.installArtifact(flex_wrap_benchmark_exe);
+
+    const flex_wrap_benchmark_run = b.addRunArtifact(flex_wrap_benchmark_exe);
+    flex_wrap_benchmark_run.step.dependOn(b.getInstallStep());
+
+    const flex_wrap_benchmark_step = b.step("flex-wrap-benchmark", "Run flex-wrap benchmark (1K wrapped children)");
+    flex_wrap_benchmark_step.dependOn(&flex_wrap_benchmark_run.step);
+
+    // Flex SIMD benchmark (vectorized flex resolution, 64-1024 children)
+    const flex_simd_benchmark_exe = b.addExecutable(.{
+        .name = "flex_simd_benchmark",
+        .root_source_file = b.path("examples/flex_simd_benchmark.zig"),
+        .target = target,
+        .optimize = .ReleaseFast, // Always optimize for accurate benchmarks
+    });
+    flex_simd_benchmark_exe.root_module.addImport("zig-gui", zig_gui_mod);
+    b.installArtifact(flex_simd_benchmark_exe);
+
+    const flex_simd_benchmark_run = b.addRunArtifact(flex_simd_benchmark_exe);
+    flex_simd_benchmark_run.step.dependOn(b.getInstallStep());
+
+    const flex_simd_benchmark_step = b.step("flex-simd-benchmark", "Run flex SIMD benchmark (SoA resolution vs scalar)");
+    flex_simd_benchmark_step.dependOn(&flex_simd_benchmark_run.step);
+
+    // Scalar benchmark (flexbox in f32 vs i32 pixels vs Q16.16 fixed point)
+    const scalar_benchmark_exe = b.addExecutable(.{
+        .name = "scalar_benchmark",
+        .root_source_file = b.path("examples/scalar_benchmark.zig"),
+        .target = target,
+        .optimize = .ReleaseFast, // Always optimize for accurate benchmarks
+    });
+    scalar_benchmark_exe.root_module.addImport("zig-gui", zig_gui_mod);
+    b.installArtifact(scalar_benchmark_exe);
+
+    const scalar_benchmark_run = b.addRunArtifact(scalar_benchmark_exe);
+    scalar_benchmark_run.step.dependOn(b.getInstallStep());
+
+    const scalar_benchmark_step = b.step("scalar-benchmark", "Run scalar benchmark (f32 vs integer and fixed-point layout)");
+    scalar_benchmark_step.dependOn(&scalar_benchmark_run.step);
+
+    // Flex specialize benchmark (comptime-specialized single-line passes vs generic)
+    const flex_specialize_benchmark_exe = b.addExecutable(.{
+        .name = "flex_specialize_benchmark",
+        .root_source_file = b.path("examples/flex_specialize_benchmark.zig"),
+        .target = target,
+        .optimize = .ReleaseFast, // Always optimize for accurate benchmarks
+    });
+    flex_specialize_benchmark_exe.root_module.addImport("zig-gui", zig_gui_mod);
+    b.installArtifact(flex_specialize_benchmark_exe);
+
+    const flex_specialize_benchmark_run = b.addRunArtifact(flex_specialize_benchmark_exe);
+    flex_specialize_benchmark_run.step.dependOn(b.getInstallStep());
+
+    const flex_specialize_benchmark_step = b.step("flex-specialize-benchmark", "Run flex specialize benchmark (12 container shapes, specialized vs generic)");
+    flex_specialize_benchmark_step.dependOn(&flex_specialize_benchmark_run.step);
+
+    // Rounded rect benchmark (anti-aliased corners vs square corners in SoftwareBackend)
+    const rounded_rect_benchmark_exe = b.addExecutable(.{
+        .name = "rounded_rect_benchmark",
+        .root_source_file = b.path("examples/rounded_rect_benchmark.zig"),
+        .target = target,
+        .optimize = .ReleaseFast, // Always optimize for accurate benchmarks
+    });
+    rounded_rect_benchmark_exe.root_module.addImport("zig-gui", zig_gui_mod);
+    b.installArtifact(rounded_rect_benchmark_exe);
+
+    const rounded_rect_benchmark_run = b.addRunArtifact(rounded_rect_benchmark_exe);
+    rounded_rect_benchmark_run.step.dependOn(b.getInstallStep());
+
+    const rounded_rect_benchmark_step = b.step("rounded-rect-benchmark", "Run rounded rect benchmark (anti-aliased vs square corners)");
+    rounded_rect_benchmark_step.dependOn(&rounded_rect_benchmark_run.step);
+
+    // Layout benchmark: LayoutEngine vs Clay on generated trees (zig build bench-layout)
+    // Clay is compiled in when its header is available: -Dclay_include=<dir with clay.h>
+    const clay_include = b.option([]const u8, "clay_include", "Directory containing clay.h; enables the Clay comparison in bench-layout");
+    const bench_layout_options = b.addOptions();
+    bench_layout_options.addOption(bool, "has_clay", clay_include != null);
+
+    const bench_layout_exe = b.addExecutable(.{
+        .name = "bench_layout",
+        .root_source_file = b.path("examples/benchmark.zig"),
+        .target = target,
+        .optimize = .ReleaseFast, // Always optimize for accurate benchmarks
+    });
+    bench_layout_exe.root_module.addImport("zig-gui", zig_gui_mod);
+    bench_layout_exe.root_module.addOptions("bench_options", bench_layout_options);
+    if (clay_include) |dir| {
+        bench_layout_exe.addIncludePath(.{ .cwd_relative = dir });
+        bench_layout_exe.addCSourceFile(.{ .file = b.path("deps/zig-clay/src/clay.c"), .flags = &.{"-O2"} });
+        bench_layout_exe.linkLibC();
+    }
+    b.installArtifact(bench_layout_exe);
+
+    const bench_layout_run = b.addRunArtifact(bench_layout_exe);
+    bench_layout_run.step.dependOn(b.getInstallStep());
+    if (b.args) |args| bench_layout_run.addArgs(args);
+
+    const bench_layout_step = b.step("bench-layout", "Run layout benchmark and differential checks (LayoutEngine vs Clay, full and incremental)");
+    bench_layout_step.dependOn(&bench_layout_run.step);
+
     // Run all examples
     const examples_step = b.step("examples", "Run all examples");
     examples_step.dependOn(&counter_run.step);
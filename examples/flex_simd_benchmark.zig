@@ -0,0 +1,187 @@
+//! Flex SIMD Benchmark - vectorized flex resolution on wide containers
+//!
+//! Toolbar / table-row shape: one row container with 64-1024 children, a
+//! mix of growers, shrinkers and max-clamped items, so the freeze loop runs
+//! more than one round.
+//!
+//! Measures:
+//! - Kernel: simd.resolveFlexible vs the scalar reference
+//! - Kernel: simd.cumulativeSum vs a scalar running sum
+//! - End to end: computeFlexLayout per container and per child
+//!
+//! Target: 2x+ kernel speedup at 64+ children.
+//!
+//! Build and run:
+//!   zig build flex-simd-benchmark
+
+const std = @import("std");
+const zig_gui = @import("zig-gui");
+
+const simd = zig_gui.layout.simd;
+const FlexStyle = zig_gui.layout.FlexStyle;
+const LayoutResult = zig_gui.layout.LayoutResult;
+const computeFlexLayout = zig_gui.layout.computeFlexLayout;
+
+const CHILD_COUNTS = [_]usize{ 64, 256, 1024 };
+const WARMUP_ITERATIONS = 1000;
+const ITERATIONS = 20000;
+
+/// SoA inputs for the resolution kernels
+const Lanes = struct {
+    base: []f32,
+    factor: []f32,
+    min: []f32,
+    max: []f32,
+    size: []f32,
+
+    fn init(allocator: std.mem.Allocator, count: usize) !Lanes {
+        const lanes = Lanes{
+            .base = try allocator.alloc(f32, count),
+            .factor = try allocator.alloc(f32, count),
+            .min = try allocator.alloc(f32, count),
+            .max = try allocator.alloc(f32, count),
+            .size = try allocator.alloc(f32, count),
+        };
+        for (0..count) |i| {
+            lanes.base[i] = @floatFromInt(20 + (i * 37) % 80);
+            lanes.min[i] = 10;
+            // Every 7th item caps out, forcing a second freeze round
+            lanes.max[i] = if (i % 7 == 0) 40 else std.math.inf(f32);
+        }
+        return lanes;
+    }
+
+    fn deinit(self: Lanes, allocator: std.mem.Allocator) void {
+        allocator.free(self.base);
+        allocator.free(self.factor);
+        allocator.free(self.min);
+        allocator.free(self.max);
+        allocator.free(self.size);
+    }
+
+    fn resetFactors(self: Lanes) void {
+        for (self.factor, 0..) |*f, i| f.* = @floatFromInt(1 + i % 3);
+    }
+};
+
+fn childStyle(i: usize) FlexStyle {
+    return .{
+        .width = @floatFromInt(20 + (i * 37) % 80),
+        .height = 24,
+        .flex_grow = @floatFromInt(i % 3),
+        .max_width = if (i % 7 == 0) 40 else std.math.inf(f32),
+    };
+}
+
+fn nsPerIteration(timer: *std.time.Timer) f64 {
+    const elapsed: f64 = @floatFromInt(timer.read());
+    return elapsed / ITERATIONS;
+}
+
+fn benchResolve(lanes: Lanes, available: f32, comptime vectorized: bool) f64 {
+    const resolve = if (vectorized) simd.resolveFlexible else simd.resolveFlexibleScalar;
+
+    for (0..WARMUP_ITERATIONS) |_| {
+        lanes.resetFactors();
+        resolve(lanes.base, lanes.factor, lanes.min, lanes.max, lanes.size, available);
+    }
+
+    var timer = std.time.Timer.start() catch unreachable;
+    for (0..ITERATIONS) |_| {
+        lanes.resetFactors();
+        resolve(lanes.base, lanes.factor, lanes.min, lanes.max, lanes.size, available);
+        std.mem.doNotOptimizeAway(lanes.size.ptr);
+    }
+    return nsPerIteration(&timer);
+}
+
+fn scalarPrefixSum(values: []f32) void {
+    for (values[1..], 0..) |*val, i| {
+        val.* += values[i];
+    }
+}
+
+fn benchPrefixSum(values: []f32, source: []const f32, comptime vectorized: bool) f64 {
+    var timer = std.time.Timer.start() catch unreachable;
+    for (0..ITERATIONS) |_| {
+        @memcpy(values, source);
+        if (vectorized) simd.cumulativeSum(values) else scalarPrefixSum(values);
+        std.mem.doNotOptimizeAway(values.ptr);
+    }
+    return nsPerIteration(&timer);
+}
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    std.debug.print("\n", .{});
+    std.debug.print("╔══════════════════════════════════════════════════════════════════╗\n", .{});
+    std.debug.print("║  zig-gui Flex SIMD Benchmark                                    ║\n", .{});
+    std.debug.print("╚══════════════════════════════════════════════════════════════════╝\n", .{});
+    std.debug.print("\n", .{});
+    std.debug.print("- Vector width: {d} x f32, {d} iterations\n", .{ simd.LANES, ITERATIONS });
+
+    var arena = std.heap.ArenaAllocator.init(allocator);
+    defer arena.deinit();
+
+    for (CHILD_COUNTS) |count| {
+        const count_f: f32 = @floatFromInt(count);
+        // 1.5x the summed base sizes: every row grows
+        const available = count_f * 60 * 1.5;
+
+        // Resolution kernel
+        const lanes = try Lanes.init(allocator, count);
+        defer lanes.deinit(allocator);
+
+        const scalar_resolve_ns = benchResolve(lanes, available, false);
+        const simd_resolve_ns = benchResolve(lanes, available, true);
+
+        // Prefix-sum kernel
+        const source = try allocator.dupe(f32, lanes.base);
+        defer allocator.free(source);
+        const values = try allocator.alloc(f32, count);
+        defer allocator.free(values);
+
+        const scalar_scan_ns = benchPrefixSum(values, source, false);
+        const simd_scan_ns = benchPrefixSum(values, source, true);
+
+        // End to end
+        const styles = try allocator.alloc(FlexStyle, count);
+        defer allocator.free(styles);
+        for (styles, 0..) |*style, i| style.* = childStyle(i);
+        const results = try allocator.alloc(LayoutResult, count);
+        defer allocator.free(results);
+
+        const container = FlexStyle{ .direction = .row, .gap = 2, .align_items = .center };
+        for (0..WARMUP_ITERATIONS) |_| {
+            _ = arena.reset(.retain_capacity);
+            try computeFlexLayout(arena.allocator(), available, 48, container, styles, results);
+        }
+        var timer = try std.time.Timer.start();
+        for (0..ITERATIONS) |_| {
+            _ = arena.reset(.retain_capacity);
+            try computeFlexLayout(arena.allocator(), available, 48, container, styles, results);
+            std.mem.doNotOptimizeAway(results.ptr);
+        }
+        const layout_ns = nsPerIteration(&timer);
+
+        std.debug.print("\n{d} children:\n", .{count});
+        std.debug.print("  resolve  scalar {d:>9.1} ns   simd {d:>9.1} ns   {d:>5.2}x\n", .{
+            scalar_resolve_ns,
+            simd_resolve_ns,
+            scalar_resolve_ns / simd_resolve_ns,
+        });
+        std.debug.print("  scan     scalar {d:>9.1} ns   simd {d:>9.1} ns   {d:>5.2}x\n", .{
+            scalar_scan_ns,
+            simd_scan_ns,
+            scalar_scan_ns / simd_scan_ns,
+        });
+        std.debug.print("  computeFlexLayout {d:>8.2} us   per child {d:>7.4} us\n", .{
+            layout_ns / 1000.0,
+            layout_ns / 1000.0 / count_f,
+        });
+    }
+    std.debug.print("\n", .{});
+}
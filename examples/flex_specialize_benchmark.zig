@@ -0,0 +1,113 @@
+//! Flex Specialize Benchmark - comptime-specialized single-line passes
+//!
+//! computeFlexLayout dispatches row/column x flex_start/center/space_between
+//! x stretch/flex_start containers to a pass compiled for that shape, so
+//! its per-child loops carry no direction/justify/align branches. This
+//! times every one of those 12 shapes against the generic pass
+//! (Flexbox.computeFlexLayoutGeneric) on the same children.
+//!
+//! Target: specialized never slower than generic; faster on wide rows.
+//!
+//! Build and run:
+//!   zig build flex-specialize-benchmark
+
+const std = @import("std");
+const zig_gui = @import("zig-gui");
+
+const FlexStyle = zig_gui.layout.FlexStyle;
+const LayoutResult = zig_gui.layout.LayoutResult;
+const float_flexbox = zig_gui.layout.Flexbox(zig_gui.layout.scalar.Float);
+
+const CHILD_COUNTS = [_]usize{ 16, 256 };
+const WARMUP_ITERATIONS = 1000;
+const ITERATIONS = 20000;
+
+const DIRECTIONS = [_]zig_gui.layout.FlexDirection{ .row, .column };
+const JUSTIFIES = [_]zig_gui.layout.JustifyContent{ .flex_start, .center, .space_between };
+const ALIGNS = [_]zig_gui.layout.AlignItems{ .stretch, .flex_start };
+
+fn childStyle(i: usize) FlexStyle {
+    return .{
+        .width = if (i % 4 == 0) -1 else @floatFromInt(20 + (i * 37) % 60),
+        .height = if (i % 3 == 0) -1 else @floatFromInt(12 + (i * 11) % 20),
+        .flex_grow = @floatFromInt(i % 2),
+    };
+}
+
+fn benchLayout(
+    arena: *std.heap.ArenaAllocator,
+    container: FlexStyle,
+    styles: []const FlexStyle,
+    results: []LayoutResult,
+    comptime specialized: bool,
+) !f64 {
+    const compute = if (specialized) float_flexbox.computeFlexLayout else float_flexbox.computeFlexLayoutGeneric;
+
+    for (0..WARMUP_ITERATIONS) |_| {
+        _ = arena.reset(.retain_capacity);
+        try compute(arena.allocator(), 4000, 4000, container, styles, results);
+    }
+    var timer = try std.time.Timer.start();
+    for (0..ITERATIONS) |_| {
+        _ = arena.reset(.retain_capacity);
+        try compute(arena.allocator(), 4000, 4000, container, styles, results);
+        std.mem.doNotOptimizeAway(results.ptr);
+    }
+    const elapsed: f64 = @floatFromInt(timer.read());
+    return elapsed / ITERATIONS;
+}
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    std.debug.print("\n", .{});
+    std.debug.print("╔══════════════════════════════════════════════════════════════════╗\n", .{});
+    std.debug.print("║  zig-gui Flex Specialize Benchmark                              ║\n", .{});
+    std.debug.print("╚══════════════════════════════════════════════════════════════════╝\n", .{});
+    std.debug.print("\n", .{});
+    std.debug.print("- {d} iterations per shape\n", .{ITERATIONS});
+
+    var arena = std.heap.ArenaAllocator.init(allocator);
+    defer arena.deinit();
+
+    for (CHILD_COUNTS) |count| {
+        const styles = try allocator.alloc(FlexStyle, count);
+        defer allocator.free(styles);
+        for (styles, 0..) |*style, i| style.* = childStyle(i);
+        const results = try allocator.alloc(LayoutResult, count);
+        defer allocator.free(results);
+
+        std.debug.print("\n{d} children:\n", .{count});
+        var generic_total: f64 = 0;
+        var specialized_total: f64 = 0;
+        for (DIRECTIONS) |direction| {
+            for (JUSTIFIES) |justify| {
+                for (ALIGNS) |align_items| {
+                    const container = FlexStyle{
+                        .direction = direction,
+                        .justify_content = justify,
+                        .align_items = align_items,
+                        .gap = 2,
+                    };
+                    const generic_ns = try benchLayout(&arena, container, styles, results, false);
+                    const specialized_ns = try benchLayout(&arena, container, styles, results, true);
+                    generic_total += generic_ns;
+                    specialized_total += specialized_ns;
+
+                    std.debug.print("  {s:<6} {s:<13} {s:<10}  generic {d:>8.1} ns   specialized {d:>8.1} ns   {d:>5.2}x\n", .{
+                        @tagName(direction),
+                        @tagName(justify),
+                        @tagName(align_items),
+                        generic_ns,
+                        specialized_ns,
+                        generic_ns / specialized_ns,
+                    });
+                }
+            }
+        }
+        std.debug.print("  all shapes: {d:>5.2}x\n", .{generic_total / specialized_total});
+    }
+    std.debug.print("\n", .{});
+}
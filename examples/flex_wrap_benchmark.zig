@@ -0,0 +1,87 @@
+//! Flex-Wrap Benchmark - 1K children in a wrapping container
+//!
+//! Card grid / tag cloud shape: one row container with flex_wrap = .wrap
+//! holding 1000 children of varying widths. The container width changes
+//! every frame, so line breaking and per-line flex resolution rerun.
+//!
+//! Measures:
+//! - Time per layout pass
+//! - Time per child (budget: ~0.05-0.10μs)
+//!
+//! Build and run:
+//!   zig build flex-wrap-benchmark
+
+const std = @import("std");
+const zig_gui = @import("zig-gui");
+
+const LayoutEngine = zig_gui.layout.LayoutEngine;
+const FlexStyle = zig_gui.layout.FlexStyle;
+
+const CHILD_COUNT = 1000;
+const WARMUP_FRAMES = 100;
+const FRAMES = 5000;
+
+fn containerStyle(width: f32) FlexStyle {
+    return .{
+        .direction = .row,
+        .flex_wrap = .wrap,
+        .align_content = .flex_start,
+        .justify_content = .space_between,
+        .width = width,
+        .height = 4000,
+        .gap = 4,
+    };
+}
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    std.debug.print("\n", .{});
+    std.debug.print("╔══════════════════════════════════════════════════════════════════╗\n", .{});
+    std.debug.print("║  zig-gui Flex-Wrap Benchmark                                    ║\n", .{});
+    std.debug.print("╚══════════════════════════════════════════════════════════════════╝\n", .{});
+    std.debug.print("\n", .{});
+
+    var engine = try LayoutEngine.init(allocator);
+    defer engine.deinit();
+
+    const root = try engine.addElement(null, containerStyle(1200));
+    for (0..CHILD_COUNT) |i| {
+        _ = try engine.addElement(root, .{
+            .width = @floatFromInt(40 + (i * 37) % 120), // 40-159px "tags"
+            .height = 24,
+            .flex_grow = if (i % 3 == 0) 1 else 0,
+        });
+    }
+
+    // Alternate widths so every frame re-breaks the lines
+    const widths = [_]f32{ 1200, 1199 };
+
+    for (0..WARMUP_FRAMES) |frame| {
+        engine.beginFrame();
+        engine.setStyle(root, containerStyle(widths[frame % 2]));
+        try engine.computeLayout(1200, 4000);
+    }
+
+    var timer = try std.time.Timer.start();
+    for (0..FRAMES) |frame| {
+        engine.beginFrame();
+        engine.setStyle(root, containerStyle(widths[frame % 2]));
+        try engine.computeLayout(1200, 4000);
+    }
+    const elapsed_ns: f64 = @floatFromInt(timer.read());
+
+    const per_frame_us = elapsed_ns / FRAMES / 1000.0;
+    const per_child_us = per_frame_us / CHILD_COUNT;
+
+    const last = engine.getRect(CHILD_COUNT);
+    const line_count = @as(u32, @intFromFloat(last.y / 28)) + 1;
+
+    std.debug.print("- {d} children, {d} lines, {d} frames\n", .{ CHILD_COUNT, line_count, FRAMES });
+    std.debug.print("\n", .{});
+    std.debug.print("  Per layout pass: {d:>8.2} us\n", .{per_frame_us});
+    std.debug.print("  Per child:       {d:>8.4} us  (budget 0.05-0.10 us)\n", .{per_child_us});
+    std.debug.print("\n", .{});
+}
@@ -614,13 +614,16 @@ pub fn main() !void {
     // End buildDrawList zone before render
     profiler.endZone();
 
+    draw.finalize();
     const draw_data = DrawData{
         .commands = draw.getCommands(),
+        .batches = draw.getBatches(),
         .display_size = .{ .width = @floatFromInt(width), .height = @floatFromInt(height) },
     };
 
     std.debug.print("\n=== Performance ===\n", .{});
     std.debug.print("Draw commands: {d}\n", .{draw_data.commandCount()});
+    std.debug.print("Draw batches: {d}\n", .{draw_data.batches.len});
     std.debug.print("Display: {d}x{d} ({d} pixels)\n", .{ width, height, width * height });
     std.debug.print("Profiling: {s}\n", .{if (profiler.enabled) "ENABLED" else "disabled"});
 
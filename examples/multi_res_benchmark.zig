@@ -7,10 +7,23 @@
 //!
 //! Each test renders a realistic layout for that use case.
 //!
+//! The same scenes are then recorded as draw commands and rasterized by
+//! zig-gui's SoftwareBackend, serially and tiled on 1, 2, 4, ... N threads
+//! (checked pixel-identical to serial), and translucent full-screen
+//! overlays are timed through draw.fillSpan against per-pixel blending.
+//! Finally a 4K email client whose selection moves every 30 frames is
+//! rasterized in full each frame and in retained mode (damage only).
+//!
 //! Build and run:
 //!   zig build multi-res-benchmark
 
 const std = @import("std");
+const zig_gui = @import("zig-gui");
+
+const DrawList = zig_gui.draw.DrawList;
+const DrawData = zig_gui.draw.DrawData;
+const SoftwareBackend = zig_gui.draw.SoftwareBackend;
+const LayoutPool = zig_gui.layout.LayoutPool;
 
 /// Simple software renderer that actually draws pixels
 const SoftwareRenderer = struct {
@@ -19,6 +32,9 @@ const SoftwareRenderer = struct {
     height: u32,
     allocator: std.mem.Allocator,
 
+    /// When set, scenes are recorded here instead of drawn
+    list: ?*DrawList = null,
+
     pub fn init(allocator: std.mem.Allocator, width: u32, height: u32) !SoftwareRenderer {
         const buffer = try allocator.alloc(u32, width * height);
         @memset(buffer, 0xFF000000); // Black background
@@ -35,10 +51,16 @@ const SoftwareRenderer = struct {
     }
 
     pub fn clear(self: *SoftwareRenderer, color: u32) void {
+        if (self.list != null) return self.fillRect(0, 0, self.width, self.height, color);
         @memset(self.buffer, color);
     }
 
     pub fn fillRect(self: *SoftwareRenderer, x: i32, y: i32, w: u32, h: u32, color: u32) void {
+        if (self.list) |list| {
+            list.addFilledRect(rectOf(x, y, w, h), colorOf(color));
+            return;
+        }
+
         const x_start = @max(0, x);
         const y_start = @max(0, y);
         const x_end = @min(@as(i32, @intCast(self.width)), x + @as(i32, @intCast(w)));
@@ -62,6 +84,15 @@ const SoftwareRenderer = struct {
         for (text, 0..) |c, i| {
             const char_x = x + @as(i32, @intCast(i * (char_width + 2)));
 
+            if (self.list) |list| {
+                // Opaque glyph box with a half-alpha 1px rim
+                const rim = colorOf((color & 0x00FFFFFF) | 0x80000000);
+                list.addFilledRect(rectOf(char_x + 1, y + 1, char_width - 2, char_height - 2), colorOf(color));
+                list.addStrokeRect(rectOf(char_x, y, char_width, char_height), rim, 1);
+                if (c % 2 == 0) self.fillRect(char_x + 1, y + 1, char_width - 2, char_height - 2, 0xFF000000);
+                continue;
+            }
+
             // Draw character with alpha blending
             var cy: i32 = 0;
             while (cy < @as(i32, @intCast(char_height))) : (cy += 1) {
@@ -131,6 +162,19 @@ const SoftwareRenderer = struct {
     }
 };
 
+fn rectOf(x: i32, y: i32, w: u32, h: u32) zig_gui.Rect {
+    return .{ .x = @floatFromInt(x), .y = @floatFromInt(y), .width = @floatFromInt(w), .height = @floatFromInt(h) };
+}
+
+fn colorOf(argb: u32) zig_gui.Color {
+    return zig_gui.Color.fromRGBA(
+        @truncate(argb >> 16),
+        @truncate(argb >> 8),
+        @truncate(argb),
+        @truncate(argb >> 24),
+    );
+}
+
 // =============================================================================
 // Mobile App Layout (iPhone 14: 390x844)
 // =============================================================================
@@ -432,6 +476,212 @@ fn runBenchmark(
     };
 }
 
+// =============================================================================
+// Tiled SoftwareBackend
+// =============================================================================
+
+const RASTER_FRAMES = 100;
+
+/// Mean ms per SoftwareBackend frame over a recorded scene
+fn timeRaster(backend: *SoftwareBackend, data: *const DrawData) !f64 {
+    const iface = backend.interface();
+    for (0..5) |_| {
+        iface.beginFrame(data);
+        iface.render(data);
+        iface.endFrame();
+    }
+    var timer = try std.time.Timer.start();
+    for (0..RASTER_FRAMES) |_| {
+        iface.beginFrame(data);
+        iface.render(data);
+        iface.endFrame();
+        std.mem.doNotOptimizeAway(backend.pixels.ptr);
+    }
+    const elapsed: f64 = @floatFromInt(timer.read());
+    return elapsed / RASTER_FRAMES / 1_000_000.0;
+}
+
+fn runTiledBenchmark(
+    allocator: std.mem.Allocator,
+    name: []const u8,
+    width: u32,
+    height: u32,
+    render_fn: *const fn (*SoftwareRenderer, u32) void,
+) !void {
+    var list = DrawList.init(allocator);
+    defer list.deinit();
+    // Recording never touches the buffer
+    var recorder = SoftwareRenderer{ .buffer = undefined, .width = width, .height = height, .allocator = allocator, .list = &list };
+    render_fn(&recorder, 0);
+
+    const data = DrawData{
+        .commands = list.getCommands(),
+        .display_size = .{ .width = @floatFromInt(width), .height = @floatFromInt(height) },
+    };
+
+    var serial = try SoftwareBackend.initAlloc(allocator, width, height);
+    defer serial.deinit(allocator);
+    const serial_ms = try timeRaster(&serial, &data);
+
+    std.debug.print("\n{s} ({d}x{d}, {d} commands):\n", .{ name, width, height, data.commands.len });
+    std.debug.print("  serial       {d:>8.3} ms/frame\n", .{serial_ms});
+
+    var tiled = try SoftwareBackend.initAlloc(allocator, width, height);
+    defer tiled.deinit(allocator);
+
+    const cpu_count = std.Thread.getCpuCount() catch 1;
+    var threads: usize = 1;
+    while (true) : (threads = @min(threads * 2, cpu_count)) {
+        const pool = try LayoutPool.init(allocator, .{ .thread_count = threads });
+        defer pool.deinit();
+        tiled.enableTiling(allocator, pool, SoftwareBackend.DEFAULT_TILE_SIZE);
+        defer tiled.disableTiling();
+
+        const tiled_ms = try timeRaster(&tiled, &data);
+        if (!std.mem.eql(u32, serial.pixels, tiled.pixels)) {
+            std.debug.print("  {d} threads: pixels differ from serial\n", .{threads});
+            return error.PixelMismatch;
+        }
+        std.debug.print("  {d:>2} threads   {d:>8.3} ms/frame  ({d:.2}x vs serial)\n", .{
+            threads,
+            tiled_ms,
+            serial_ms / tiled_ms,
+        });
+
+        if (threads == cpu_count) break;
+    }
+}
+
+// =============================================================================
+// Retained SoftwareBackend
+// =============================================================================
+
+fn runRetainedBenchmark(
+    allocator: std.mem.Allocator,
+    name: []const u8,
+    width: u32,
+    height: u32,
+    render_fn: *const fn (*SoftwareRenderer, u32) void,
+) !void {
+    const frames = 120;
+
+    var list = DrawList.init(allocator);
+    defer list.deinit();
+    var recorder = SoftwareRenderer{ .buffer = undefined, .width = width, .height = height, .allocator = allocator, .list = &list };
+
+    var full = try SoftwareBackend.initAlloc(allocator, width, height);
+    defer full.deinit(allocator);
+    var retained = try SoftwareBackend.initAlloc(allocator, width, height);
+    defer retained.deinit(allocator);
+    retained.enableRetained(allocator);
+
+    var full_ns: u64 = 0;
+    var retained_ns: u64 = 0;
+    var damaged_pixels: f64 = 0;
+    for (0..frames) |frame| {
+        // Recording is the same for both and not timed
+        list.clear();
+        render_fn(&recorder, @intCast(frame));
+        const data = DrawData{
+            .commands = list.getCommands(),
+            .display_size = .{ .width = @floatFromInt(width), .height = @floatFromInt(height) },
+        };
+
+        var timer = try std.time.Timer.start();
+        full.interface().beginFrame(&data);
+        full.interface().render(&data);
+        full.interface().endFrame();
+        full_ns += timer.lap();
+        retained.interface().beginFrame(&data);
+        retained.interface().render(&data);
+        retained.interface().endFrame();
+        retained_ns += timer.read();
+
+        if (!std.mem.eql(u32, full.pixels, retained.pixels)) {
+            std.debug.print("  frame {d}: retained pixels differ from a full repaint\n", .{frame});
+            return error.PixelMismatch;
+        }
+        if (frame > 0) {
+            for (retained.getDamage()) |rect| damaged_pixels += rect.width * rect.height;
+        }
+    }
+
+    const full_ms = @as(f64, @floatFromInt(full_ns)) / frames / 1_000_000.0;
+    const retained_ms = @as(f64, @floatFromInt(retained_ns)) / frames / 1_000_000.0;
+    const screen: f64 = @floatFromInt(@as(u64, width) * height);
+    std.debug.print("\n{s} ({d}x{d}, {d} frames):\n", .{ name, width, height, frames });
+    std.debug.print("  full repaint     {d:>8.3} ms/frame\n", .{full_ms});
+    std.debug.print("  retained         {d:>8.3} ms/frame  ({d:.1}x, {d:.2}% of pixels repainted per frame)\n", .{
+        retained_ms,
+        full_ms / retained_ms,
+        damaged_pixels / (frames - 1) / screen * 100,
+    });
+}
+
+// =============================================================================
+// Translucent Spans
+// =============================================================================
+
+/// Per-pixel blend with three divides, as SoftwareBackend used to do
+fn blendPixelDiv255(dst: u32, color: u32) u32 {
+    const src_a = color >> 24;
+    const inv_a = 255 - src_a;
+    const out_r = (((color >> 16) & 0xFF) * src_a + ((dst >> 16) & 0xFF) * inv_a) / 255;
+    const out_g = (((color >> 8) & 0xFF) * src_a + ((dst >> 8) & 0xFF) * inv_a) / 255;
+    const out_b = ((color & 0xFF) * src_a + (dst & 0xFF) * inv_a) / 255;
+    return 0xFF000000 | (out_r << 16) | (out_g << 8) | out_b;
+}
+
+fn runBlendBenchmark(allocator: std.mem.Allocator, width: u32, height: u32) !void {
+    const overlays = [_]u32{ 0x88000000, 0xAA336699, 0x20FFFFFF };
+    const frames = 50;
+
+    const reference = try allocator.alloc(u32, width * height);
+    defer allocator.free(reference);
+    const spans = try allocator.alloc(u32, width * height);
+    defer allocator.free(spans);
+    for (reference, 0..) |*pixel, i| pixel.* = 0xFF000000 | @as(u32, @truncate(i *% 2654435761));
+    @memcpy(spans, reference);
+
+    var timer = try std.time.Timer.start();
+    for (0..frames) |_| {
+        for (overlays) |color| {
+            for (reference) |*pixel| pixel.* = blendPixelDiv255(pixel.*, color);
+        }
+        std.mem.doNotOptimizeAway(reference.ptr);
+    }
+    const per_pixel_ms = @as(f64, @floatFromInt(timer.lap())) / frames / 1_000_000.0;
+
+    for (0..frames) |_| {
+        for (overlays) |color| {
+            var row: usize = 0;
+            while (row < height) : (row += 1) zig_gui.draw.fillSpan(spans[row * width ..][0..width], color);
+        }
+        std.mem.doNotOptimizeAway(spans.ptr);
+    }
+    const span_ms = @as(f64, @floatFromInt(timer.read())) / frames / 1_000_000.0;
+
+    // Spans round where the divides truncated, so after repeated blends the
+    // two differ by a few levels per channel
+    var max_diff: u32 = 0;
+    for (reference, spans) |a, b| {
+        inline for (.{ 16, 8, 0 }) |shift| {
+            const ca: i32 = @intCast((a >> shift) & 0xFF);
+            const cb: i32 = @intCast((b >> shift) & 0xFF);
+            max_diff = @max(max_diff, @abs(ca - cb));
+        }
+    }
+
+    std.debug.print("\n{d} translucent overlays at {d}x{d}:\n", .{ overlays.len, width, height });
+    std.debug.print("  per-pixel /255   {d:>8.3} ms/frame\n", .{per_pixel_ms});
+    std.debug.print("  fillSpan         {d:>8.3} ms/frame  ({d:.2}x, {d} lanes, max channel diff {d})\n", .{
+        span_ms,
+        per_pixel_ms / span_ms,
+        zig_gui.draw.SPAN_LANES,
+        max_diff,
+    });
+}
+
 pub fn main() !void {
     var gpa = std.heap.GeneralPurposeAllocator(.{}){};
     defer _ = gpa.deinit();
@@ -529,4 +779,24 @@ pub fn main() !void {
     std.debug.print("  • 8K displays: Viable with GPU acceleration\n", .{});
     std.debug.print("  • Multi-monitor: Architecture proven at scale\n", .{});
     std.debug.print("\n", .{});
+
+    std.debug.print("╔════════════════════════════════════════════════════════════════════╗\n", .{});
+    std.debug.print("║  SoftwareBackend: Serial vs Tiled Rasterization                    ║\n", .{});
+    std.debug.print("╚════════════════════════════════════════════════════════════════════╝\n", .{});
+    try runTiledBenchmark(allocator, "Desktop 1440p", 2560, 1440, renderDesktopEmail);
+    try runTiledBenchmark(allocator, "8K Gaming", 7680, 4320, renderGameHUD);
+    std.debug.print("\n", .{});
+
+    std.debug.print("╔════════════════════════════════════════════════════════════════════╗\n", .{});
+    std.debug.print("║  Translucent Spans: Per-Pixel vs Vector Blend                      ║\n", .{});
+    std.debug.print("╚════════════════════════════════════════════════════════════════════╝\n", .{});
+    try runBlendBenchmark(allocator, 2560, 1440);
+    try runBlendBenchmark(allocator, 7680, 4320);
+    std.debug.print("\n", .{});
+
+    std.debug.print("╔════════════════════════════════════════════════════════════════════╗\n", .{});
+    std.debug.print("║  SoftwareBackend: Full vs Retained (Damage-Only) Repaint           ║\n", .{});
+    std.debug.print("╚════════════════════════════════════════════════════════════════════╝\n", .{});
+    try runRetainedBenchmark(allocator, "4K email client", 3840, 2160, renderDesktopEmail);
+    std.debug.print("\n", .{});
 }
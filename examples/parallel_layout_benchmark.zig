@@ -0,0 +1,143 @@
+//! Parallel Layout Benchmark - scaling of computeLayoutParallel
+//!
+//! Models a wide multi-panel trading UI: rows of fixed-size panels, each
+//! holding a long list of items. Every frame one item in every panel
+//! changes, so every panel is a dirty, independent subtree.
+//!
+//! Measures:
+//! - Serial computeLayout (baseline)
+//! - computeLayoutParallel with 1, 2, 4, ... N threads
+//!
+//! Build and run:
+//!   zig build parallel-layout-benchmark
+
+const std = @import("std");
+const zig_gui = @import("zig-gui");
+
+const LayoutEngine = zig_gui.layout.LayoutEngine;
+const LayoutPool = zig_gui.layout.LayoutPool;
+
+const ROWS = 6;
+const PANELS_PER_ROW = 12;
+const ITEMS_PER_PANEL = 70;
+const PANEL_COUNT = ROWS * PANELS_PER_ROW;
+
+const WARMUP_FRAMES = 20;
+const FRAMES = 500;
+
+const Tree = struct {
+    engine: LayoutEngine,
+    /// First item of every panel (the one edited each frame)
+    edited: [PANEL_COUNT]u32 = undefined,
+
+    fn build(allocator: std.mem.Allocator) !Tree {
+        var tree = Tree{ .engine = try LayoutEngine.init(allocator) };
+        errdefer tree.engine.deinit();
+
+        const engine = &tree.engine;
+        const root = try engine.addElement(null, .{ .direction = .column, .width = 5120, .height = 1440, .gap = 4 });
+
+        var panel_index: usize = 0;
+        for (0..ROWS) |_| {
+            const row = try engine.addElement(root, .{ .direction = .row, .flex_grow = 1, .gap = 4 });
+            for (0..PANELS_PER_ROW) |_| {
+                const panel = try engine.addElement(row, .{
+                    .direction = .column,
+                    .width = 420,
+                    .height = 236,
+                    .padding_top = 4,
+                    .padding_bottom = 4,
+                    .gap = 1,
+                });
+                for (0..ITEMS_PER_PANEL) |i| {
+                    const item = try engine.addElement(panel, .{
+                        .direction = .row,
+                        .height = 3,
+                        .flex_shrink = 1,
+                        .min_height = @floatFromInt(i % 2),
+                    });
+                    if (i == 0) tree.edited[panel_index] = item;
+                }
+                panel_index += 1;
+            }
+        }
+        return tree;
+    }
+
+    fn editPanels(self: *Tree, frame: usize) void {
+        const height: f32 = if (frame % 2 == 0) 4 else 3;
+        for (self.edited) |item| {
+            self.engine.setStyle(item, .{ .direction = .row, .height = height, .flex_shrink = 1 });
+        }
+    }
+};
+
+/// One frame; `pool == null` runs the serial path
+fn runFrame(tree: *Tree, pool: ?*LayoutPool, frame: usize) !void {
+    tree.engine.beginFrame();
+    tree.editPanels(frame);
+    if (pool) |p| {
+        try tree.engine.computeLayoutParallel(p, 5120, 1440);
+    } else {
+        try tree.engine.computeLayout(5120, 1440);
+    }
+}
+
+/// Mean microseconds per frame
+fn measure(allocator: std.mem.Allocator, pool: ?*LayoutPool) !f64 {
+    var tree = try Tree.build(allocator);
+    defer tree.engine.deinit();
+
+    for (0..WARMUP_FRAMES) |frame| {
+        try runFrame(&tree, pool, frame);
+    }
+
+    var timer = try std.time.Timer.start();
+    for (0..FRAMES) |frame| {
+        try runFrame(&tree, pool, frame);
+    }
+    const elapsed_ns = timer.read();
+
+    return @as(f64, @floatFromInt(elapsed_ns)) / FRAMES / 1000.0;
+}
+
+pub fn main() !void {
+    // Worker arenas need a thread-safe allocator
+    var gpa = std.heap.GeneralPurposeAllocator(.{ .thread_safe = true }){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    const cpu_count = std.Thread.getCpuCount() catch 1;
+    const node_count = 1 + ROWS + PANEL_COUNT * (1 + ITEMS_PER_PANEL);
+
+    std.debug.print("\n", .{});
+    std.debug.print("╔══════════════════════════════════════════════════════════════════╗\n", .{});
+    std.debug.print("║  zig-gui Parallel Layout Benchmark                              ║\n", .{});
+    std.debug.print("╚══════════════════════════════════════════════════════════════════╝\n", .{});
+    std.debug.print("\n", .{});
+    std.debug.print("- {d} nodes, {d} fixed-size panels x {d} items\n", .{ node_count, PANEL_COUNT, ITEMS_PER_PANEL });
+    std.debug.print("- Every panel edited every frame ({d} frames)\n", .{FRAMES});
+    std.debug.print("- {d} CPUs available\n", .{cpu_count});
+    std.debug.print("\n", .{});
+
+    const serial_us = try measure(allocator, null);
+    std.debug.print("  {s:<12} {d:>9.1} us/frame\n", .{ "serial", serial_us });
+
+    // 1, 2, 4, ... and always the full CPU count last
+    var threads: usize = 1;
+    while (true) : (threads = @min(threads * 2, cpu_count)) {
+        const pool = try LayoutPool.init(allocator, .{ .thread_count = threads });
+        defer pool.deinit();
+
+        const parallel_us = try measure(allocator, pool);
+        std.debug.print("  {d:>2} threads   {d:>9.1} us/frame  ({d:.2}x vs serial)\n", .{
+            threads,
+            parallel_us,
+            serial_us / parallel_us,
+        });
+
+        if (threads == cpu_count) break;
+    }
+
+    std.debug.print("\n", .{});
+}
@@ -0,0 +1,124 @@
+//! Rounded Rect Benchmark - anti-aliased corners vs square corners
+//!
+//! SoftwareBackend shades only the corner blocks of a rounded rect per
+//! pixel; the rows and columns between them stay memsets/span blends. This
+//! rasterizes the same 1080p UI (panels, cards and a grid of bordered
+//! buttons) with corner radius 0 and with the radii widgets emit, and
+//! reports the cost of the corners.
+//!
+//! Target: within a few percent of square corners.
+//!
+//! Build and run:
+//!   zig build rounded-rect-benchmark
+
+const std = @import("std");
+const zig_gui = @import("zig-gui");
+
+const DrawList = zig_gui.draw.DrawList;
+const DrawData = zig_gui.draw.DrawData;
+const SoftwareBackend = zig_gui.draw.SoftwareBackend;
+const Color = zig_gui.Color;
+
+const WIDTH = 1920;
+const HEIGHT = 1080;
+const WARMUP_FRAMES = 20;
+const FRAMES = 300;
+
+const RADII = [_]f32{ 0, 2, 4, 8 };
+
+/// A settings-style screen: sidebar, header, cards and a button grid
+fn buildUi(list: *DrawList, radius: f32) void {
+    list.clear();
+
+    // Chrome
+    list.addFilledRect(.{ .x = 0, .y = 0, .width = WIDTH, .height = HEIGHT }, Color.fromRGB(30, 30, 36));
+    list.addFilledRectEx(.{ .x = 8, .y = 8, .width = 260, .height = HEIGHT - 16 }, Color.fromRGB(42, 42, 50), radius * 2);
+    list.addFilledRectEx(.{ .x = 280, .y = 8, .width = WIDTH - 288, .height = 56 }, Color.fromRGB(42, 42, 50), radius * 2);
+
+    // Sidebar items
+    for (0..16) |i| {
+        const y: f32 = @floatFromInt(80 + i * 44);
+        const color = if (i == 3) Color.fromRGB(60, 90, 160) else Color.fromRGB(50, 50, 60);
+        list.addFilledRectEx(.{ .x = 16, .y = y, .width = 244, .height = 36 }, color, radius);
+    }
+
+    // Cards with translucent overlays and outlines
+    for (0..4) |i| {
+        const x: f32 = @floatFromInt(280 + i * 410);
+        list.addFilledRectEx(.{ .x = x, .y = 76, .width = 400, .height = 220 }, Color.fromRGB(48, 48, 58), radius * 2);
+        list.addFilledRectEx(.{ .x = x + 12, .y = 88, .width = 376, .height = 40 }, Color.fromRGBA(255, 255, 255, 24), radius);
+        list.addStrokeRectEx(.{ .x = x, .y = 76, .width = 400, .height = 220 }, Color.fromRGB(70, 70, 84), 1, radius * 2);
+    }
+
+    // Button grid: fill plus 1px border, like GUI.button
+    for (0..18) |row| {
+        for (0..20) |col| {
+            const x: f32 = @floatFromInt(280 + col * 82);
+            const y: f32 = @floatFromInt(310 + row * 42);
+            const rect = zig_gui.Rect{ .x = x, .y = y, .width = 76, .height = 34 };
+            const pressed = (row * 20 + col) % 7 == 0;
+            list.addFilledRectEx(rect, if (pressed) Color.fromRGB(80, 80, 130) else Color.fromRGB(50, 50, 80), radius);
+            list.addStrokeRectEx(rect, Color.fromRGBA(255, 255, 255, 60), 1, radius);
+        }
+    }
+}
+
+/// Mean ms per SoftwareBackend frame
+fn timeFrames(backend: *SoftwareBackend, data: *const DrawData) !f64 {
+    const iface = backend.interface();
+    for (0..WARMUP_FRAMES) |_| {
+        iface.beginFrame(data);
+        iface.render(data);
+        iface.endFrame();
+    }
+    var timer = try std.time.Timer.start();
+    for (0..FRAMES) |_| {
+        iface.beginFrame(data);
+        iface.render(data);
+        iface.endFrame();
+        std.mem.doNotOptimizeAway(backend.pixels.ptr);
+    }
+    const elapsed: f64 = @floatFromInt(timer.read());
+    return elapsed / FRAMES / 1_000_000.0;
+}
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    std.debug.print("\n", .{});
+    std.debug.print("╔══════════════════════════════════════════════════════════════════╗\n", .{});
+    std.debug.print("║  zig-gui Rounded Rect Benchmark (SoftwareBackend)               ║\n", .{});
+    std.debug.print("╚══════════════════════════════════════════════════════════════════╝\n", .{});
+    std.debug.print("\n", .{});
+
+    var backend = try SoftwareBackend.initAlloc(allocator, WIDTH, HEIGHT);
+    defer backend.deinit(allocator);
+
+    var list = DrawList.init(allocator);
+    defer list.deinit();
+
+    var square_ms: f64 = 0;
+    for (RADII) |radius| {
+        buildUi(&list, radius);
+        const data = DrawData{
+            .commands = list.getCommands(),
+            .display_size = .{ .width = WIDTH, .height = HEIGHT },
+        };
+        if (radius == 0) std.debug.print("- {d}x{d}, {d} commands, {d} frames\n\n", .{ WIDTH, HEIGHT, data.commands.len, FRAMES });
+
+        const ms = try timeFrames(&backend, &data);
+        if (radius == 0) {
+            square_ms = ms;
+            std.debug.print("  square        {d:>8.3} ms/frame\n", .{ms});
+        } else {
+            std.debug.print("  radius {d:>2}     {d:>8.3} ms/frame  ({d:>5.1}% over square)\n", .{
+                @as(u32, @intFromFloat(radius)),
+                ms,
+                (ms / square_ms - 1) * 100,
+            });
+        }
+    }
+    std.debug.print("\n", .{});
+}
@@ -0,0 +1,137 @@
+//! Scalar Benchmark - flexbox in f32, whole pixels and Q16.16
+//!
+//! The same containers laid out with each layout scalar (see
+//! layout/scalar.zig): a toolbar row, a growing column of panes and a
+//! wrapped icon grid, 16-256 children each. Checks every integer result
+//! against f32 before timing it.
+//!
+//! On a host with an FPU the three are close. The integer scalars pay off
+//! on FPU-less cores, where every f32 operation is a soft-float call; run
+//! the benchmark there under user-mode emulation, e.g.
+//!
+//!   zig build scalar-benchmark -Dtarget=arm-linux-musleabi -Dcpu=arm926ej_s -fqemu
+//!
+//! (ARMv5TE without VFP, soft-float ABI - the closest Linux-hosted stand-in
+//! for a Cortex-M0). Flash cost shows up in the installed binary: the f32
+//! path pulls in __aeabi_fadd/fmul/fdiv/fcmp, the integer paths do not.
+//!
+//! Build and run:
+//!   zig build scalar-benchmark
+
+const std = @import("std");
+const zig_gui = @import("zig-gui");
+
+const scalar = zig_gui.layout.scalar;
+const Flexbox = zig_gui.layout.Flexbox;
+const FlexStyle = zig_gui.layout.FlexStyle;
+
+const CHILD_COUNTS = [_]usize{ 16, 64, 256 };
+const WARMUP_ITERATIONS = 500;
+const ITERATIONS = 5000;
+
+const CONTAINERS = [_]struct { name: []const u8, style: FlexStyle }{
+    .{ .name = "toolbar", .style = .{ .direction = .row, .gap = 4, .padding_left = 8, .align_items = .center } },
+    .{ .name = "panes", .style = .{ .direction = .column, .justify_content = .space_between, .align_items = .stretch } },
+    .{ .name = "grid", .style = .{ .direction = .row, .flex_wrap = .wrap, .gap = 6, .align_content = .flex_start } },
+};
+
+fn childStyle(i: usize) FlexStyle {
+    return .{
+        .width = @floatFromInt(24 + (i * 13) % 40),
+        .height = @floatFromInt(16 + (i * 7) % 24),
+        .flex_grow = @floatFromInt(i % 3),
+        .max_width = if (i % 5 == 0) 48 else std.math.inf(f32),
+    };
+}
+
+/// Mean ns per computeFlexLayout call with scalar S
+fn benchScalar(
+    comptime S: type,
+    arena: *std.heap.ArenaAllocator,
+    container: FlexStyle,
+    float_children: []const FlexStyle,
+    expected: []const zig_gui.layout.LayoutResult,
+) !f64 {
+    const F = Flexbox(S);
+    const allocator = arena.child_allocator;
+
+    const children = try allocator.alloc(F.Style, float_children.len);
+    defer allocator.free(children);
+    for (float_children, children) |child, *out| out.* = F.styleFromFloat(child);
+    const results = try allocator.alloc(F.Result, float_children.len);
+    defer allocator.free(results);
+
+    const style = F.styleFromFloat(container);
+    const width = S.fromInt(800);
+    const height = S.fromInt(600);
+
+    // Same layout as f32, within a pixel per item (whole pixels) or far less
+    try F.computeFlexLayout(arena.allocator(), width, height, style, children, results);
+    const tolerance: f32 = if (S == scalar.Pixels) @floatFromInt(children.len) else 0.01;
+    for (expected, results) |e, r| {
+        if (@abs(e.x - S.toFloat(r.x)) > tolerance or @abs(e.width - S.toFloat(r.width)) > tolerance) {
+            std.debug.print("  {s}: result differs from f32 ({d} vs {d})\n", .{ S.name, e.x, S.toFloat(r.x) });
+            return error.ResultMismatch;
+        }
+    }
+
+    for (0..WARMUP_ITERATIONS) |_| {
+        _ = arena.reset(.retain_capacity);
+        try F.computeFlexLayout(arena.allocator(), width, height, style, children, results);
+    }
+    var timer = try std.time.Timer.start();
+    for (0..ITERATIONS) |_| {
+        _ = arena.reset(.retain_capacity);
+        try F.computeFlexLayout(arena.allocator(), width, height, style, children, results);
+        std.mem.doNotOptimizeAway(results.ptr);
+    }
+    const elapsed: f64 = @floatFromInt(timer.read());
+    return elapsed / ITERATIONS;
+}
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    std.debug.print("\n", .{});
+    std.debug.print("╔══════════════════════════════════════════════════════════════════╗\n", .{});
+    std.debug.print("║  zig-gui Scalar Benchmark (f32 / i32 pixels / Q16.16)           ║\n", .{});
+    std.debug.print("╚══════════════════════════════════════════════════════════════════╝\n", .{});
+    std.debug.print("\n", .{});
+    std.debug.print("- Target: {s}-{s}, {d} iterations\n", .{
+        @tagName(@import("builtin").cpu.arch),
+        @import("builtin").cpu.model.name,
+        ITERATIONS,
+    });
+
+    var arena = std.heap.ArenaAllocator.init(allocator);
+    defer arena.deinit();
+
+    for (CHILD_COUNTS) |count| {
+        const children = try allocator.alloc(FlexStyle, count);
+        defer allocator.free(children);
+        for (children, 0..) |*child, i| child.* = childStyle(i);
+        const expected = try allocator.alloc(zig_gui.layout.LayoutResult, count);
+        defer allocator.free(expected);
+
+        std.debug.print("\n{d} children:\n", .{count});
+        for (CONTAINERS) |container| {
+            try zig_gui.layout.computeFlexLayout(allocator, 800, 600, container.style, children, expected);
+
+            const float_ns = try benchScalar(scalar.Float, &arena, container.style, children, expected);
+            const pixels_ns = try benchScalar(scalar.Pixels, &arena, container.style, children, expected);
+            const fixed_ns = try benchScalar(scalar.Fixed, &arena, container.style, children, expected);
+
+            std.debug.print("  {s:<8} f32 {d:>9.1} ns   i32 {d:>9.1} ns ({d:>4.2}x)   q16.16 {d:>9.1} ns ({d:>4.2}x)\n", .{
+                container.name,
+                float_ns,
+                pixels_ns,
+                float_ns / pixels_ns,
+                fixed_ns,
+                float_ns / fixed_ns,
+            });
+        }
+    }
+    std.debug.print("\n", .{});
+}
@@ -29,13 +29,14 @@ extern "C" {
  * ============================================================================ */
 
 #define ZGL_API_VERSION_MAJOR 1
-#define ZGL_API_VERSION_MINOR 0
+#define ZGL_API_VERSION_MINOR 1
 #define ZGL_API_VERSION ((ZGL_API_VERSION_MAJOR << 16) | ZGL_API_VERSION_MINOR)
 
 /* Runtime version check */
 uint32_t zgl_get_version(void);
 
-/* Get maximum elements (configurable at build time for embedded) */
+/* Capacity of fixed-storage layout engines (build option, for embedded).
+ * Heap-backed engines are sized by zgl_layout_create() instead. */
 uint32_t zgl_max_elements(void);
 
 /* Struct size checks for ABI compatibility */
@@ -67,6 +68,9 @@ typedef struct {
     float height;
 } ZglRect;
 
+/** Most regions a damage query returns: a buffer this size always suffices */
+#define ZGL_MAX_DAMAGE_REGIONS 8
+
 /* ============================================================================
  * Layer 0: Style Constants
  * ============================================================================ */
@@ -89,6 +93,28 @@ typedef struct {
 #define ZGL_ALIGN_END     2  /**< Align to end of cross axis */
 #define ZGL_ALIGN_STRETCH 3  /**< Stretch to fill cross axis */
 
+/* Line wrapping */
+#define ZGL_NOWRAP        0  /**< Single line (default) */
+#define ZGL_WRAP          1  /**< Break into lines, stacked from cross start */
+#define ZGL_WRAP_REVERSE  2  /**< Break into lines, stacked from cross end */
+
+/* Line distribution on the cross axis (wrapped containers) */
+#define ZGL_ALIGN_CONTENT_START         0  /**< Pack lines at start */
+#define ZGL_ALIGN_CONTENT_CENTER        1  /**< Center lines */
+#define ZGL_ALIGN_CONTENT_END           2  /**< Pack lines at end */
+#define ZGL_ALIGN_CONTENT_STRETCH       3  /**< Grow lines to fill (default) */
+#define ZGL_ALIGN_CONTENT_SPACE_BETWEEN 4  /**< Distribute with space between */
+#define ZGL_ALIGN_CONTENT_SPACE_AROUND  5  /**< Distribute with space around */
+
+/* Overflow */
+#define ZGL_OVERFLOW_VISIBLE 0  /**< Content may overflow the box (default) */
+#define ZGL_OVERFLOW_HIDDEN  1  /**< Content is clipped to the box */
+#define ZGL_OVERFLOW_SCROLL  2  /**< Clipped, natural-size content moved by a scroll offset */
+
+/* Positioning scheme */
+#define ZGL_POSITION_RELATIVE 0  /**< In the parent's flex flow (default) */
+#define ZGL_POSITION_ABSOLUTE 1  /**< Out of flow, at the parent's padding box start; move with zgl_layout_set_offset */
+
 /* ============================================================================
  * Layer 0: Style Structure
  * ============================================================================ */
@@ -100,7 +126,7 @@ typedef struct {
 #define ZGL_NONE (1e30f)
 
 /**
- * Style structure (56 bytes, cache-line aligned).
+ * Style structure (60 bytes, cache-line aligned).
  * Plain C struct with no methods. Fully serializable.
  *
  * Note: direction/justify/align use uint8_t for ABI stability (C enums vary in size).
@@ -111,7 +137,7 @@ typedef struct {
     uint8_t direction;       /**< Row (0) or column (1) layout */
     uint8_t justify;         /**< Main-axis alignment (ZGL_JUSTIFY_*) */
     uint8_t align;           /**< Cross-axis alignment (ZGL_ALIGN_*) */
-    uint8_t _reserved;       /**< Padding for alignment */
+    uint8_t wrap;            /**< Line wrapping (ZGL_NOWRAP, ZGL_WRAP, ...) */
 
     /* === Flex item properties (8 bytes) === */
     float flex_grow;         /**< Growth factor (0.0 = don't grow) */
@@ -131,6 +157,12 @@ typedef struct {
     float padding_right;     /**< Right padding */
     float padding_bottom;    /**< Bottom padding */
     float padding_left;      /**< Left padding */
+
+    /* === Multi-line, overflow, positioning (4 bytes) === */
+    uint8_t align_content;   /**< Line distribution (ZGL_ALIGN_CONTENT_*) */
+    uint8_t overflow;        /**< Overflow handling (ZGL_OVERFLOW_*) */
+    uint8_t position;        /**< Positioning scheme (ZGL_POSITION_*) */
+    uint8_t layer;           /**< Draw layers above the parent's (0 = same layer) */
 } ZglStyle;
 
 /** Default style initializer (C99 designated initializers) */
@@ -138,7 +170,7 @@ typedef struct {
     .direction = ZGL_COLUMN, \
     .justify = ZGL_JUSTIFY_START, \
     .align = ZGL_ALIGN_STRETCH, \
-    ._reserved = 0, \
+    .wrap = ZGL_NOWRAP, \
     .flex_grow = 0.0f, \
     .flex_shrink = 1.0f, \
     .width = ZGL_AUTO, \
@@ -152,6 +184,10 @@ typedef struct {
     .padding_right = 0.0f, \
     .padding_bottom = 0.0f, \
     .padding_left = 0.0f, \
+    .align_content = ZGL_ALIGN_CONTENT_STRETCH, \
+    .overflow = ZGL_OVERFLOW_VISIBLE, \
+    .position = ZGL_POSITION_RELATIVE, \
+    .layer = 0, \
 })
 
 /* ============================================================================
@@ -187,7 +223,9 @@ typedef struct ZglLayout ZglLayout;
 
 /**
  * Create a layout engine with given capacity.
- * @param max_nodes Maximum number of nodes (elements) in the tree
+ * @param max_nodes Maximum number of nodes (elements) in the tree.
+ *                  Adding beyond it fails with ZGL_ERROR_CAPACITY_EXCEEDED.
+ *                  Pass 0 for a growable engine (starts small, grows on demand).
  * @return Layout engine handle, or NULL on allocation failure
  */
 ZglLayout* zgl_layout_create(uint32_t max_nodes);
@@ -246,6 +284,19 @@ void zgl_layout_reparent(ZglLayout* layout, ZglNode node, ZglNode new_parent);
  */
 void zgl_layout_compute(ZglLayout* layout, float available_width, float available_height);
 
+/**
+ * Collect the regions whose layout changed since the previous call, then
+ * start a new list. Each changed node contributes its old and new rect;
+ * touching rects are merged into at most ZGL_MAX_DAMAGE_REGIONS boxes.
+ * Call after zgl_layout_compute and offset/scroll changes; repaint only
+ * these regions.
+ * @param layout Layout engine
+ * @param out Receives up to capacity rects in root coordinates (may be NULL)
+ * @param capacity Size of out
+ * @return Number of regions (at most ZGL_MAX_DAMAGE_REGIONS)
+ */
+uint32_t zgl_layout_take_damage(ZglLayout* layout, ZglRect* out, uint32_t capacity);
+
 /* --- Queries --- */
 
 /**
@@ -256,6 +307,45 @@ void zgl_layout_compute(ZglLayout* layout, float available_width, float availabl
  */
 ZglRect zgl_layout_get_rect(const ZglLayout* layout, ZglNode node);
 
+/**
+ * Get rectangle of a node in root coordinates.
+ * Includes the offsets of the node and its ancestors. Positions moved only
+ * by offsets are refreshed here, without a layout pass.
+ * @param layout Layout engine
+ * @param node Node to query
+ * @return Absolute rectangle (zero rect if node invalid)
+ */
+ZglRect zgl_layout_get_absolute_rect(ZglLayout* layout, ZglNode node);
+
+/**
+ * Translate a node and its subtree without re-running layout.
+ * Use for dragged panels and scrolled content.
+ * @param layout Layout engine
+ * @param node Node to move
+ * @param x Horizontal offset from the node's layout position
+ * @param y Vertical offset from the node's layout position
+ */
+void zgl_layout_set_offset(ZglLayout* layout, ZglNode node, float x, float y);
+
+/**
+ * Scroll the content of a ZGL_OVERFLOW_SCROLL node without re-running layout.
+ * Clamped to 0 .. content size - node size from the last layout.
+ * @param layout Layout engine
+ * @param node Scroll container
+ * @param x Horizontal content position shown at the node's left edge
+ * @param y Vertical content position shown at the node's top edge
+ */
+void zgl_layout_set_scroll_offset(ZglLayout* layout, ZglNode node, float x, float y);
+
+/**
+ * Get scroll state of a node.
+ * @param layout Layout engine
+ * @param node Node to query
+ * @return x/y = current scroll offset, width/height = content size
+ *         (zero rect if node invalid)
+ */
+ZglRect zgl_layout_get_scroll(const ZglLayout* layout, ZglNode node);
+
 /**
  * Get parent of a node.
  * @param layout Layout engine
@@ -455,6 +545,8 @@ ZglRect zgl_gui_get_rect(const ZglGui* gui, ZglId id);
 
 /**
  * Check if point is inside widget.
+ * Uses the visible (clipped) bounds from the last frame; widgets drawn
+ * over this one do not count (see zgl_gui_pick).
  * @param gui GUI context
  * @param id Widget ID
  * @param x X coordinate
@@ -463,6 +555,38 @@ ZglRect zgl_gui_get_rect(const ZglGui* gui, ZglId id);
  */
 bool zgl_gui_hit_test(const ZglGui* gui, ZglId id, float x, float y);
 
+/**
+ * Find the topmost widget at a point.
+ * Answered from a spatial index (one grid cell), not a scan of all widgets.
+ * Respects layers, clips and draw order.
+ * @param gui GUI context
+ * @param x X coordinate
+ * @param y Y coordinate
+ * @return Full (scoped) widget ID, or 0 if nothing is there
+ */
+ZglId zgl_gui_pick(const ZglGui* gui, float x, float y);
+
+/**
+ * Collect widgets whose visible bounds overlap a rectangle (unordered).
+ * @param gui GUI context
+ * @param rect Area to query
+ * @param out Receives up to capacity IDs (may be NULL)
+ * @param capacity Size of out
+ * @return Total number of overlapping widgets (may exceed capacity)
+ */
+uint32_t zgl_gui_query_rect(const ZglGui* gui, ZglRect rect, ZglId* out, uint32_t capacity);
+
+/**
+ * Regions whose layout changed during the last frame (see
+ * zgl_layout_take_damage). Valid until the next zgl_gui_begin_frame.
+ * Covers layout geometry only, not color or text changes.
+ * @param gui GUI context
+ * @param out Receives up to capacity rects (may be NULL)
+ * @param capacity Size of out
+ * @return Number of regions (at most ZGL_MAX_DAMAGE_REGIONS)
+ */
+uint32_t zgl_gui_get_damage(const ZglGui* gui, ZglRect* out, uint32_t capacity);
+
 /* --- Input State --- */
 
 /**
@@ -8,6 +8,7 @@ const layout_engine = @import("layout/engine.zig");
 const flexbox = @import("layout/flexbox.zig");
 const gui_mod = @import("gui.zig");
 const widget_id = @import("widget_id.zig");
+const geometry = @import("core/geometry.zig");
 
 // =============================================================================
 // Type Aliases (matching zgl.h)
@@ -18,6 +19,9 @@ pub const ZglId = u32;
 
 pub const ZGL_NULL: ZglNode = 0xFFFFFFFF;
 
+/// Most rects a damage query returns (ZGL_MAX_DAMAGE_REGIONS in zgl.h)
+pub const ZGL_MAX_DAMAGE_REGIONS: u32 = layout_engine.MAX_DAMAGE_REGIONS;
+
 pub const ZglRect = extern struct {
     x: f32,
     y: f32,
@@ -54,13 +58,13 @@ pub const ZglError = enum(c_int) {
     cycle_detected = 4,
 };
 
-/// C-compatible style structure (56 bytes, matches zgl.h)
+/// C-compatible style structure (60 bytes, matches zgl.h)
 pub const ZglStyle = extern struct {
     // Flexbox properties (4 bytes total - use u8 to match C enum sizes)
     direction: u8 = 1, // ZGL_COLUMN = 1
     justify: u8 = 0, // ZGL_JUSTIFY_START = 0
     align_: u8 = 3, // ZGL_ALIGN_STRETCH = 3
-    _reserved: u8 = 0,
+    wrap: u8 = 0, // ZGL_NOWRAP = 0
 
     // Flex item properties (8 bytes)
     flex_grow: f32 = 0.0,
@@ -81,8 +85,14 @@ pub const ZglStyle = extern struct {
     padding_bottom: f32 = 0.0,
     padding_left: f32 = 0.0,
 
+    // Multi-line, overflow, positioning (4 bytes)
+    align_content: u8 = 3, // ZGL_ALIGN_CONTENT_STRETCH = 3
+    overflow: u8 = 0, // ZGL_OVERFLOW_VISIBLE = 0
+    position: u8 = 0, // ZGL_POSITION_RELATIVE = 0
+    layer: u8 = 0,
+
     comptime {
-        if (@sizeOf(ZglStyle) != 56) {
+        if (@sizeOf(ZglStyle) != 60) {
             @compileError("ZglStyle size mismatch with C header");
         }
     }
@@ -105,7 +115,7 @@ threadlocal var last_error: ZglError = .ok;
 // =============================================================================
 
 pub export fn zgl_get_version() u32 {
-    return (1 << 16) | 0; // Version 1.0
+    return (1 << 16) | 1; // Version 1.1
 }
 
 pub export fn zgl_max_elements() u32 {
@@ -162,15 +172,19 @@ pub const ZglLayout = opaque {
 // =============================================================================
 
 pub export fn zgl_layout_create(max_nodes: u32) ?*ZglLayout {
-    _ = max_nodes; // TODO: Use for configurable capacity
-
     // Use C allocator for C API (no Zig allocator management needed)
     const engine = std.heap.c_allocator.create(layout_engine.LayoutEngine) catch {
         last_error = .out_of_memory;
         return null;
     };
 
-    engine.* = layout_engine.LayoutEngine.init(std.heap.c_allocator) catch {
+    // 0 = start small and grow on demand; otherwise a hard cap of max_nodes
+    const options: layout_engine.LayoutEngine.Options = if (max_nodes == 0)
+        .{}
+    else
+        .{ .initial_capacity = max_nodes, .growable = false };
+
+    engine.* = layout_engine.LayoutEngine.initOptions(std.heap.c_allocator, options) catch {
         std.heap.c_allocator.destroy(engine);
         last_error = .out_of_memory;
         return null;
@@ -202,8 +216,11 @@ pub export fn zgl_layout_add(
 
     const parent_opt: ?u32 = if (parent == ZGL_NULL) null else parent;
 
-    const index = engine.addElement(parent_opt, flex_style) catch {
-        last_error = .capacity_exceeded;
+    const index = engine.addElement(parent_opt, flex_style) catch |err| {
+        last_error = switch (err) {
+            error.OutOfMemory => .out_of_memory,
+            else => .capacity_exceeded,
+        };
         return ZGL_NULL;
     };
 
@@ -256,6 +273,24 @@ pub export fn zgl_layout_compute(
     engine.computeLayout(available_width, available_height) catch {};
 }
 
+pub export fn zgl_layout_take_damage(layout_opt: ?*ZglLayout, out: ?[*]ZglRect, capacity: u32) u32 {
+    const layout = layout_opt orelse return 0;
+    const engine = layout.toPtr();
+
+    const regions = engine.collectDamage();
+    const count: u32 = @intCast(regions.len);
+    if (out) |rects| copyDamage(rects[0..@min(count, capacity)], regions);
+    engine.clearMoved();
+    engine.clearDamage();
+    return count;
+}
+
+fn copyDamage(out: []ZglRect, regions: []const geometry.Rect) void {
+    for (out, regions[0..out.len]) |*rect, region| {
+        rect.* = .{ .x = region.x, .y = region.y, .width = region.width, .height = region.height };
+    }
+}
+
 pub export fn zgl_layout_get_rect(layout_opt: ?*const ZglLayout, node: ZglNode) ZglRect {
     const layout = layout_opt orelse return ZglRect{ .x = 0, .y = 0, .width = 0, .height = 0 };
     const engine = layout.toPtrConst();
@@ -273,6 +308,59 @@ pub export fn zgl_layout_get_rect(layout_opt: ?*const ZglLayout, node: ZglNode)
     };
 }
 
+pub export fn zgl_layout_get_absolute_rect(layout_opt: ?*ZglLayout, node: ZglNode) ZglRect {
+    const layout = layout_opt orelse return ZglRect{ .x = 0, .y = 0, .width = 0, .height = 0 };
+    const engine = layout.toPtr();
+
+    if (node >= engine.element_count) {
+        return ZglRect{ .x = 0, .y = 0, .width = 0, .height = 0 };
+    }
+
+    const rect = engine.getAbsoluteRect(node);
+    return ZglRect{
+        .x = rect.x,
+        .y = rect.y,
+        .width = rect.width,
+        .height = rect.height,
+    };
+}
+
+pub export fn zgl_layout_set_offset(layout_opt: ?*ZglLayout, node: ZglNode, x: f32, y: f32) void {
+    const layout = layout_opt orelse return;
+    const engine = layout.toPtr();
+
+    if (node >= engine.element_count) return;
+
+    engine.setOffset(node, x, y);
+}
+
+pub export fn zgl_layout_set_scroll_offset(layout_opt: ?*ZglLayout, node: ZglNode, x: f32, y: f32) void {
+    const layout = layout_opt orelse return;
+    const engine = layout.toPtr();
+
+    if (node >= engine.element_count) return;
+
+    engine.setScrollOffset(node, x, y);
+}
+
+pub export fn zgl_layout_get_scroll(layout_opt: ?*const ZglLayout, node: ZglNode) ZglRect {
+    const layout = layout_opt orelse return ZglRect{ .x = 0, .y = 0, .width = 0, .height = 0 };
+    const engine = layout.toPtrConst();
+
+    if (node >= engine.element_count) {
+        return ZglRect{ .x = 0, .y = 0, .width = 0, .height = 0 };
+    }
+
+    const scroll = engine.getScrollOffset(node);
+    const content = engine.getContentSize(node);
+    return ZglRect{
+        .x = scroll.x,
+        .y = scroll.y,
+        .width = content.width,
+        .height = content.height,
+    };
+}
+
 pub export fn zgl_layout_get_parent(layout_opt: ?*const ZglLayout, node: ZglNode) ZglNode {
     const layout = layout_opt orelse return ZGL_NULL;
     const engine = layout.toPtrConst();
@@ -443,11 +531,43 @@ pub export fn zgl_gui_get_rect(gui_opt: ?*const ZglGui, id: ZglId) ZglRect {
 }
 
 pub export fn zgl_gui_hit_test(gui_opt: ?*const ZglGui, id: ZglId, x: f32, y: f32) bool {
-    _ = gui_opt;
-    _ = id;
-    _ = x;
-    _ = y;
-    return false;
+    const gui = gui_opt orelse return false;
+    const gui_ptr = gui.toPtrConst();
+    return gui_ptr.hitTestWidget(gui_ptr.id_stack.combine(id), x, y);
+}
+
+pub export fn zgl_gui_pick(gui_opt: ?*const ZglGui, x: f32, y: f32) ZglId {
+    const gui = gui_opt orelse return 0;
+    const gui_ptr = gui.toPtrConst();
+    return gui_ptr.widgetAt(x, y) orelse 0;
+}
+
+pub export fn zgl_gui_query_rect(gui_opt: ?*const ZglGui, rect: ZglRect, out: ?[*]ZglId, capacity: u32) u32 {
+    const gui = gui_opt orelse return 0;
+    const gui_ptr = gui.toPtrConst();
+
+    var found = std.ArrayList(u32).init(gui_ptr.allocator);
+    defer found.deinit();
+    gui_ptr.widgetsInRect(.{ .x = rect.x, .y = rect.y, .width = rect.width, .height = rect.height }, &found) catch {
+        last_error = .out_of_memory;
+        return 0;
+    };
+
+    if (out) |ids| {
+        const copied = @min(found.items.len, capacity);
+        @memcpy(ids[0..copied], found.items[0..copied]);
+    }
+    return @intCast(found.items.len);
+}
+
+pub export fn zgl_gui_get_damage(gui_opt: ?*const ZglGui, out: ?[*]ZglRect, capacity: u32) u32 {
+    const gui = gui_opt orelse return 0;
+    const gui_ptr = gui.toPtrConst();
+
+    const regions = gui_ptr.layout_engine.getDamage();
+    const count: u32 = @intCast(regions.len);
+    if (out) |rects| copyDamage(rects[0..@min(count, capacity)], regions);
+    return count;
 }
 
 // --- Input State ---
@@ -494,6 +614,11 @@ fn convertStyle(style: *const ZglStyle) flexbox.FlexStyle {
         .direction = @enumFromInt(style.direction),
         .justify_content = @enumFromInt(style.justify),
         .align_items = @enumFromInt(style.align_),
+        .flex_wrap = @enumFromInt(style.wrap),
+        .align_content = @enumFromInt(style.align_content),
+        .overflow = @enumFromInt(style.overflow),
+        .position = @enumFromInt(style.position),
+        .layer = style.layer,
         .flex_grow = style.flex_grow,
         .flex_shrink = style.flex_shrink,
         .width = style.width,
@@ -516,8 +641,9 @@ fn convertStyle(style: *const ZglStyle) flexbox.FlexStyle {
 
 comptime {
     // Verify struct sizes match C header expectations
-    if (@sizeOf(ZglStyle) != 56) @compileError("ZglStyle ABI break: expected 56 bytes");
+    if (@sizeOf(ZglStyle) != 60) @compileError("ZglStyle ABI break: expected 60 bytes");
     if (@sizeOf(ZglRect) != 16) @compileError("ZglRect ABI break: expected 16 bytes");
+    if (ZGL_MAX_DAMAGE_REGIONS != 8) @compileError("ZGL_MAX_DAMAGE_REGIONS out of sync with zgl.h");
 }
 
 // =============================================================================
@@ -525,7 +651,7 @@ comptime {
 // =============================================================================
 
 test "C API struct sizes" {
-    try std.testing.expectEqual(@as(usize, 56), @sizeOf(ZglStyle));
+    try std.testing.expectEqual(@as(usize, 60), @sizeOf(ZglStyle));
     try std.testing.expectEqual(@as(usize, 16), @sizeOf(ZglRect));
 }
 
@@ -554,6 +680,29 @@ test "C API add nodes" {
     try std.testing.expectEqual(@as(u32, 2), zgl_layout_node_count(layout));
 }
 
+test "C API layout capacity" {
+    const layout = zgl_layout_create(4).?;
+    defer zgl_layout_destroy(layout);
+
+    const root = zgl_layout_add(layout, ZGL_NULL, null);
+    for (0..3) |_| {
+        try std.testing.expect(zgl_layout_add(layout, root, null) != ZGL_NULL);
+    }
+
+    try std.testing.expectEqual(ZGL_NULL, zgl_layout_add(layout, root, null));
+    try std.testing.expectEqual(ZglError.capacity_exceeded, zgl_get_last_error());
+
+    // 0 = growable
+    const growable = zgl_layout_create(0).?;
+    defer zgl_layout_destroy(growable);
+
+    const groot = zgl_layout_add(growable, ZGL_NULL, null);
+    for (0..200) |_| {
+        try std.testing.expect(zgl_layout_add(growable, groot, null) != ZGL_NULL);
+    }
+    try std.testing.expectEqual(@as(u32, 201), zgl_layout_node_count(growable));
+}
+
 test "C API compute layout" {
     const layout = zgl_layout_create(100).?;
     defer zgl_layout_destroy(layout);
@@ -571,6 +720,76 @@ test "C API compute layout" {
     try std.testing.expectEqual(@as(f32, 50), rect.height);
 }
 
+test "C API offsets move nodes without relayout" {
+    const layout = zgl_layout_create(100).?;
+    defer zgl_layout_destroy(layout);
+
+    var style = ZglStyle{};
+    style.width = 100;
+    style.height = 50;
+
+    const root = zgl_layout_add(layout, ZGL_NULL, &style);
+    const child = zgl_layout_add(layout, root, &style);
+    zgl_layout_compute(layout, 800, 600);
+
+    zgl_layout_set_offset(layout, root, 10, 20);
+    try std.testing.expectEqual(@as(u32, 0), zgl_layout_dirty_count(layout));
+
+    const rect = zgl_layout_get_absolute_rect(layout, child);
+    try std.testing.expectEqual(@as(f32, 10), rect.x);
+    try std.testing.expectEqual(@as(f32, 20), rect.y);
+    try std.testing.expectEqual(@as(f32, 0), zgl_layout_get_rect(layout, child).x);
+}
+
+test "C API damage reports where a node was and where it went" {
+    const layout = zgl_layout_create(100).?;
+    defer zgl_layout_destroy(layout);
+
+    var style = ZglStyle{};
+    style.width = 100;
+    style.height = 50;
+
+    const root = zgl_layout_add(layout, ZGL_NULL, &style);
+    const child = zgl_layout_add(layout, root, &style);
+    zgl_layout_compute(layout, 800, 600);
+
+    var rects: [ZGL_MAX_DAMAGE_REGIONS]ZglRect = undefined;
+    try std.testing.expectEqual(@as(u32, 1), zgl_layout_take_damage(layout, &rects, rects.len));
+    try std.testing.expectEqual(@as(f32, 100), rects[0].width);
+    try std.testing.expectEqual(@as(u32, 0), zgl_layout_take_damage(layout, &rects, rects.len));
+
+    // Dragged clear of its old spot: two separate regions
+    zgl_layout_set_offset(layout, child, 200, 0);
+    try std.testing.expectEqual(@as(u32, 2), zgl_layout_take_damage(layout, &rects, rects.len));
+    try std.testing.expectEqual(@as(f32, 200), @max(rects[0].x, rects[1].x));
+    try std.testing.expectEqual(@as(f32, 0), @min(rects[0].x, rects[1].x));
+}
+
+test "C API scroll containers clamp to content" {
+    const layout = zgl_layout_create(100).?;
+    defer zgl_layout_destroy(layout);
+
+    var pane_style = ZglStyle{};
+    pane_style.width = 100;
+    pane_style.height = 50;
+    pane_style.overflow = 2; // ZGL_OVERFLOW_SCROLL
+    var line_style = ZglStyle{};
+    line_style.height = 40;
+
+    const pane = zgl_layout_add(layout, ZGL_NULL, &pane_style);
+    const first = zgl_layout_add(layout, pane, &line_style);
+    _ = zgl_layout_add(layout, pane, &line_style);
+    zgl_layout_compute(layout, 800, 600);
+
+    zgl_layout_set_scroll_offset(layout, pane, 0, 100);
+    try std.testing.expectEqual(@as(u32, 0), zgl_layout_dirty_count(layout));
+
+    const scroll = zgl_layout_get_scroll(layout, pane);
+    try std.testing.expectEqual(@as(f32, 30), scroll.y);
+    try std.testing.expectEqual(@as(f32, 80), scroll.height);
+    try std.testing.expectEqual(@as(f32, -30), zgl_layout_get_absolute_rect(layout, first).y);
+}
+
 test "C API widget ID" {
     const id1 = zgl_id("button");
     const id2 = zgl_id("button");
@@ -584,6 +803,33 @@ test "C API widget ID" {
     try std.testing.expect(indexed1 != indexed2);
 }
 
+test "C API picks the topmost widget" {
+    const gui = zgl_gui_create(null);
+    try std.testing.expect(gui != null);
+    defer zgl_gui_destroy(gui);
+
+    const ok = zgl_id("OK");
+    const cancel = zgl_id("Cancel");
+    const gui_ptr = gui.?.toPtr();
+    zgl_gui_begin_frame(gui);
+    gui_ptr.buttonById(ok, "OK");
+    // Overlap the second button with the first: declared later, drawn on top
+    gui_ptr.im_cursor_x = gui_ptr.im_padding;
+    gui_ptr.buttonById(cancel, "Cancel");
+    zgl_gui_end_frame(gui);
+
+    try std.testing.expectEqual(cancel, zgl_gui_pick(gui, 12, 12));
+    try std.testing.expect(zgl_gui_hit_test(gui, ok, 12, 12));
+    try std.testing.expect(!zgl_gui_hit_test(gui, ok, 500, 500));
+    try std.testing.expectEqual(@as(ZglId, 0), zgl_gui_pick(gui, 500, 500));
+
+    var ids: [1]ZglId = undefined;
+    const area = ZglRect{ .x = 0, .y = 0, .width = 20, .height = 20 };
+    try std.testing.expectEqual(@as(u32, 2), zgl_gui_query_rect(gui, area, &ids, ids.len));
+    try std.testing.expect(ids[0] == ok or ids[0] == cancel);
+    try std.testing.expectEqual(@as(u32, 2), zgl_gui_query_rect(gui, area, null, 0));
+}
+
 test "C API GUI lifecycle" {
     const gui = zgl_gui_create(null);
     try std.testing.expect(gui != null);
@@ -0,0 +1,325 @@
+//! Work-Stealing Thread Pool
+//!
+//! Runs a batch of independent tasks across a fixed set of threads. A task is
+//! an item index plus a payload word; what they mean belongs to the run
+//! function. LayoutEngine.computeLayoutParallel hands it fixed-size subtrees
+//! (the payload carries the size the parent gave them), and the software
+//! renderer's tiled path hands it tile numbers.
+//!
+//! Scheduling:
+//!   - Each worker owns a deque of tasks and a scratch arena
+//!   - Owners pop LIFO (depth-first, cache-warm)
+//!   - Idle workers steal FIFO from others (oldest = usually largest)
+//!   - Work found while running a task (e.g. a nested subtree) is spawned
+//!     onto the running worker's own deque
+//!
+//! Deques are mutex-protected rather than lock-free: a task is a sizeable
+//! chunk of work (a whole subtree, a whole tile), so locking is per task.
+//!
+//! The calling thread participates as worker 0; the other threads sleep
+//! between runs.
+
+const std = @import("std");
+
+/// One unit of work: which item, plus a word of caller-defined data
+pub const Task = struct {
+    index: u32,
+    payload: u64 = 0,
+};
+
+/// Per-thread worker state
+pub const Worker = struct {
+    pool: *Pool,
+    id: usize,
+
+    /// Scratch memory for this worker (reset at the start of every run)
+    arena: std.heap.ArenaAllocator,
+
+    /// A task failed (e.g. out of scratch memory); reset at the start of every run
+    failed: bool = false,
+
+    // Deque: owner pops from the end, thieves take from steal_head
+    mutex: std.Thread.Mutex = .{},
+    tasks: std.ArrayListUnmanaged(Task) = .{},
+    steal_head: usize = 0,
+
+    /// Queue work discovered while running a task
+    pub fn spawn(self: *Worker, task: Task) !void {
+        // Count before publishing so the pool can't see pending == 0 early
+        _ = self.pool.pending.fetchAdd(1, .acq_rel);
+
+        self.mutex.lock();
+        defer self.mutex.unlock();
+        self.tasks.append(self.pool.allocator, task) catch |err| {
+            _ = self.pool.pending.fetchSub(1, .acq_rel);
+            return err;
+        };
+    }
+
+    fn pop(self: *Worker) ?Task {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        if (self.tasks.items.len == self.steal_head) return null;
+        const task = self.tasks.pop();
+        self.compact();
+        return task;
+    }
+
+    fn steal(self: *Worker) ?Task {
+        self.mutex.lock();
+        defer self.mutex.unlock();
+
+        if (self.tasks.items.len == self.steal_head) return null;
+        const task = self.tasks.items[self.steal_head];
+        self.steal_head += 1;
+        self.compact();
+        return task;
+    }
+
+    fn compact(self: *Worker) void {
+        if (self.tasks.items.len == self.steal_head) {
+            self.tasks.clearRetainingCapacity();
+            self.steal_head = 0;
+        }
+    }
+};
+
+/// Pool of workers
+pub const Pool = struct {
+    allocator: std.mem.Allocator,
+    workers: []Worker,
+    threads: []std.Thread,
+
+    // Wake-up of sleeping threads
+    mutex: std.Thread.Mutex = .{},
+    wake: std.Thread.Condition = .{},
+    generation: u64 = 0,
+    shutdown: bool = false,
+    job: Job = undefined,
+
+    /// Tasks queued or running in the current run
+    pending: std.atomic.Value(usize) = std.atomic.Value(usize).init(0),
+    /// Threads still draining in the current run
+    active: std.atomic.Value(usize) = std.atomic.Value(usize).init(0),
+    done: std.Thread.ResetEvent = .{},
+
+    pub const RunFn = *const fn (context: *anyopaque, worker: *Worker, task: Task) void;
+
+    const Job = struct {
+        context: *anyopaque,
+        run_fn: RunFn,
+    };
+
+    pub const Options = struct {
+        /// Total workers including the calling thread (0 = CPU count)
+        thread_count: usize = 0,
+    };
+
+    /// Create a pool. `allocator` backs worker arenas and deques and must be
+    /// thread-safe.
+    pub fn init(allocator: std.mem.Allocator, options: Options) !*Pool {
+        const count = if (options.thread_count == 0)
+            std.Thread.getCpuCount() catch 1
+        else
+            options.thread_count;
+
+        const pool = try allocator.create(Pool);
+        errdefer allocator.destroy(pool);
+
+        const workers = try allocator.alloc(Worker, count);
+        errdefer allocator.free(workers);
+
+        const threads = try allocator.alloc(std.Thread, count - 1);
+        errdefer allocator.free(threads);
+
+        pool.* = .{
+            .allocator = allocator,
+            .workers = workers,
+            .threads = threads,
+        };
+        for (workers, 0..) |*worker, i| {
+            worker.* = .{
+                .pool = pool,
+                .id = i,
+                .arena = std.heap.ArenaAllocator.init(allocator),
+            };
+        }
+
+        var spawned: usize = 0;
+        errdefer pool.stopThreads(spawned);
+        for (threads, 1..) |*thread, i| {
+            thread.* = try std.Thread.spawn(.{}, workerMain, .{ pool, &workers[i] });
+            spawned += 1;
+        }
+
+        return pool;
+    }
+
+    pub fn deinit(self: *Pool) void {
+        self.stopThreads(self.threads.len);
+
+        for (self.workers) |*worker| {
+            worker.arena.deinit();
+            worker.tasks.deinit(self.allocator);
+        }
+
+        const allocator = self.allocator;
+        allocator.free(self.threads);
+        allocator.free(self.workers);
+        allocator.destroy(self);
+    }
+
+    /// Total workers including the calling thread
+    pub fn getThreadCount(self: *const Pool) usize {
+        return self.workers.len;
+    }
+
+    /// Run `run_fn` for every task (and every task they spawn), returning
+    /// once all have finished. The calling thread works too.
+    pub fn run(self: *Pool, context: *anyopaque, run_fn: RunFn, tasks: []const Task) !void {
+        if (tasks.len == 0) return;
+
+        for (self.workers) |*worker| {
+            _ = worker.arena.reset(.retain_capacity);
+            worker.failed = false;
+            worker.tasks.clearRetainingCapacity();
+            worker.steal_head = 0;
+        }
+
+        // Deal initial tasks round-robin
+        for (tasks, 0..) |task, i| {
+            try self.workers[i % self.workers.len].tasks.append(self.allocator, task);
+        }
+        self.pending.store(tasks.len, .release);
+
+        const job = Job{ .context = context, .run_fn = run_fn };
+
+        if (self.threads.len > 0) {
+            self.done.reset();
+            self.active.store(self.threads.len, .release);
+
+            self.mutex.lock();
+            self.job = job;
+            self.generation += 1;
+            self.mutex.unlock();
+            self.wake.broadcast();
+        }
+
+        self.drain(&self.workers[0], job);
+
+        if (self.threads.len > 0) {
+            self.done.wait();
+        }
+    }
+
+    fn drain(self: *Pool, worker: *Worker, job: Job) void {
+        while (self.pending.load(.acquire) > 0) {
+            const task = worker.pop() orelse self.stealFor(worker) orelse {
+                // Others are still running tasks that may spawn more
+                std.atomic.spinLoopHint();
+                continue;
+            };
+            job.run_fn(job.context, worker, task);
+            _ = self.pending.fetchSub(1, .acq_rel);
+        }
+    }
+
+    fn stealFor(self: *Pool, thief: *Worker) ?Task {
+        const count = self.workers.len;
+        var offset: usize = 1;
+        while (offset < count) : (offset += 1) {
+            const victim = &self.workers[(thief.id + offset) % count];
+            if (victim.steal()) |task| return task;
+        }
+        return null;
+    }
+
+    fn workerMain(self: *Pool, worker: *Worker) void {
+        var seen_generation: u64 = 0;
+        while (true) {
+            self.mutex.lock();
+            while (self.generation == seen_generation and !self.shutdown) {
+                self.wake.wait(&self.mutex);
+            }
+            if (self.shutdown) {
+                self.mutex.unlock();
+                return;
+            }
+            seen_generation = self.generation;
+            const job = self.job;
+            self.mutex.unlock();
+
+            self.drain(worker, job);
+
+            if (self.active.fetchSub(1, .acq_rel) == 1) {
+                self.done.set();
+            }
+        }
+    }
+
+    fn stopThreads(self: *Pool, count: usize) void {
+        self.mutex.lock();
+        self.shutdown = true;
+        self.mutex.unlock();
+        self.wake.broadcast();
+
+        for (self.threads[0..count]) |thread| {
+            thread.join();
+        }
+    }
+};
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+const TestContext = struct {
+    visited: [64]std.atomic.Value(u32) = [_]std.atomic.Value(u32){std.atomic.Value(u32).init(0)} ** 64,
+
+    fn run(context: *anyopaque, worker: *Worker, task: Task) void {
+        const self: *TestContext = @ptrCast(@alignCast(context));
+        _ = self.visited[task.index].fetchAdd(1, .monotonic);
+
+        // Each task below 32 spawns one nested task
+        if (task.index < 32) {
+            worker.spawn(.{ .index = task.index + 32 }) catch {
+                worker.failed = true;
+            };
+        }
+    }
+};
+
+test "Pool: runs every task and spawned task exactly once" {
+    const pool = try Pool.init(std.testing.allocator, .{ .thread_count = 4 });
+    defer pool.deinit();
+
+    var tasks: [32]Task = undefined;
+    for (&tasks, 0..) |*task, i| {
+        task.* = .{ .index = @intCast(i) };
+    }
+
+    // Reuse the pool across runs
+    for (0..3) |_| {
+        var context = TestContext{};
+        try pool.run(&context, TestContext.run, &tasks);
+
+        for (&context.visited) |*count| {
+            try std.testing.expectEqual(@as(u32, 1), count.load(.monotonic));
+        }
+    }
+}
+
+test "Pool: single worker runs inline" {
+    const pool = try Pool.init(std.testing.allocator, .{ .thread_count = 1 });
+    defer pool.deinit();
+
+    try std.testing.expectEqual(@as(usize, 1), pool.getThreadCount());
+
+    var context = TestContext{};
+    const tasks = [_]Task{.{ .index = 0 }};
+    try pool.run(&context, TestContext.run, &tasks);
+
+    try std.testing.expectEqual(@as(u32, 1), context.visited[0].load(.monotonic));
+    try std.testing.expectEqual(@as(u32, 1), context.visited[32].load(.monotonic));
+}
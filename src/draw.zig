@@ -11,6 +11,8 @@ const std = @import("std");
 const geometry = @import("core/geometry.zig");
 const color_mod = @import("core/color.zig");
 const profiler = @import("profiler.zig");
+const thread_pool = @import("core/pool.zig");
+const DamageList = @import("layout/damage.zig").DamageList;
 
 pub const Rect = geometry.Rect;
 pub const Point = geometry.Point;
@@ -98,6 +100,74 @@ pub const DrawCommand = struct {
     widget_id: u32 = 0,
 };
 
+/// A run of consecutive commands drawn with the same state: one layer, one
+/// clip rect and one primitive kind. GPU backends change state once per
+/// batch; the software rasterizer dispatches once per batch.
+pub const DrawBatch = struct {
+    /// First command (index into DrawData.commands)
+    start: u32,
+    count: u32,
+
+    layer: u16,
+    clip_rect: ?Rect,
+    kind: std.meta.Tag(DrawPrimitive),
+
+    /// This batch's commands out of the whole frame's
+    pub fn commands(self: DrawBatch, all: []const DrawCommand) []const DrawCommand {
+        return all[self.start..][0..self.count];
+    }
+
+    /// Whether `cmd` can be drawn with this batch's state
+    fn accepts(self: DrawBatch, cmd: DrawCommand) bool {
+        return self.layer == cmd.layer and
+            self.kind == std.meta.activeTag(cmd.primitive) and
+            std.meta.eql(self.clip_rect, cmd.clip_rect);
+    }
+};
+
+/// Walks commands in layer order (submission order within a layer) without
+/// sorting or allocating: one pass when they are already in order, as after
+/// DrawList.finalize, otherwise one pass per distinct layer.
+pub const LayerOrder = struct {
+    commands: []const DrawCommand,
+    sorted: bool,
+
+    /// Layer of the current pass
+    layer: u16,
+    /// Lowest layer above `layer` seen this pass (null = last pass)
+    next_layer: ?u16 = null,
+    index: usize = 0,
+
+    pub fn init(commands: []const DrawCommand) LayerOrder {
+        var sorted = true;
+        var lowest: u16 = std.math.maxInt(u16);
+        for (commands, 0..) |cmd, i| {
+            lowest = @min(lowest, cmd.layer);
+            if (i > 0 and cmd.layer < commands[i - 1].layer) sorted = false;
+        }
+        return .{ .commands = commands, .sorted = sorted, .layer = lowest };
+    }
+
+    /// Index of the next command to draw, or null when done
+    pub fn next(self: *LayerOrder) ?usize {
+        while (true) {
+            while (self.index < self.commands.len) {
+                const i = self.index;
+                self.index += 1;
+                const layer = self.commands[i].layer;
+                if (self.sorted or layer == self.layer) return i;
+                if (layer > self.layer and (self.next_layer == null or layer < self.next_layer.?)) {
+                    self.next_layer = layer;
+                }
+            }
+            if (self.sorted) return null;
+            self.layer = self.next_layer orelse return null;
+            self.next_layer = null;
+            self.index = 0;
+        }
+    }
+};
+
 // =============================================================================
 // Draw List
 // =============================================================================
@@ -107,28 +177,42 @@ pub const DrawList = struct {
     commands: std.ArrayList(DrawCommand),
     allocator: std.mem.Allocator,
 
+    /// Set by finalize (see getBatches)
+    batches: std.ArrayList(DrawBatch),
+    /// Radix sort buffer, kept between frames
+    sort_scratch: std.ArrayList(DrawCommand),
+
     // State stacks for hierarchical rendering
     clip_stack: std.BoundedArray(Rect, 16) = .{},
     layer_stack: std.BoundedArray(u16, 16) = .{},
 
     current_layer: u16 = 0,
 
+    /// Primitives dropped this frame because they fell outside the clip
+    culled_count: u32 = 0,
+
     pub fn init(allocator: std.mem.Allocator) DrawList {
         return .{
             .commands = std.ArrayList(DrawCommand).init(allocator),
             .allocator = allocator,
+            .batches = std.ArrayList(DrawBatch).init(allocator),
+            .sort_scratch = std.ArrayList(DrawCommand).init(allocator),
         };
     }
 
     pub fn deinit(self: *DrawList) void {
         self.commands.deinit();
+        self.batches.deinit();
+        self.sort_scratch.deinit();
     }
 
     pub fn clear(self: *DrawList) void {
         self.commands.clearRetainingCapacity();
+        self.batches.clearRetainingCapacity();
         self.clip_stack.len = 0;
         self.layer_stack.len = 0;
         self.current_layer = 0;
+        self.culled_count = 0;
     }
 
     /// Get the number of commands in the list
@@ -143,6 +227,7 @@ pub const DrawList = struct {
     }
 
     pub fn addFilledRectEx(self: *DrawList, rect: Rect, draw_color: Color, corner_radius: f32) void {
+        if (self.cull(rect)) return;
         self.commands.append(.{
             .primitive = .{ .fill_rect = .{
                 .rect = rect,
@@ -159,6 +244,8 @@ pub const DrawList = struct {
     }
 
     pub fn addStrokeRectEx(self: *DrawList, rect: Rect, draw_color: Color, width: f32, corner_radius: f32) void {
+        const half = width / 2;
+        if (self.cull(.{ .x = rect.x - half, .y = rect.y - half, .width = rect.width + width, .height = rect.height + width })) return;
         self.commands.append(.{
             .primitive = .{ .stroke_rect = .{
                 .rect = rect,
@@ -176,6 +263,8 @@ pub const DrawList = struct {
     }
 
     pub fn addTextEx(self: *DrawList, pos: Point, text: []const u8, draw_color: Color, font_size: f32, font_id: u16) void {
+        // Width is unknown without shaping: only cull on the line box and the left edge
+        if (self.cull(.{ .x = pos.x, .y = pos.y - font_size, .width = std.math.inf(f32), .height = font_size * 2 })) return;
         self.commands.append(.{
             .primitive = .{ .text = .{
                 .position = pos,
@@ -190,6 +279,15 @@ pub const DrawList = struct {
     }
 
     pub fn addLine(self: *DrawList, start: Point, end: Point, draw_color: Color, width: f32) void {
+        const half = width / 2;
+        const min_x = @min(start.x, end.x) - half;
+        const min_y = @min(start.y, end.y) - half;
+        if (self.cull(.{
+            .x = min_x,
+            .y = min_y,
+            .width = @max(start.x, end.x) + half - min_x,
+            .height = @max(start.y, end.y) + half - min_y,
+        })) return;
         self.commands.append(.{
             .primitive = .{ .line = .{
                 .start = start,
@@ -233,11 +331,32 @@ pub const DrawList = struct {
         return self.clip_stack.buffer[self.clip_stack.len - 1];
     }
 
+    /// Whether anything inside `bounds` can show through the current clip.
+    /// Lets callers skip building whole widgets (e.g. rows of a scrolled
+    /// list) that the add* functions would cull anyway.
+    pub fn isVisible(self: *const DrawList, bounds: Rect) bool {
+        const clip = self.currentClip() orelse return true;
+        return bounds.x < clip.x + clip.width and bounds.x + bounds.width > clip.x and
+            bounds.y < clip.y + clip.height and bounds.y + bounds.height > clip.y;
+    }
+
+    /// Drop a primitive entirely outside the clip before it becomes a command
+    inline fn cull(self: *DrawList, bounds: Rect) bool {
+        if (self.isVisible(bounds)) return false;
+        self.culled_count += 1;
+        return true;
+    }
+
     // === Layer stack ===
 
     pub fn pushLayer(self: *DrawList) void {
+        self.pushLayerAbove(1);
+    }
+
+    /// Push a layer `levels` above the current one (FlexStyle.layer)
+    pub fn pushLayerAbove(self: *DrawList, levels: u16) void {
         self.layer_stack.append(self.current_layer) catch {};
-        self.current_layer += 1;
+        self.current_layer +|= levels;
     }
 
     pub fn popLayer(self: *DrawList) void {
@@ -250,6 +369,89 @@ pub const DrawList = struct {
     pub fn getCommands(self: *const DrawList) []const DrawCommand {
         return self.commands.items;
     }
+
+    // === Finalize ===
+
+    /// End recording: stable-sort the commands by layer, so popups drawn
+    /// mid-tree end up on top, then group runs that share layer, clip and
+    /// primitive kind into batches.
+    pub fn finalize(self: *DrawList) void {
+        self.sortByLayer();
+
+        self.batches.clearRetainingCapacity();
+        for (self.commands.items, 0..) |cmd, i| {
+            if (self.batches.items.len > 0) {
+                const last = &self.batches.items[self.batches.items.len - 1];
+                if (last.accepts(cmd)) {
+                    last.count += 1;
+                    continue;
+                }
+            }
+            self.batches.append(.{
+                .start = @intCast(i),
+                .count = 1,
+                .layer = cmd.layer,
+                .clip_rect = cmd.clip_rect,
+                .kind = std.meta.activeTag(cmd.primitive),
+            }) catch {
+                // Unbatched data is still valid
+                self.batches.clearRetainingCapacity();
+                return;
+            };
+        }
+    }
+
+    /// Batches covering getCommands() in order; empty if finalize has not
+    /// run since the last command was added
+    pub fn getBatches(self: *const DrawList) []const DrawBatch {
+        const batches = self.batches.items;
+        if (batches.len == 0) return &.{};
+        const last = batches[batches.len - 1];
+        if (last.start + last.count != self.commands.items.len) return &.{};
+        return batches;
+    }
+
+    /// LSD radix sort on the layer's two bytes (stable)
+    fn sortByLayer(self: *DrawList) void {
+        const commands = self.commands.items;
+        var sorted = true;
+        var max_layer: u16 = 0;
+        for (commands, 0..) |cmd, i| {
+            max_layer = @max(max_layer, cmd.layer);
+            if (i > 0 and cmd.layer < commands[i - 1].layer) sorted = false;
+        }
+        // The usual frame: no popups, or popups recorded last
+        if (sorted) return;
+
+        self.sort_scratch.resize(commands.len) catch {
+            // No scratch: block sort is stable and sorts in place
+            std.sort.block(DrawCommand, commands, {}, layerBelow);
+            return;
+        };
+        var src: []DrawCommand = commands;
+        var dst: []DrawCommand = self.sort_scratch.items;
+        var shift: u4 = 0;
+        while (true) {
+            var counts = [_]u32{0} ** 257;
+            for (src) |cmd| counts[((cmd.layer >> shift) & 0xFF) + 1] += 1;
+            for (1..257) |digit| counts[digit] += counts[digit - 1];
+            for (src) |cmd| {
+                const digit = (cmd.layer >> shift) & 0xFF;
+                dst[counts[digit]] = cmd;
+                counts[digit] += 1;
+            }
+            std.mem.swap([]DrawCommand, &src, &dst);
+
+            // Layers rarely reach 256: skip the high byte
+            if (shift == 8 or max_layer >> 8 == 0) break;
+            shift = 8;
+        }
+        if (src.ptr != commands.ptr) @memcpy(commands, src);
+    }
+
+    fn layerBelow(_: void, a: DrawCommand, b: DrawCommand) bool {
+        return a.layer < b.layer;
+    }
 };
 
 // =============================================================================
@@ -261,6 +463,11 @@ pub const DrawData = struct {
     /// All draw commands for this frame
     commands: []const DrawCommand,
 
+    /// Batches over `commands` from DrawList.finalize. Empty when the list
+    /// was not finalized: commands are then in submission order, and
+    /// backends walk them with layerOrder().
+    batches: []const DrawBatch = &.{},
+
     /// Display dimensions
     display_size: Size,
 
@@ -273,6 +480,12 @@ pub const DrawData = struct {
     /// Total index count
     total_index_count: u32 = 0,
 
+    /// Regions whose layout changed since the previous frame (bounded,
+    /// merged boxes; see LayoutEngine.collectDamage). Backends that keep
+    /// the last frame can repaint just these. Covers layout geometry only:
+    /// paint-only changes (colors, text) are not included.
+    damage: []const Rect = &.{},
+
     /// Check if there are any commands to render
     pub fn isEmpty(self: *const DrawData) bool {
         return self.commands.len == 0;
@@ -282,6 +495,11 @@ pub const DrawData = struct {
     pub fn commandCount(self: *const DrawData) usize {
         return self.commands.len;
     }
+
+    /// Command indices back to front
+    pub fn layerOrder(self: *const DrawData) LayerOrder {
+        return LayerOrder.init(self.commands);
+    }
 };
 
 // =============================================================================
@@ -410,6 +628,91 @@ pub fn colorToRGBA(c: Color) u32 {
     return (@as(u32, c.r) << 24) | (@as(u32, c.g) << 16) | (@as(u32, c.b) << 8) | @as(u32, c.a);
 }
 
+// =============================================================================
+// Pixel Spans
+// =============================================================================
+
+/// Pixels per blend iteration: two native u32 vectors (8 on SSE/NEON, 16 on
+/// AVX2), enough independent multiplies to hide their latency
+pub const SPAN_LANES = 2 * (std.simd.suggestVectorLength(u32) orelse 4);
+
+/// Fill a run of ARGB pixels with `color`: opaque colors are a memset,
+/// translucent ones are blended source-over (see SpanBlend)
+pub fn fillSpan(span: []u32, color: u32) void {
+    const src_a = color >> 24;
+    if (src_a == 255) {
+        @memset(span, color);
+    } else if (src_a > 0) {
+        SpanBlend.init(color).span(span);
+    }
+}
+
+/// Source-over blend of one translucent ARGB color, computed per channel as
+///
+///   out = (src * a + dst * (255 - a) + 128) * 257 >> 16
+///
+/// which is src * a + dst * (255 - a) divided by 255, rounded, exactly.
+/// Red/blue and alpha/green are blended as two 16-bit fields per u32 lane
+/// (0x00RR00BB), so a lane is two multiplies. Output alpha is opaque.
+pub const SpanBlend = struct {
+    /// src * a + 128 for red and blue, packed like the masked destination
+    src_rb: u32,
+    /// src * a + 128 for green (the alpha field is unused)
+    src_g: u32,
+    /// 255 - a
+    inv_a: u32,
+
+    const Lanes = @Vector(SPAN_LANES, u32);
+
+    /// `color` must be translucent (0 < alpha < 255)
+    pub fn init(color: u32) SpanBlend {
+        const a = color >> 24;
+        return .{
+            .src_rb = (color & 0x00FF00FF) * a + 0x00800080,
+            .src_g = ((color >> 8) & 0xFF) * a + 0x80,
+            .inv_a = 255 - a,
+        };
+    }
+
+    /// Blend onto one pixel
+    pub fn pixel(self: SpanBlend, dst: u32) u32 {
+        return self.lanes(u32, dst);
+    }
+
+    /// Blend onto every pixel of `span`, SPAN_LANES at a time
+    pub fn span(self: SpanBlend, pixels: []u32) void {
+        var i: usize = 0;
+        while (i + SPAN_LANES <= pixels.len) : (i += SPAN_LANES) {
+            const dst: Lanes = pixels[i..][0..SPAN_LANES].*;
+            pixels[i..][0..SPAN_LANES].* = self.lanes(Lanes, dst);
+        }
+        for (pixels[i..]) |*dst| dst.* = self.pixel(dst.*);
+    }
+
+    /// The blend on u32 or a vector of them
+    inline fn lanes(self: SpanBlend, comptime T: type, dst: T) T {
+        const Shift = if (T == u32) u5 else @Vector(SPAN_LANES, u5);
+        const eight = splat(Shift, 8);
+        const mask = splat(T, 0x00FF00FF);
+        const inv_a = splat(T, self.inv_a);
+
+        // Each 16-bit field holds at most 255 * 255 + 128 < 2^16: no carries
+        const rb = (dst & mask) * inv_a + splat(T, self.src_rb);
+        const ag = ((dst >> eight) & mask) * inv_a + splat(T, self.src_g);
+
+        // x * 257 >> 16 == (x + (x >> 8)) >> 8, per field
+        const out_rb = ((rb + ((rb >> eight) & mask)) >> eight) & mask;
+        const out_g = (ag + ((ag >> eight) & mask)) & splat(T, 0xFF00);
+        return splat(T, 0xFF000000) | out_rb | out_g;
+    }
+
+    /// Broadcast a scalar when T is a vector
+    inline fn splat(comptime T: type, x: anytype) T {
+        if (comptime @typeInfo(T) == .Vector) return @splat(x);
+        return x;
+    }
+};
+
 // =============================================================================
 // Null/Test Backend
 // =============================================================================
@@ -418,6 +721,9 @@ pub fn colorToRGBA(c: Color) u32 {
 pub const NullBackend = struct {
     render_count: u32 = 0,
     last_command_count: usize = 0,
+    /// State changes (layer, clip or primitive kind) a GPU backend would
+    /// have made drawing the last frame back to front
+    last_batch_count: usize = 0,
 
     pub fn init() NullBackend {
         return .{};
@@ -445,6 +751,28 @@ pub const NullBackend = struct {
         const self: *NullBackend = @ptrCast(@alignCast(ptr));
         self.render_count += 1;
         self.last_command_count = data.commands.len;
+
+        if (data.batches.len > 0) {
+            self.last_batch_count = data.batches.len;
+            return;
+        }
+        self.last_batch_count = 0;
+        var batch: ?DrawBatch = null;
+        var order = data.layerOrder();
+        while (order.next()) |i| {
+            const cmd = data.commands[i];
+            if (batch) |current| {
+                if (current.accepts(cmd)) continue;
+            }
+            batch = .{
+                .start = @intCast(i),
+                .count = 1,
+                .layer = cmd.layer,
+                .clip_rect = cmd.clip_rect,
+                .kind = std.meta.activeTag(cmd.primitive),
+            };
+            self.last_batch_count += 1;
+        }
     }
 
     fn endFrameImpl(_: *anyopaque) void {}
@@ -471,12 +799,158 @@ pub const NullBackend = struct {
 
 /// A software rasterizer that renders to a pixel buffer.
 /// Suitable for embedded systems, headless testing, and image output.
+///
+/// Commands are rasterized back to front by layer (submission order within
+/// a layer) over the whole framebuffer, or, with
+/// enableTiling, binned into screen tiles that are rasterized in parallel
+/// (same pixels either way). With enableRetained, only the regions where
+/// this frame's commands differ from the last one's are repainted.
 pub const SoftwareBackend = struct {
     pixels: []u32, // ARGB format
     width: u32,
     height: u32,
     clear_color: u32 = 0xFF000000, // Opaque black
 
+    /// Tiled mode state (null = serial)
+    tiling: ?Tiling = null,
+
+    /// Retained mode state (null = full repaint every frame)
+    retained: ?Retained = null,
+
+    /// Tile edge in pixels: 128x128 ARGB = 64KB, resident in L2 while a
+    /// tile's commands run
+    pub const DEFAULT_TILE_SIZE: u32 = 128;
+
+    /// Half-open pixel box [x0, x1) x [y0, y1)
+    const PixelBox = struct {
+        x0: u32,
+        y0: u32,
+        x1: u32,
+        y1: u32,
+
+        fn intersect(a: PixelBox, b: PixelBox) PixelBox {
+            return .{
+                .x0 = @max(a.x0, b.x0),
+                .y0 = @max(a.y0, b.y0),
+                .x1 = @min(a.x1, b.x1),
+                .y1 = @min(a.y1, b.y1),
+            };
+        }
+
+        fn isEmpty(self: PixelBox) bool {
+            return self.x1 <= self.x0 or self.y1 <= self.y0;
+        }
+    };
+
+    /// Per-frame tile bins. Each command goes to every tile its pixels can
+    /// touch, in submission order, so a tile replays exactly the writes the
+    /// serial path makes to its pixels. Bins are stored CSR-style: tile t
+    /// draws commands[items[offsets[t]..offsets[t + 1]]].
+    const Tiling = struct {
+        allocator: std.mem.Allocator,
+        pool: *thread_pool.Pool,
+        tile_size: u32,
+        columns: u32 = 0,
+
+        offsets: std.ArrayListUnmanaged(u32) = .{},
+        cursors: std.ArrayListUnmanaged(u32) = .{},
+        items: std.ArrayListUnmanaged(u32) = .{},
+        tasks: std.ArrayListUnmanaged(thread_pool.Task) = .{},
+
+        /// This frame's commands while tiles run
+        commands: []const DrawCommand = &.{},
+        /// beginFrame's clear, done per tile by the next render
+        clear_pending: bool = false,
+
+        fn deinit(self: *Tiling) void {
+            self.offsets.deinit(self.allocator);
+            self.cursors.deinit(self.allocator);
+            self.items.deinit(self.allocator);
+            self.tasks.deinit(self.allocator);
+        }
+
+        fn tileBox(self: *const Tiling, tile: u32, width: u32, height: u32) PixelBox {
+            const x0 = (tile % self.columns) * self.tile_size;
+            const y0 = (tile / self.columns) * self.tile_size;
+            return .{
+                .x0 = x0,
+                .y0 = y0,
+                .x1 = @min(x0 + self.tile_size, width),
+                .y1 = @min(y0 + self.tile_size, height),
+            };
+        }
+
+        /// Tiles overlapping a non-empty box, row by row
+        fn tilesIn(self: *const Tiling, box: PixelBox) TileIterator {
+            const first_column = box.x0 / self.tile_size;
+            const first_row = box.y0 / self.tile_size;
+            return .{
+                .columns = self.columns,
+                .first_column = first_column,
+                .last_column = (box.x1 - 1) / self.tile_size,
+                .last_row = (box.y1 - 1) / self.tile_size,
+                .column = first_column,
+                .row = first_row,
+            };
+        }
+    };
+
+    const TileIterator = struct {
+        columns: u32,
+        first_column: u32,
+        last_column: u32,
+        last_row: u32,
+        column: u32,
+        row: u32,
+
+        fn next(self: *TileIterator) ?u32 {
+            if (self.row > self.last_row) return null;
+            const tile = self.row * self.columns + self.column;
+            if (self.column == self.last_column) {
+                self.column = self.first_column;
+                self.row += 1;
+            } else {
+                self.column += 1;
+            }
+            return tile;
+        }
+    };
+
+    /// Last frame's commands, to diff the next frame against. The framebuffer
+    /// is kept between frames; a frame clears and redraws only the boxes of
+    /// commands that were added, removed, changed or reordered.
+    const Retained = struct {
+        allocator: std.mem.Allocator,
+
+        /// Rasterized commands (fills, strokes, lines) of the last frame
+        previous: std.ArrayListUnmanaged(DrawCommand) = .{},
+        current: std.ArrayListUnmanaged(DrawCommand) = .{},
+
+        /// Unmatched previous commands by hash: first index, then `next`
+        /// chains the rest in submission order
+        heads: std.AutoHashMapUnmanaged(u64, u32) = .{},
+        next: std.ArrayListUnmanaged(u32) = .{},
+
+        /// Pixel regions repainted by the last frame
+        damage: DamageList = .{},
+
+        /// The framebuffer holds `previous` drawn over `clear_color`
+        valid: bool = false,
+        clear_color: u32 = 0,
+        /// beginFrame ran and render has not yet
+        frame_pending: bool = false,
+
+        const END: u32 = std.math.maxInt(u32);
+        const MATCHED: u32 = std.math.maxInt(u32) - 1;
+
+        fn deinit(self: *Retained) void {
+            self.previous.deinit(self.allocator);
+            self.current.deinit(self.allocator);
+            self.heads.deinit(self.allocator);
+            self.next.deinit(self.allocator);
+        }
+    };
+
     pub fn init(pixels: []u32, width: u32, height: u32) SoftwareBackend {
         return .{
             .pixels = pixels,
@@ -496,9 +970,58 @@ pub const SoftwareBackend = struct {
     }
 
     pub fn deinit(self: *SoftwareBackend, allocator: std.mem.Allocator) void {
+        self.disableTiling();
+        self.disableRetained();
         allocator.free(self.pixels);
     }
 
+    /// Keep the framebuffer between frames and repaint only what changed.
+    /// The first frame after this is drawn in full. Retained frames are
+    /// rasterized on the calling thread, even with tiling enabled.
+    pub fn enableRetained(self: *SoftwareBackend, allocator: std.mem.Allocator) void {
+        self.disableRetained();
+        self.retained = .{ .allocator = allocator };
+    }
+
+    /// Back to clearing and redrawing everything each frame
+    pub fn disableRetained(self: *SoftwareBackend) void {
+        if (self.retained) |*retained| {
+            retained.deinit();
+            self.retained = null;
+        }
+    }
+
+    /// Force the next retained frame to repaint everything (e.g. after
+    /// writing to `pixels` directly)
+    pub fn invalidate(self: *SoftwareBackend) void {
+        if (self.retained) |*retained| retained.valid = false;
+    }
+
+    /// Pixel regions the last retained frame repainted: present just these.
+    /// Empty when nothing changed or retained mode is off.
+    pub fn getDamage(self: *const SoftwareBackend) []const Rect {
+        if (self.retained) |*retained| return retained.damage.items();
+        return &.{};
+    }
+
+    /// Rasterize in `tile_size` squares spread over `pool` (e.g. the layout
+    /// pool). `allocator` holds the bins and must be thread-safe, as for the
+    /// pool. The clear requested by beginFrame is then done per tile by
+    /// render, while the tile is in cache.
+    pub fn enableTiling(self: *SoftwareBackend, allocator: std.mem.Allocator, pool: *thread_pool.Pool, tile_size: u32) void {
+        self.disableTiling();
+        self.tiling = .{ .allocator = allocator, .pool = pool, .tile_size = @max(1, tile_size) };
+    }
+
+    /// Back to serial rasterization; frees the bins
+    pub fn disableTiling(self: *SoftwareBackend) void {
+        if (self.tiling) |*tiling| {
+            if (tiling.clear_pending) @memset(self.pixels, self.clear_color);
+            tiling.deinit();
+            self.tiling = null;
+        }
+    }
+
     pub fn interface(self: *SoftwareBackend) RenderBackend {
         return .{
             .ptr = self,
@@ -520,6 +1043,16 @@ pub const SoftwareBackend = struct {
         defer profiler.endZone();
 
         const self: *SoftwareBackend = @ptrCast(@alignCast(ptr));
+        if (self.retained) |*retained| {
+            // Only damaged regions are cleared, by render
+            retained.frame_pending = true;
+            return;
+        }
+        if (self.tiling) |*tiling| {
+            // Deferred to the tiles
+            tiling.clear_pending = true;
+            return;
+        }
         // Clear to background color
         @memset(self.pixels, self.clear_color);
     }
@@ -530,22 +1063,57 @@ pub const SoftwareBackend = struct {
 
         const self: *SoftwareBackend = @ptrCast(@alignCast(ptr));
 
+        if (self.retained != null) {
+            self.renderRetained(data.commands);
+            return;
+        }
+        if (self.tiling != null) {
+            // Nothing is drawn before binning succeeds, so the serial path
+            // can still take over
+            self.renderTiled(data.commands) catch {
+                self.flushPendingClear();
+                self.renderSerial(data.commands, data.batches);
+            };
+            return;
+        }
+        self.renderSerial(data.commands, data.batches);
+    }
+
+    /// Rasterize over the whole framebuffer, a batch at a time when the
+    /// commands were finalized
+    fn renderSerial(self: *SoftwareBackend, commands: []const DrawCommand, batches: []const DrawBatch) void {
         var fill_count: u32 = 0;
         var stroke_count: u32 = 0;
 
-        for (data.commands) |cmd| {
-            switch (cmd.primitive) {
-                .fill_rect => |r| {
-                    self.renderFillRect(r, cmd.clip_rect);
-                    fill_count += 1;
-                },
-                .stroke_rect => |r| {
-                    self.renderStrokeRect(r, cmd.clip_rect);
-                    stroke_count += 1;
-                },
-                .line => |l| self.renderLine(l, cmd.clip_rect),
-                .text => {}, // Text rendering requires font atlas - skip for now
-                .vertices => {}, // Complex - skip for basic implementation
+        const screen = self.screenBox();
+        if (batches.len > 0) {
+            for (batches) |batch| {
+                const run = batch.commands(commands);
+                switch (batch.kind) {
+                    .fill_rect => {
+                        for (run) |cmd| self.renderFillRect(cmd.primitive.fill_rect, cmd.clip_rect, screen);
+                        fill_count += batch.count;
+                    },
+                    .stroke_rect => {
+                        for (run) |cmd| self.renderStrokeRect(cmd.primitive.stroke_rect, cmd.clip_rect, screen);
+                        stroke_count += batch.count;
+                    },
+                    .line => {
+                        for (run) |cmd| self.renderLine(cmd.primitive.line, cmd.clip_rect, screen);
+                    },
+                    .text, .vertices => {},
+                }
+            }
+        } else {
+            var order = LayerOrder.init(commands);
+            while (order.next()) |i| {
+                const cmd = commands[i];
+                switch (cmd.primitive) {
+                    .fill_rect => fill_count += 1,
+                    .stroke_rect => stroke_count += 1,
+                    else => {},
+                }
+                self.renderCommand(cmd, screen);
             }
         }
 
@@ -555,7 +1123,24 @@ pub const SoftwareBackend = struct {
         }
     }
 
-    fn endFrameImpl(_: *anyopaque) void {}
+    fn endFrameImpl(ptr: *anyopaque) void {
+        const self: *SoftwareBackend = @ptrCast(@alignCast(ptr));
+        // A frame without render still shows the clear
+        if (self.retained) |retained| {
+            if (retained.frame_pending) self.renderRetained(&.{});
+            return;
+        }
+        self.flushPendingClear();
+    }
+
+    /// Do beginFrame's deferred clear over the whole framebuffer, if any
+    fn flushPendingClear(self: *SoftwareBackend) void {
+        if (self.tiling) |*tiling| {
+            if (!tiling.clear_pending) return;
+            @memset(self.pixels, self.clear_color);
+            tiling.clear_pending = false;
+        }
+    }
 
     fn createTextureImpl(_: *anyopaque, _: u32, _: u32, _: []const u8) u32 {
         return 1;
@@ -571,90 +1156,452 @@ pub const SoftwareBackend = struct {
         };
     }
 
-    // === Rendering primitives ===
+    // === Retained rasterization ===
+
+    /// Diff against the last frame, then clear and redraw the damage. Each
+    /// region is redrawn with every command that reaches it, cut to the
+    /// region, so its pixels match a full redraw exactly.
+    fn renderRetained(self: *SoftwareBackend, commands: []const DrawCommand) void {
+        const retained = &self.retained.?;
+        retained.frame_pending = false;
+        retained.damage.clear();
+
+        self.diffRetained(commands) catch {
+            // Out of memory: repaint everything and start over next frame
+            retained.valid = false;
+            retained.previous.clearRetainingCapacity();
+            retained.damage.clear();
+            retained.damage.add(boxRect(self.screenBox()));
+            @memset(self.pixels, self.clear_color);
+            self.renderSerial(commands, &.{});
+            return;
+        };
+
+        for (retained.damage.items()) |rect| {
+            const region = rectBox(rect);
+            var y = region.y0;
+            while (y < region.y1) : (y += 1) {
+                @memset(self.pixels[y * self.width + region.x0 .. y * self.width + region.x1], self.clear_color);
+            }
+            for (retained.previous.items) |cmd| {
+                const box = self.commandBox(cmd).?;
+                if (!box.intersect(region).isEmpty()) self.renderCommand(cmd, region);
+            }
+        }
+    }
 
-    fn renderFillRect(self: *SoftwareBackend, r: DrawPrimitive.FillRect, clip: ?Rect) void {
-        const bounds = self.clipRect(r.rect, clip);
-        if (bounds.width <= 0 or bounds.height <= 0) return;
+    /// Fill `damage` with the boxes of commands added, removed, changed or
+    /// moved in order since the last frame, and make `commands` the new
+    /// `previous`
+    fn diffRetained(self: *SoftwareBackend, commands: []const DrawCommand) !void {
+        const retained = &self.retained.?;
+        const allocator = retained.allocator;
+
+        // Only commands that put pixels on screen take part, back to front
+        retained.current.clearRetainingCapacity();
+        var order = LayerOrder.init(commands);
+        while (order.next()) |i| {
+            if (self.commandBox(commands[i]) != null) try retained.current.append(allocator, commands[i]);
+        }
 
-        const color = colorToARGB(r.color);
-        const x0 = self.clampX(bounds.x);
-        const y0 = self.clampY(bounds.y);
-        const x1 = self.clampX(bounds.x + bounds.width);
-        const y1 = self.clampY(bounds.y + bounds.height);
-
-        if (x1 <= x0 or y1 <= y0) return;
-
-        const src_a = (color >> 24) & 0xFF;
-
-        if (src_a == 255) {
-            // Fast path: opaque color - use direct memory fills
-            const row_width = x1 - x0;
-            var y = y0;
-            while (y < y1) : (y += 1) {
-                const row_start = y * self.width + x0;
-                @memset(self.pixels[row_start..][0..row_width], color);
+        if (!retained.valid or retained.clear_color != self.clear_color) {
+            retained.damage.add(boxRect(self.screenBox()));
+        } else {
+            // Chain previous commands by hash, lowest index first
+            const previous = retained.previous.items;
+            retained.heads.clearRetainingCapacity();
+            try retained.next.resize(allocator, previous.len);
+            var i = previous.len;
+            while (i > 0) {
+                i -= 1;
+                const entry = try retained.heads.getOrPut(allocator, commandHash(previous[i]));
+                retained.next.items[i] = if (entry.found_existing) entry.value_ptr.* else Retained.END;
+                entry.value_ptr.* = @intCast(i);
             }
-        } else if (src_a > 0) {
-            // Slow path: alpha blending required
-            var y = y0;
-            while (y < y1) : (y += 1) {
-                var x = x0;
-                while (x < x1) : (x += 1) {
-                    self.blendPixelUnchecked(x, y, color, src_a);
+
+            // Match in order. Matches must keep their previous relative
+            // order; one that jumps back is damaged like a change.
+            var last_match: ?u32 = null;
+            for (retained.current.items) |cmd| {
+                const match = self.takeMatch(cmd);
+                if (match) |j| {
+                    if (last_match == null or j > last_match.?) {
+                        last_match = j;
+                        continue;
+                    }
                 }
+                retained.damage.add(boxRect(self.commandBox(cmd).?));
+            }
+
+            // Whatever was not matched is gone
+            for (previous, retained.next.items) |cmd, link| {
+                if (link != Retained.MATCHED) retained.damage.add(boxRect(self.commandBox(cmd).?));
             }
         }
-        // src_a == 0: fully transparent, nothing to draw
+
+        std.mem.swap(std.ArrayListUnmanaged(DrawCommand), &retained.previous, &retained.current);
+        retained.valid = true;
+        retained.clear_color = self.clear_color;
+    }
+
+    /// Consume the first unmatched previous command equal to `cmd`
+    fn takeMatch(self: *SoftwareBackend, cmd: DrawCommand) ?u32 {
+        const retained = &self.retained.?;
+        const hash = commandHash(cmd);
+        const head = retained.heads.getPtr(hash) orelse return null;
+        const j = head.*;
+        if (j == Retained.END or !std.meta.eql(retained.previous.items[j], cmd)) return null;
+
+        head.* = retained.next.items[j];
+        retained.next.items[j] = Retained.MATCHED;
+        return j;
     }
 
-    /// Blend pixel without bounds checking (caller must ensure valid coords)
-    inline fn blendPixelUnchecked(self: *SoftwareBackend, x: u32, y: u32, color: u32, src_a: u32) void {
-        const idx = y * self.width + x;
-        const dst = self.pixels[idx];
-        const dst_r = (dst >> 16) & 0xFF;
-        const dst_g = (dst >> 8) & 0xFF;
-        const dst_b = dst & 0xFF;
+    /// Hash of everything that affects a rasterized command's pixels
+    fn commandHash(cmd: DrawCommand) u64 {
+        var hasher = std.hash.Wyhash.init(0);
+        hasher.update(std.mem.asBytes(&cmd.widget_id));
+        hasher.update(std.mem.asBytes(&cmd.layer));
+        if (cmd.clip_rect) |clip| hasher.update(std.mem.asBytes(&clip));
+        hasher.update(&[_]u8{@intFromEnum(std.meta.activeTag(cmd.primitive))});
+        switch (cmd.primitive) {
+            .fill_rect => |r| hasher.update(std.mem.asBytes(&r)),
+            .stroke_rect => |r| hasher.update(std.mem.asBytes(&r)),
+            .line => |l| hasher.update(std.mem.asBytes(&l)),
+            .text, .vertices => {},
+        }
+        return hasher.final();
+    }
+
+    fn boxRect(box: PixelBox) Rect {
+        return .{
+            .x = @floatFromInt(box.x0),
+            .y = @floatFromInt(box.y0),
+            .width = @floatFromInt(box.x1 - box.x0),
+            .height = @floatFromInt(box.y1 - box.y0),
+        };
+    }
+
+    /// Inverse of boxRect (damage regions are whole pixels)
+    fn rectBox(rect: Rect) PixelBox {
+        const x0: u32 = @intFromFloat(rect.x);
+        const y0: u32 = @intFromFloat(rect.y);
+        return .{
+            .x0 = x0,
+            .y0 = y0,
+            .x1 = x0 + @as(u32, @intFromFloat(rect.width)),
+            .y1 = y0 + @as(u32, @intFromFloat(rect.height)),
+        };
+    }
 
-        const src_r = (color >> 16) & 0xFF;
-        const src_g = (color >> 8) & 0xFF;
-        const src_b = color & 0xFF;
+    // === Tiled rasterization ===
+
+    /// Bin commands into tiles, then rasterize the tiles on the pool. Fails
+    /// (out of memory) before touching any pixel.
+    fn renderTiled(self: *SoftwareBackend, commands: []const DrawCommand) !void {
+        const tiling = &self.tiling.?;
+        const allocator = tiling.allocator;
+        const size = tiling.tile_size;
+        tiling.columns = (self.width + size - 1) / size;
+        const rows = (self.height + size - 1) / size;
+        const tile_count = tiling.columns * rows;
+
+        // Count per tile, prefix-sum into offsets, then fill in layer order
+        try tiling.offsets.resize(allocator, tile_count + 1);
+        try tiling.cursors.resize(allocator, tile_count);
+        const offsets = tiling.offsets.items;
+        @memset(offsets, 0);
+        for (commands) |cmd| {
+            const box = self.commandBox(cmd) orelse continue;
+            var it = tiling.tilesIn(box);
+            while (it.next()) |tile| offsets[tile + 1] += 1;
+        }
+        for (0..tile_count) |tile| offsets[tile + 1] += offsets[tile];
+
+        try tiling.items.resize(allocator, offsets[tile_count]);
+        @memcpy(tiling.cursors.items, offsets[0..tile_count]);
+        var order = LayerOrder.init(commands);
+        while (order.next()) |i| {
+            const box = self.commandBox(commands[i]) orelse continue;
+            var it = tiling.tilesIn(box);
+            while (it.next()) |tile| {
+                tiling.items.items[tiling.cursors.items[tile]] = @intCast(i);
+                tiling.cursors.items[tile] += 1;
+            }
+        }
+
+        // Empty tiles only have work if they still need clearing
+        tiling.tasks.clearRetainingCapacity();
+        for (0..tile_count) |tile| {
+            if (!tiling.clear_pending and offsets[tile] == offsets[tile + 1]) continue;
+            try tiling.tasks.append(allocator, .{ .index = @intCast(tile) });
+        }
+
+        tiling.commands = commands;
+        defer tiling.commands = &.{};
+        try tiling.pool.run(self, renderTileTask, tiling.tasks.items);
+        tiling.clear_pending = false;
+    }
+
+    fn renderTileTask(context: *anyopaque, _: *thread_pool.Worker, task: thread_pool.Task) void {
+        const self: *SoftwareBackend = @ptrCast(@alignCast(context));
+        const tiling = &self.tiling.?;
+        const region = tiling.tileBox(task.index, self.width, self.height);
+
+        if (tiling.clear_pending) {
+            var y = region.y0;
+            while (y < region.y1) : (y += 1) {
+                @memset(self.pixels[y * self.width + region.x0 .. y * self.width + region.x1], self.clear_color);
+            }
+        }
+        const bin = tiling.items.items[tiling.offsets.items[task.index]..tiling.offsets.items[task.index + 1]];
+        for (bin) |command_index| {
+            self.renderCommand(tiling.commands[command_index], region);
+        }
+    }
+
+    // === Rendering primitives ===
+
+    /// Rasterize one command, writing only pixels inside `region`
+    fn renderCommand(self: *SoftwareBackend, cmd: DrawCommand, region: PixelBox) void {
+        switch (cmd.primitive) {
+            .fill_rect => |r| self.renderFillRect(r, cmd.clip_rect, region),
+            .stroke_rect => |r| self.renderStrokeRect(r, cmd.clip_rect, region),
+            .line => |l| self.renderLine(l, cmd.clip_rect, region),
+            .text => {}, // Text rendering requires font atlas - skip for now
+            .vertices => {}, // Complex - skip for basic implementation
+        }
+    }
+
+    /// Pixels a command can write (a superset, for binning); null if none
+    fn commandBox(self: *SoftwareBackend, cmd: DrawCommand) ?PixelBox {
+        switch (cmd.primitive) {
+            .fill_rect => |r| {
+                const box = self.pixelBox(r.rect, cmd.clip_rect) orelse return null;
+                return if (box.isEmpty()) null else box;
+            },
+            .stroke_rect => |r| {
+                // Edges are `stroke` thick even when the clipped box is thinner
+                var box = self.pixelBox(r.rect, cmd.clip_rect) orelse return null;
+                const stroke = strokeWidth(r.stroke_width);
+                box.x1 = @max(box.x1, @min(box.x0 + stroke, self.width));
+                box.y1 = @max(box.y1, @min(box.y0 + stroke, self.height));
+                return if (box.isEmpty()) null else box;
+            },
+            .line => |l| {
+                const x0: i32 = @intFromFloat(l.start.x);
+                const y0: i32 = @intFromFloat(l.start.y);
+                const x1: i32 = @intFromFloat(l.end.x);
+                const y1: i32 = @intFromFloat(l.end.y);
+                const box = PixelBox{
+                    .x0 = @intCast(std.math.clamp(@min(x0, x1), 0, @as(i32, @intCast(self.width)))),
+                    .y0 = @intCast(std.math.clamp(@min(y0, y1), 0, @as(i32, @intCast(self.height)))),
+                    .x1 = @intCast(std.math.clamp(@max(x0, x1) + 1, 0, @as(i32, @intCast(self.width)))),
+                    .y1 = @intCast(std.math.clamp(@max(y0, y1) + 1, 0, @as(i32, @intCast(self.height)))),
+                };
+                return if (box.isEmpty()) null else box;
+            },
+            .text, .vertices => return null,
+        }
+    }
 
-        const inv_a = 255 - src_a;
-        const out_r = (src_r * src_a + dst_r * inv_a) / 255;
-        const out_g = (src_g * src_a + dst_g * inv_a) / 255;
-        const out_b = (src_b * src_a + dst_b * inv_a) / 255;
+    fn renderFillRect(self: *SoftwareBackend, r: DrawPrimitive.FillRect, clip: ?Rect, region: PixelBox) void {
+        if (r.corner_radius > 0) return self.renderRoundedFill(r, clip, region);
 
-        self.pixels[idx] = 0xFF000000 | (out_r << 16) | (out_g << 8) | out_b;
+        // Opaque rows are memsets, translucent rows vector blends
+        const box = self.pixelBox(r.rect, clip) orelse return;
+        self.fillBox(box, colorToARGB(r.color), region);
     }
 
-    fn renderStrokeRect(self: *SoftwareBackend, r: DrawPrimitive.StrokeRect, clip: ?Rect) void {
-        const bounds = self.clipRect(r.rect, clip);
-        if (bounds.width <= 0 or bounds.height <= 0) return;
+    fn renderStrokeRect(self: *SoftwareBackend, r: DrawPrimitive.StrokeRect, clip: ?Rect, region: PixelBox) void {
+        if (r.corner_radius > 0) return self.renderRoundedStroke(r, clip, region);
+
+        // Edges are placed on the unclipped-to-region box, then cut to it
+        const box = self.pixelBox(r.rect, clip) orelse return;
 
         const color = colorToARGB(r.color);
-        const stroke = @max(1, @as(u32, @intFromFloat(r.stroke_width)));
+        const stroke = strokeWidth(r.stroke_width);
 
-        const x0 = self.clampX(bounds.x);
-        const y0 = self.clampY(bounds.y);
-        const x1 = self.clampX(bounds.x + bounds.width);
-        const y1 = self.clampY(bounds.y + bounds.height);
+        const x0 = box.x0;
+        const y0 = box.y0;
+        const x1 = box.x1;
+        const y1 = box.y1;
 
         // Top edge
-        self.fillHorizontalLine(x0, x1, y0, stroke, color);
+        self.fillHorizontalLine(x0, x1, y0, stroke, color, region);
         // Bottom edge
         if (y1 > y0 + stroke) {
-            self.fillHorizontalLine(x0, x1, y1 - stroke, stroke, color);
+            self.fillHorizontalLine(x0, x1, y1 - stroke, stroke, color, region);
         }
         // Left edge
-        self.fillVerticalLine(x0, y0, y1, stroke, color);
+        self.fillVerticalLine(x0, y0, y1, stroke, color, region);
         // Right edge
         if (x1 > x0 + stroke) {
-            self.fillVerticalLine(x1 - stroke, y0, y1, stroke, color);
+            self.fillVerticalLine(x1 - stroke, y0, y1, stroke, color, region);
         }
     }
 
-    fn renderLine(self: *SoftwareBackend, l: DrawPrimitive.LineDraw, clip: ?Rect) void {
+    // === Rounded corners ===
+    //
+    // Only the four corner blocks are shaded per pixel, with coverage from
+    // the rounded rect's signed distance at the pixel center. The rows and
+    // columns between them are plain spans, so an opaque interior is still
+    // a memset.
+
+    fn renderRoundedFill(self: *SoftwareBackend, r: DrawPrimitive.FillRect, clip: ?Rect, region: PixelBox) void {
+        const limit = (self.pixelBox(r.rect, clip) orelse return).intersect(region);
+        if (limit.isEmpty()) return;
+
+        const color = colorToARGB(r.color);
+        const shape = RoundedShape{ .rect = r.rect, .radius = clampRadius(r.rect, r.corner_radius) };
+
+        // Pixels outside these rows and columns are in a corner
+        const cols = cornerSplit(r.rect.x, r.rect.width, shape.radius);
+        const rows = cornerSplit(r.rect.y, r.rect.height, shape.radius);
+        const mid = splitBox(cols, rows, limit);
+
+        var y = limit.y0;
+        while (y < limit.y1) : (y += 1) {
+            const row = self.pixels[y * self.width ..][0..self.width];
+            if (y >= mid.y0 and y < mid.y1) {
+                fillSpan(row[limit.x0..limit.x1], color);
+                continue;
+            }
+            shape.cover(row, limit.x0, mid.x0, y, color);
+            fillSpan(row[mid.x0..mid.x1], color);
+            shape.cover(row, mid.x1, limit.x1, y, color);
+        }
+    }
+
+    fn renderRoundedStroke(self: *SoftwareBackend, r: DrawPrimitive.StrokeRect, clip: ?Rect, region: PixelBox) void {
+        const limit = (self.pixelBox(r.rect, clip) orelse return).intersect(region);
+        if (limit.isEmpty()) return;
+
+        const color = colorToARGB(r.color);
+        const stroke = strokeWidth(r.stroke_width);
+        const s: i32 = @intCast(stroke);
+        const sw: f32 = @floatFromInt(stroke);
+        const radius = clampRadius(r.rect, r.corner_radius);
+
+        // Band inside the outer rounded rect and outside the inner one
+        const inner = Rect{
+            .x = r.rect.x + sw,
+            .y = r.rect.y + sw,
+            .width = r.rect.width - 2 * sw,
+            .height = r.rect.height - 2 * sw,
+        };
+        const shape = RoundedShape{
+            .rect = r.rect,
+            .radius = radius,
+            .hole = if (inner.width > 0 and inner.height > 0) inner else null,
+            .hole_radius = @max(0, radius - sw),
+        };
+
+        // Whole pixels of the rect
+        const x0: i32 = @intFromFloat(@floor(r.rect.x));
+        const y0: i32 = @intFromFloat(@floor(r.rect.y));
+        const x1: i32 = @intFromFloat(@floor(r.rect.x + r.rect.width));
+        const y1: i32 = @intFromFloat(@floor(r.rect.y + r.rect.height));
+
+        // Corner blocks are at least stroke-sized, so the four straight
+        // edges meet only inside them and never overlap
+        var cols = cornerSplit(r.rect.x, r.rect.width, @max(radius, sw));
+        var rows = cornerSplit(r.rect.y, r.rect.height, @max(radius, sw));
+        cols[1] = @max(cols[0], @min(cols[1], x1 - s));
+        rows[1] = @max(rows[0], @min(rows[1], y1 - s));
+
+        // Top, bottom, left, right
+        self.fillBox(intBox(cols[0], y0, cols[1], y0 + s), color, limit);
+        self.fillBox(intBox(cols[0], @max(y1 - s, y0 + s), cols[1], y1), color, limit);
+        self.fillBox(intBox(x0, rows[0], x0 + s, rows[1]), color, limit);
+        self.fillBox(intBox(@max(x1 - s, x0 + s), rows[0], x1, rows[1]), color, limit);
+
+        const mid = splitBox(cols, rows, limit);
+        var y = limit.y0;
+        while (y < limit.y1) : (y += 1) {
+            if (y >= mid.y0 and y < mid.y1) continue;
+            const row = self.pixels[y * self.width ..][0..self.width];
+            shape.cover(row, limit.x0, mid.x0, y, color);
+            shape.cover(row, mid.x1, limit.x1, y, color);
+        }
+    }
+
+    /// A rounded rect, optionally minus a rounded hole (strokes)
+    const RoundedShape = struct {
+        rect: Rect,
+        radius: f32,
+        hole: ?Rect = null,
+        hole_radius: f32 = 0,
+
+        /// Blend `color` over row[x0..x1], weighted by coverage
+        fn cover(self: RoundedShape, row: []u32, x0: u32, x1: u32, y: u32, color: u32) void {
+            const py = @as(f32, @floatFromInt(y)) + 0.5;
+            const alpha: f32 = @floatFromInt(color >> 24);
+            var x = x0;
+            while (x < x1) : (x += 1) {
+                const px = @as(f32, @floatFromInt(x)) + 0.5;
+                var coverage = edgeCoverage(px, py, self.rect, self.radius);
+                if (self.hole) |hole| coverage -= edgeCoverage(px, py, hole, self.hole_radius);
+                if (coverage <= 0) continue;
+
+                const a: u32 = @intFromFloat(@round(alpha * @min(coverage, 1)));
+                fillSpan(row[x..][0..1], (a << 24) | (color & 0x00FFFFFF));
+            }
+        }
+
+        /// Area of the pixel at (px, py) inside the rounded rect, from its
+        /// signed distance to the edge (0.5 px ramp either side)
+        fn edgeCoverage(px: f32, py: f32, rect: Rect, radius: f32) f32 {
+            const half_w = rect.width / 2;
+            const half_h = rect.height / 2;
+            const qx = @abs(px - (rect.x + half_w)) - half_w + radius;
+            const qy = @abs(py - (rect.y + half_h)) - half_h + radius;
+            const ox = @max(qx, 0);
+            const oy = @max(qy, 0);
+            const distance = @sqrt(ox * ox + oy * oy) + @min(@max(qx, qy), 0) - radius;
+            return std.math.clamp(0.5 - distance, 0, 1);
+        }
+    };
+
+    fn clampRadius(rect: Rect, radius: f32) f32 {
+        return @max(0, @min(radius, @min(rect.width, rect.height) / 2));
+    }
+
+    /// First and one-past-last pixel whose center lies between the corner
+    /// circles' centers along one axis
+    fn cornerSplit(start: f32, size: f32, radius: f32) [2]i32 {
+        const first: i32 = @intFromFloat(@ceil(start + radius - 0.5));
+        const end: i32 = @intFromFloat(@floor(start + size - radius - 0.5) + 1);
+        return .{ first, @max(first, end) };
+    }
+
+    /// Corner split clamped into `limit`
+    fn splitBox(cols: [2]i32, rows: [2]i32, limit: PixelBox) PixelBox {
+        const x0 = clampInto(cols[0], limit.x0, limit.x1);
+        const y0 = clampInto(rows[0], limit.y0, limit.y1);
+        return .{
+            .x0 = x0,
+            .y0 = y0,
+            .x1 = clampInto(cols[1], x0, limit.x1),
+            .y1 = clampInto(rows[1], y0, limit.y1),
+        };
+    }
+
+    fn clampInto(v: i32, lo: u32, hi: u32) u32 {
+        return @intCast(std.math.clamp(v, @as(i32, @intCast(lo)), @as(i32, @intCast(hi))));
+    }
+
+    /// Pixel box from signed bounds (negative parts dropped)
+    fn intBox(x0: i32, y0: i32, x1: i32, y1: i32) PixelBox {
+        return .{
+            .x0 = @intCast(@max(x0, 0)),
+            .y0 = @intCast(@max(y0, 0)),
+            .x1 = @intCast(@max(x1, 0)),
+            .y1 = @intCast(@max(y1, 0)),
+        };
+    }
+
+    fn renderLine(self: *SoftwareBackend, l: DrawPrimitive.LineDraw, clip: ?Rect, region: PixelBox) void {
         _ = clip; // TODO: proper line clipping
 
         const color = colorToARGB(l.color);
@@ -678,8 +1625,13 @@ pub const SoftwareBackend = struct {
         var x = x0_i;
         var y = y0_i;
 
+        const region_x0: i32 = @intCast(region.x0);
+        const region_y0: i32 = @intCast(region.y0);
+        const region_x1: i32 = @intCast(region.x1);
+        const region_y1: i32 = @intCast(region.y1);
+
         while (true) {
-            if (x >= 0 and y >= 0 and x < @as(i32, @intCast(self.width)) and y < @as(i32, @intCast(self.height))) {
+            if (x >= region_x0 and y >= region_y0 and x < region_x1 and y < region_y1) {
                 self.blendPixel(@intCast(x), @intCast(y), color);
             }
 
@@ -725,55 +1677,51 @@ pub const SoftwareBackend = struct {
         return @min(yi, self.height);
     }
 
-    fn fillHorizontalLine(self: *SoftwareBackend, x0: u32, x1: u32, y: u32, thickness: u32, color: u32) void {
-        var yi = y;
-        const y_end = @min(y + thickness, self.height);
-        while (yi < y_end) : (yi += 1) {
-            var xi = x0;
-            while (xi < x1) : (xi += 1) {
-                self.blendPixel(xi, yi, color);
-            }
-        }
+    /// Whole framebuffer as a region
+    fn screenBox(self: *SoftwareBackend) PixelBox {
+        return .{ .x0 = 0, .y0 = 0, .x1 = self.width, .y1 = self.height };
     }
 
-    fn fillVerticalLine(self: *SoftwareBackend, x: u32, y0: u32, y1: u32, thickness: u32, color: u32) void {
-        var xi = x;
-        const x_end = @min(x + thickness, self.width);
-        while (xi < x_end) : (xi += 1) {
-            var yi = y0;
-            while (yi < y1) : (yi += 1) {
-                self.blendPixel(xi, yi, color);
-            }
+    /// Clipped, screen-clamped pixel box of a rect; null if the clipped rect
+    /// is empty (the box itself may still be, after truncation)
+    fn pixelBox(self: *SoftwareBackend, rect: Rect, clip: ?Rect) ?PixelBox {
+        const bounds = self.clipRect(rect, clip);
+        if (bounds.width <= 0 or bounds.height <= 0) return null;
+        return .{
+            .x0 = self.clampX(bounds.x),
+            .y0 = self.clampY(bounds.y),
+            .x1 = self.clampX(bounds.x + bounds.width),
+            .y1 = self.clampY(bounds.y + bounds.height),
+        };
+    }
+
+    fn strokeWidth(width: f32) u32 {
+        return @max(1, @as(u32, @intFromFloat(width)));
+    }
+
+    fn fillHorizontalLine(self: *SoftwareBackend, x0: u32, x1: u32, y: u32, thickness: u32, color: u32, region: PixelBox) void {
+        self.fillBox(.{ .x0 = x0, .y0 = y, .x1 = x1, .y1 = y + thickness }, color, region);
+    }
+
+    fn fillVerticalLine(self: *SoftwareBackend, x: u32, y0: u32, y1: u32, thickness: u32, color: u32, region: PixelBox) void {
+        self.fillBox(.{ .x0 = x, .y0 = y0, .x1 = x + thickness, .y1 = y1 }, color, region);
+    }
+
+    /// Fill the part of `box` inside `region`, one span per row
+    fn fillBox(self: *SoftwareBackend, box: PixelBox, color: u32, region: PixelBox) void {
+        const clipped = box.intersect(region);
+        if (clipped.isEmpty()) return;
+
+        const row_width = clipped.x1 - clipped.x0;
+        var y = clipped.y0;
+        while (y < clipped.y1) : (y += 1) {
+            fillSpan(self.pixels[y * self.width + clipped.x0 ..][0..row_width], color);
         }
     }
 
     fn blendPixel(self: *SoftwareBackend, x: u32, y: u32, color: u32) void {
         if (x >= self.width or y >= self.height) return;
-
-        const idx = y * self.width + x;
-        const src_a = (color >> 24) & 0xFF;
-
-        if (src_a == 255) {
-            // Fully opaque - just write
-            self.pixels[idx] = color;
-        } else if (src_a > 0) {
-            // Alpha blend
-            const dst = self.pixels[idx];
-            const dst_r = (dst >> 16) & 0xFF;
-            const dst_g = (dst >> 8) & 0xFF;
-            const dst_b = dst & 0xFF;
-
-            const src_r = (color >> 16) & 0xFF;
-            const src_g = (color >> 8) & 0xFF;
-            const src_b = color & 0xFF;
-
-            const inv_a = 255 - src_a;
-            const out_r = (src_r * src_a + dst_r * inv_a) / 255;
-            const out_g = (src_g * src_a + dst_g * inv_a) / 255;
-            const out_b = (src_b * src_a + dst_b * inv_a) / 255;
-
-            self.pixels[idx] = 0xFF000000 | (out_r << 16) | (out_g << 8) | out_b;
-        }
+        fillSpan(self.pixels[y * self.width + x ..][0..1], color);
     }
 
     // === Image output ===
@@ -892,6 +1840,35 @@ test "DrawList clip stack" {
     try std.testing.expectEqual(@as(?Rect, null), draw_list.currentClip());
 }
 
+test "DrawList culls primitives outside the clip" {
+    const allocator = std.testing.allocator;
+    var draw_list = DrawList.init(allocator);
+    defer draw_list.deinit();
+
+    // Viewport of a scrolled pane: rows above and below it are dropped
+    draw_list.pushClip(.{ .x = 0, .y = 100, .width = 200, .height = 100 });
+    var y: f32 = 0;
+    while (y < 400) : (y += 20) {
+        draw_list.addFilledRect(.{ .x = 0, .y = y, .width = 200, .height = 20 }, Color.fromRGB(40, 40, 40));
+        draw_list.addText(.{ .x = 4, .y = y + 15 }, "line", Color.fromRGB(255, 255, 255));
+    }
+    draw_list.addLine(.{ .x = 0, .y = 50 }, .{ .x = 200, .y = 50 }, Color.fromRGB(255, 0, 0), 2);
+    draw_list.popClip();
+
+    // 5 rows intersect [100, 200); the text line box (baseline - font size,
+    // two sizes tall) keeps one extra label above the viewport
+    var rects: usize = 0;
+    for (draw_list.getCommands()) |cmd| {
+        if (cmd.primitive == .fill_rect) rects += 1;
+    }
+    try std.testing.expectEqual(@as(usize, 5), rects);
+    try std.testing.expectEqual(@as(usize, 11), draw_list.commandCount());
+    try std.testing.expectEqual(@as(u32, 30), draw_list.culled_count);
+
+    // No clip: nothing is culled
+    try std.testing.expect(draw_list.isVisible(.{ .x = -1000, .y = -1000, .width = 1, .height = 1 }));
+}
+
 test "DrawList layer stack" {
     const allocator = std.testing.allocator;
     var draw_list = DrawList.init(allocator);
@@ -937,6 +1914,57 @@ test "DrawList commands include clip and layer" {
     try std.testing.expectEqual(@as(u16, 1), commands[1].layer);
 }
 
+test "DrawList finalize sorts by layer and batches" {
+    const allocator = std.testing.allocator;
+    var draw_list = DrawList.init(allocator);
+    defer draw_list.deinit();
+
+    // widget_id tags submission order; layers interleave, one above 255
+    const Entry = struct { layer: u16, stroke: bool };
+    const entries = [_]Entry{
+        .{ .layer = 0, .stroke = false },
+        .{ .layer = 2, .stroke = false },
+        .{ .layer = 0, .stroke = false },
+        .{ .layer = 300, .stroke = true },
+        .{ .layer = 2, .stroke = true },
+        .{ .layer = 0, .stroke = true },
+        .{ .layer = 1, .stroke = false },
+        .{ .layer = 2, .stroke = true },
+    };
+    for (entries, 0..) |entry, i| {
+        draw_list.pushLayerAbove(entry.layer);
+        const rect = Rect{ .x = 0, .y = 0, .width = 10, .height = 10 };
+        if (entry.stroke) draw_list.addStrokeRect(rect, Color.fromRGB(0, 0, 0), 1) else draw_list.addFilledRect(rect, Color.fromRGB(0, 0, 0));
+        draw_list.popLayer();
+        draw_list.commands.items[i].widget_id = @intCast(i);
+    }
+    try std.testing.expectEqual(@as(usize, 0), draw_list.getBatches().len);
+
+    draw_list.finalize();
+    const commands = draw_list.getCommands();
+    const expected_ids = [_]u32{ 0, 2, 5, 6, 1, 4, 7, 3 };
+    for (commands, expected_ids) |cmd, id| try std.testing.expectEqual(id, cmd.widget_id);
+
+    // fill x2 + stroke (0), fill (1), fill + stroke x2 (2), stroke (300)
+    const batches = draw_list.getBatches();
+    const expected_counts = [_]u32{ 2, 1, 1, 1, 2, 1 };
+    try std.testing.expectEqual(expected_counts.len, batches.len);
+    for (batches, expected_counts) |batch, count| try std.testing.expectEqual(count, batch.count);
+    try std.testing.expectEqual(@as(u16, 300), batches[5].layer);
+    try std.testing.expect(batches[4].kind == .stroke_rect);
+    try std.testing.expectEqual(@as(u32, 7), batches[5].start);
+
+    // A different clip starts a new batch
+    draw_list.pushClip(.{ .x = 0, .y = 0, .width = 5, .height = 5 });
+    draw_list.pushLayerAbove(300);
+    draw_list.addStrokeRect(.{ .x = 0, .y = 0, .width = 10, .height = 10 }, Color.fromRGB(0, 0, 0), 1);
+    draw_list.popLayer();
+    draw_list.popClip();
+    try std.testing.expectEqual(@as(usize, 0), draw_list.getBatches().len);
+    draw_list.finalize();
+    try std.testing.expectEqual(@as(usize, 7), draw_list.getBatches().len);
+}
+
 test "rectIntersect" {
     // Overlapping rectangles
     const a = Rect{ .x = 0, .y = 0, .width = 100, .height = 100 };
@@ -979,6 +2007,19 @@ test "NullBackend" {
 
     try std.testing.expectEqual(@as(u32, 1), backend.render_count);
     try std.testing.expectEqual(@as(usize, 2), backend.last_command_count);
+    try std.testing.expectEqual(@as(usize, 2), backend.last_batch_count);
+
+    // Unfinalized data is counted back to front: the layer-1 fill last
+    draw_list.pushLayer();
+    draw_list.addFilledRect(.{ .x = 0, .y = 0, .width = 10, .height = 10 }, Color.fromRGB(0, 0, 255));
+    draw_list.popLayer();
+    draw_list.addFilledRect(.{ .x = 0, .y = 0, .width = 10, .height = 10 }, Color.fromRGB(0, 255, 0));
+    const layered = DrawData{
+        .commands = draw_list.getCommands(),
+        .display_size = .{ .width = 800, .height = 600 },
+    };
+    iface.render(&layered);
+    try std.testing.expectEqual(@as(usize, 4), backend.last_batch_count);
 
     // Test measureText
     const text_size = iface.measureText("Hello", 14.0, 0);
@@ -994,6 +2035,38 @@ test "colorToARGB" {
     try std.testing.expectEqual(@as(u32, 0xC8FF8040), argb);
 }
 
+test "fillSpan blends to the rounded quotient by 255" {
+    // Not a multiple of SPAN_LANES: exercises the vector body and the tail
+    var span: [2 * SPAN_LANES + 5]u32 = undefined;
+
+    var a: u32 = 1;
+    while (a < 255) : (a += 1) {
+        const src = (a << 24) | ((a * 7) & 0xFF) << 16 | ((255 - a) << 8) | ((a * 131) & 0xFF);
+        for (&span, 0..) |*dst, i| {
+            const v: u32 = @intCast((i * 37 + a) & 0xFF);
+            dst.* = (a << 24) | (v << 16) | ((255 - v) << 8) | ((v * 3) & 0xFF);
+        }
+        const before = span;
+        fillSpan(&span, src);
+
+        for (before, span) |dst, out| {
+            try std.testing.expectEqual(@as(u32, 0xFF), out >> 24);
+            inline for (.{ 16, 8, 0 }) |shift| {
+                const s = (src >> shift) & 0xFF;
+                const d = (dst >> shift) & 0xFF;
+                const exact = s * a + d * (255 - a);
+                try std.testing.expectEqual((2 * exact + 255) / 510, (out >> shift) & 0xFF);
+            }
+        }
+    }
+
+    // Opaque is a copy, transparent a no-op
+    fillSpan(&span, 0xFF123456);
+    try std.testing.expectEqual(@as(u32, 0xFF123456), span[span.len - 1]);
+    fillSpan(&span, 0x00FFFFFF);
+    try std.testing.expectEqual(@as(u32, 0xFF123456), span[0]);
+}
+
 test "DrawData isEmpty" {
     const empty_data = DrawData{
         .commands = &[_]DrawCommand{},
@@ -1160,6 +2233,55 @@ test "SoftwareBackend respects clipping" {
     try std.testing.expectEqual(@as(u32, 0xFF000000), outside_clip);
 }
 
+test "SoftwareBackend draws higher layers on top" {
+    const allocator = std.testing.allocator;
+
+    var draw_list = DrawList.init(allocator);
+    defer draw_list.deinit();
+
+    // A popup recorded mid-tree, then the rest of the page over its area
+    draw_list.addFilledRect(.{ .x = 0, .y = 0, .width = 60, .height = 40 }, Color.fromRGB(40, 40, 40));
+    draw_list.pushLayer();
+    draw_list.addFilledRect(.{ .x = 10, .y = 10, .width = 30, .height = 20 }, Color.fromRGB(255, 0, 0));
+    draw_list.addStrokeRect(.{ .x = 10, .y = 10, .width = 30, .height = 20 }, Color.fromRGB(255, 255, 255), 1);
+    draw_list.popLayer();
+    draw_list.addFilledRect(.{ .x = 0, .y = 15, .width = 60, .height = 10 }, Color.fromRGB(0, 0, 255));
+
+    // Unsorted, walked in layer order
+    const unsorted = DrawData{
+        .commands = draw_list.getCommands(),
+        .display_size = .{ .width = 60, .height = 40 },
+    };
+    var reference = try SoftwareBackend.initAlloc(allocator, 60, 40);
+    defer reference.deinit(allocator);
+    reference.interface().beginFrame(&unsorted);
+    reference.interface().render(&unsorted);
+    reference.interface().endFrame();
+    try std.testing.expectEqual(@as(u32, 0xFFFF0000), reference.getPixel(20, 20));
+    try std.testing.expectEqual(@as(u32, 0xFF0000FF), reference.getPixel(5, 20));
+    try std.testing.expectEqual(@as(u32, 0xFFFFFFFF), reference.getPixel(10, 20));
+
+    // Sorted and batched, serial, tiled and retained: same pixels
+    draw_list.finalize();
+    const finalized = DrawData{
+        .commands = draw_list.getCommands(),
+        .batches = draw_list.getBatches(),
+        .display_size = .{ .width = 60, .height = 40 },
+    };
+    const pool = try thread_pool.Pool.init(allocator, .{ .thread_count = 2 });
+    defer pool.deinit();
+    for (0..3) |mode| {
+        var backend = try SoftwareBackend.initAlloc(allocator, 60, 40);
+        defer backend.deinit(allocator);
+        if (mode == 1) backend.enableTiling(allocator, pool, 16);
+        if (mode == 2) backend.enableRetained(allocator);
+        backend.interface().beginFrame(&finalized);
+        backend.interface().render(&finalized);
+        backend.interface().endFrame();
+        try std.testing.expectEqualSlices(u32, reference.pixels, backend.pixels);
+    }
+}
+
 test "SoftwareBackend alpha blending" {
     const allocator = std.testing.allocator;
     var backend = try SoftwareBackend.initAlloc(allocator, 100, 100);
@@ -1270,3 +2392,191 @@ test "SoftwareBackend end-to-end with multiple primitives" {
     const line_pixel = backend.getPixel(100, 80);
     try std.testing.expectEqual(@as(u32, 0xFFC8C8C8), line_pixel);
 }
+
+test "SoftwareBackend rounds rectangle corners" {
+    const allocator = std.testing.allocator;
+    var backend = try SoftwareBackend.initAlloc(allocator, 100, 100);
+    defer backend.deinit(allocator);
+
+    var draw_list = DrawList.init(allocator);
+    defer draw_list.deinit();
+
+    draw_list.addFilledRectEx(.{ .x = 10, .y = 10, .width = 30, .height = 20 }, Color.fromRGB(255, 255, 255), 6);
+    draw_list.addStrokeRectEx(.{ .x = 50, .y = 10, .width = 40, .height = 30 }, Color.fromRGB(255, 255, 255), 2, 8);
+
+    const draw_data = DrawData{
+        .commands = draw_list.getCommands(),
+        .display_size = .{ .width = 100, .height = 100 },
+    };
+    const iface = backend.interface();
+    iface.beginFrame(&draw_data);
+    iface.render(&draw_data);
+    iface.endFrame();
+
+    const black: u32 = 0xFF000000;
+    const white: u32 = 0xFFFFFFFF;
+
+    // Fill: corner cut away, edges and interior solid, arc anti-aliased
+    try std.testing.expectEqual(black, backend.getPixel(10, 10));
+    try std.testing.expectEqual(white, backend.getPixel(25, 10));
+    try std.testing.expectEqual(white, backend.getPixel(10, 20));
+    try std.testing.expectEqual(white, backend.getPixel(25, 20));
+    const arc = backend.getPixel(11, 11) & 0xFF;
+    try std.testing.expect(arc > 0 and arc < 255);
+
+    // Stroke: same for the outline, interior untouched
+    try std.testing.expectEqual(black, backend.getPixel(50, 10));
+    try std.testing.expectEqual(white, backend.getPixel(70, 11));
+    try std.testing.expectEqual(white, backend.getPixel(51, 25));
+    try std.testing.expectEqual(black, backend.getPixel(70, 25));
+    try std.testing.expectEqual(black, backend.getPixel(54, 14));
+    const outline_arc = backend.getPixel(52, 12) & 0xFF;
+    try std.testing.expect(outline_arc > 0 and outline_arc < 255);
+}
+
+test "SoftwareBackend tiled rendering matches serial" {
+    const allocator = std.testing.allocator;
+
+    // Not a multiple of the tile size, so edge tiles are partial
+    const width = 100;
+    const height = 70;
+
+    var draw_list = DrawList.init(allocator);
+    defer draw_list.deinit();
+
+    // Translucent overlaps, strokes thicker than their box, fractional
+    // coordinates, lines crossing tiles and a clipped group
+    for (0..12) |i| {
+        const f: f32 = @floatFromInt(i);
+        draw_list.addFilledRect(
+            .{ .x = f * 7.5 - 10, .y = f * 4.25, .width = 37.5, .height = 23.7 },
+            Color.fromRGBA(@intCast(i * 20), 90, @intCast(240 - i * 20), if (i % 3 == 0) 255 else 96),
+        );
+        draw_list.addStrokeRect(
+            .{ .x = f * 8.3, .y = 60 - f * 5, .width = 14 - f, .height = 9.5 },
+            Color.fromRGBA(255, 255, 255, 160),
+            if (i % 2 == 0) 3 else 1,
+        );
+        draw_list.addLine(.{ .x = f * 9, .y = 0 }, .{ .x = 99 - f * 4, .y = 69 }, Color.fromRGBA(0, 255, 0, 200), 1);
+    }
+    draw_list.addFilledRectEx(.{ .x = 5.5, .y = 30, .width = 60, .height = 33 }, Color.fromRGBA(40, 200, 90, 180), 12);
+    draw_list.addStrokeRectEx(.{ .x = 12, .y = 8.25, .width = 70, .height = 50 }, Color.fromRGBA(255, 200, 0, 140), 3, 9);
+    draw_list.pushClip(.{ .x = 30.5, .y = 15, .width = 33, .height = 40.2 });
+    draw_list.addFilledRect(.{ .x = 0, .y = 0, .width = 100, .height = 70 }, Color.fromRGBA(255, 0, 0, 64));
+    draw_list.addFilledRectEx(.{ .x = 25, .y = 10, .width = 30, .height = 30 }, Color.fromRGB(0, 0, 255), 15);
+    draw_list.addStrokeRect(.{ .x = 31, .y = 16, .width = 1, .height = 1 }, Color.fromRGB(255, 255, 0), 4);
+    draw_list.popClip();
+
+    const draw_data = DrawData{
+        .commands = draw_list.getCommands(),
+        .display_size = .{ .width = width, .height = height },
+    };
+
+    var serial = try SoftwareBackend.initAlloc(allocator, width, height);
+    defer serial.deinit(allocator);
+    serial.clear_color = 0xFF203040;
+    serial.interface().beginFrame(&draw_data);
+    serial.interface().render(&draw_data);
+    serial.interface().endFrame();
+
+    const pool = try thread_pool.Pool.init(allocator, .{ .thread_count = 4 });
+    defer pool.deinit();
+
+    var tiled = try SoftwareBackend.initAlloc(allocator, width, height);
+    defer tiled.deinit(allocator);
+    tiled.clear_color = 0xFF203040;
+    tiled.enableTiling(allocator, pool, 16);
+
+    // Twice: the second frame reuses the bins
+    for (0..2) |_| {
+        @memset(tiled.pixels, 0);
+        tiled.interface().beginFrame(&draw_data);
+        tiled.interface().render(&draw_data);
+        tiled.interface().endFrame();
+        try std.testing.expectEqualSlices(u32, serial.pixels, tiled.pixels);
+    }
+
+    // A frame with nothing to render still clears
+    const empty = DrawData{ .commands = &.{}, .display_size = .{ .width = width, .height = height } };
+    tiled.interface().beginFrame(&empty);
+    tiled.interface().endFrame();
+    try std.testing.expectEqual(@as(u32, 0xFF203040), tiled.getPixel(50, 35));
+}
+
+test "SoftwareBackend retained mode repaints only what changed" {
+    const allocator = std.testing.allocator;
+    const width = 120;
+    const height = 80;
+
+    var retained = try SoftwareBackend.initAlloc(allocator, width, height);
+    defer retained.deinit(allocator);
+    retained.enableRetained(allocator);
+
+    var reference = try SoftwareBackend.initAlloc(allocator, width, height);
+    defer reference.deinit(allocator);
+
+    var draw_list = DrawList.init(allocator);
+    defer draw_list.deinit();
+
+    const Frame = struct {
+        hover: bool = false,
+        moved: bool = false,
+        swapped: bool = false,
+    };
+    const frames = [_]Frame{
+        .{},
+        .{},
+        .{ .hover = true },
+        .{ .hover = true },
+        .{ .hover = true, .moved = true, .swapped = true },
+        .{ .hover = true },
+    };
+
+    for (frames, 0..) |frame, n| {
+        // A panel, two overlapping translucent cards and a row of buttons
+        draw_list.clear();
+        draw_list.addFilledRectEx(.{ .x = 4, .y = 4, .width = 112, .height = 72 }, Color.fromRGB(40, 40, 50), 6);
+        const cards = [_]Rect{
+            .{ .x = 10, .y = 10, .width = 40, .height = 30 },
+            .{ .x = if (frame.moved) 35 else 30, .y = 20, .width = 40, .height = 30 },
+        };
+        const card_colors = [_]Color{ Color.fromRGBA(255, 0, 0, 128), Color.fromRGBA(0, 0, 255, 128) };
+        const order = if (frame.swapped) [_]usize{ 1, 0 } else [_]usize{ 0, 1 };
+        for (order) |i| draw_list.addFilledRect(cards[i], card_colors[i]);
+        for (0..4) |i| {
+            const x: f32 = @floatFromInt(10 + i * 26);
+            const hovered = frame.hover and i == 2;
+            draw_list.addFilledRectEx(.{ .x = x, .y = 56, .width = 22, .height = 14 }, if (hovered) Color.fromRGB(90, 90, 140) else Color.fromRGB(50, 50, 80), 3);
+            draw_list.addStrokeRect(.{ .x = x, .y = 56, .width = 22, .height = 14 }, Color.fromRGBA(255, 255, 255, 60), 1);
+        }
+
+        const draw_data = DrawData{
+            .commands = draw_list.getCommands(),
+            .display_size = .{ .width = width, .height = height },
+        };
+        for ([_]*SoftwareBackend{ &retained, &reference }) |backend| {
+            backend.interface().beginFrame(&draw_data);
+            backend.interface().render(&draw_data);
+            backend.interface().endFrame();
+        }
+        try std.testing.expectEqualSlices(u32, reference.pixels, retained.pixels);
+
+        const damage_rects = retained.getDamage();
+        switch (n) {
+            // First frame: everything
+            0 => try std.testing.expectEqualSlices(Rect, &.{.{ .x = 0, .y = 0, .width = width, .height = height }}, damage_rects),
+            // Unchanged: nothing
+            1, 3 => try std.testing.expectEqual(@as(usize, 0), damage_rects.len),
+            // Hover: just that button
+            2 => try std.testing.expectEqualSlices(Rect, &.{.{ .x = 62, .y = 56, .width = 22, .height = 14 }}, damage_rects),
+            // Moved and reordered cards: old and new boxes, nothing below
+            else => for (damage_rects) |rect| try std.testing.expect(rect.y + rect.height <= 56),
+        }
+    }
+
+    // An empty frame clears
+    const empty = DrawData{ .commands = &.{}, .display_size = .{ .width = width, .height = height } };
+    retained.interface().beginFrame(&empty);
+    retained.interface().endFrame();
+    try std.testing.expectEqual(@as(u32, 0xFF000000), retained.getPixel(60, 40));
+}
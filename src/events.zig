@@ -232,6 +232,9 @@ pub const EventManager = struct {
     // Text input accumulator (cleared each frame)
     text_buffer: std.ArrayList(u8),
 
+    // Wheel/trackpad movement accumulated this frame (+y = away from the user)
+    scroll_delta: Point = .{ .x = 0, .y = 0 },
+
     // Widget focus tracking (by ID hash, not pointer)
     focused_widget: ?u64 = null,
 
@@ -267,8 +270,9 @@ pub const EventManager = struct {
 
     /// Process all queued input events and update current state
     pub fn processEvents(self: *EventManager) void {
-        // Clear text buffer from previous frame
+        // Clear text buffer and scroll delta from previous frame
         self.text_buffer.clearRetainingCapacity();
+        self.scroll_delta = .{ .x = 0, .y = 0 };
 
         // Process raw input events and update state
         for (self.input_events.items) |event| {
@@ -297,8 +301,9 @@ pub const EventManager = struct {
                     // TODO: Implement touch event handling
                 },
                 .scroll => |scroll_event| {
-                    _ = scroll_event;
-                    // TODO: Implement scroll event handling
+                    self.mouse_position = scroll_event.position;
+                    self.scroll_delta.x += scroll_event.delta_x;
+                    self.scroll_delta.y += scroll_event.delta_y;
                 },
                 .text => |text_event| {
                     self.text_buffer.appendSlice(text_event.text) catch {
@@ -350,6 +355,11 @@ pub const EventManager = struct {
         return self.modifiers;
     }
 
+    /// Get scroll movement from this frame (for scroll containers)
+    pub inline fn getScrollDelta(self: *const EventManager) Point {
+        return self.scroll_delta;
+    }
+
     /// Get text input from this frame (for text input widgets)
     pub inline fn getTextInput(self: *const EventManager) []const u8 {
         return self.text_buffer.items;
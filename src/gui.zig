@@ -8,21 +8,35 @@ const Size = @import("core/geometry.zig").Size;
 const Paint = @import("core/paint.zig").Paint;
 const LayoutEngine = @import("layout.zig").LayoutEngine;
 const FlexStyle = @import("layout.zig").FlexStyle;
+const SpatialGrid = @import("layout.zig").SpatialGrid;
 const StyleSystem = @import("style.zig").StyleSystem;
 const EventManager = @import("events.zig").EventManager;
 const AnimationSystem = @import("animation.zig").AnimationSystem;
 const AssetManager = @import("asset.zig").AssetManager;
 const WidgetId = @import("widget_id.zig").WidgetId;
 const IdStack = @import("widget_id.zig").IdStack;
+const VirtualList = @import("components/list.zig").VirtualList;
 const profiler = @import("profiler.zig");
 
 // Draw system imports
 const draw = @import("draw.zig");
 const DrawList = draw.DrawList;
 const DrawData = draw.DrawData;
+const RenderBackend = draw.RenderBackend;
 
-/// Maximum number of widgets (matches layout engine)
-const MAX_WIDGETS = @import("layout/engine.zig").MAX_ELEMENTS;
+/// Font size used for immediate-mode text (matches DrawList.addText)
+const IM_FONT_SIZE: f32 = 14;
+
+/// Fallback text advance when no backend measures text
+const FALLBACK_CHAR_WIDTH: f32 = 8;
+
+/// Memoized text sizes kept before the memo is flushed (bounds memory for
+/// UIs that show a stream of unique strings, e.g. log viewers)
+const TEXT_SIZE_CACHE_MAX: u32 = 4096;
+
+/// Hit-test order of immediate widgets: above every layout node (whose
+/// order is its depth) on the same layer, then in call order
+const IM_HIT_ORDER_BASE: u32 = 1 << 31;
 
 /// Widget type enumeration for metadata
 const WidgetType = enum(u8) {
@@ -37,11 +51,21 @@ const WidgetType = enum(u8) {
 
 /// Metadata for each widget (for reconciliation)
 const WidgetMeta = struct {
+    widget_hash: u32 = 0, // This widget's ID hash (0 = root / unused slot)
+    generation: u32 = 0, // Last frame the widget was declared in
     parent_hash: u32 = 0, // Parent's widget ID hash
-    sibling_order: u16 = 0, // Position among siblings
+    sibling_order: u16 = 0, // Position among siblings as declared this frame
     widget_type: WidgetType = .root,
+
+    // As a parent: walk of the layout child list alongside declarations
+    reorder_pending: bool = false, // Children declared out of layout order
+    child_counter: u16 = 0, // Children declared so far this frame
+    child_generation: u32 = 0, // Frame the two fields around it belong to
+    child_cursor: u32 = NO_CHILD, // Layout child expected next
 };
 
+const NO_CHILD: u32 = std.math.maxInt(u32);
+
 /// Configuration options for GUI initialization
 pub const GUIConfig = struct {
     /// Window dimensions for rendering context (if applicable)
@@ -118,6 +142,7 @@ pub const GUI = struct {
     im_line_height: f32 = 24,
     im_padding: f32 = 8,
     im_spacing: f32 = 4,
+    im_scroll_step: f32 = 40, // Pixels per wheel notch
 
     /// Mouse state (updated by platform)
     im_mouse_x: f32 = 0,
@@ -125,8 +150,15 @@ pub const GUI = struct {
     im_mouse_down: bool = false,
     im_mouse_was_down: bool = false,
 
+    /// Wheel input accumulated this frame, in notches (+y = away from the user)
+    im_scroll_x: f32 = 0,
+    im_scroll_y: f32 = 0,
+    /// Innermost scroll container under the mouse (takes this frame's wheel input)
+    im_scroll_target: ?u32 = null,
+
     /// Widget interaction state
     im_hot_id: u64 = 0, // Widget currently under mouse
+    im_hover_id: u32 = 0, // Topmost widget under the mouse per the hit index
     im_active_id: u64 = 0, // Widget being interacted with
     im_clicked_id: u64 = 0, // Widget clicked this frame (0 = none)
 
@@ -140,11 +172,25 @@ pub const GUI = struct {
     /// Widget ID → Layout index mapping (persistent across frames)
     widget_to_layout: std.AutoHashMap(u32, u32),
 
-    /// Layout index → Widget metadata (for parent tracking, reordering)
-    widget_meta: [MAX_WIDGETS]WidgetMeta = [_]WidgetMeta{.{}} ** MAX_WIDGETS,
+    /// Layout index → Widget metadata (for parent tracking, reordering).
+    /// Dense slot table sized to the layout engine's capacity (see
+    /// syncWidgetCapacity). A widget is "seen" when its generation equals
+    /// frame_index, so endFrame finds stale widgets with one compare per slot.
+    widget_meta: std.ArrayListUnmanaged(WidgetMeta) = .{},
+
+    /// Current frame generation (stamped into widget_meta as widgets are declared)
+    frame_index: u32 = 0,
+
+    /// Per-frame scratch memory, reset in beginFrame (capacity is kept, so
+    /// steady-state frames do not touch the heap)
+    frame_arena: std.heap.ArenaAllocator,
 
-    /// Which layout indices were "seen" this frame
-    seen_this_frame: std.StaticBitSet(MAX_WIDGETS) = std.StaticBitSet(MAX_WIDGETS).initEmpty(),
+    /// Parents whose children were declared in a new order this frame
+    /// (frame arena; applied in endFrame)
+    reorder_parents: std.ArrayListUnmanaged(u32) = .{},
+
+    /// Child lists relinked by keyed reordering since init (diagnostics)
+    sibling_relinks: u64 = 0,
 
     /// ID stack for hierarchical widget scoping
     id_stack: IdStack = IdStack.init(null),
@@ -162,6 +208,33 @@ pub const GUI = struct {
     /// Draw command list - accumulates rendering commands during widget calls
     draw_list: DrawList,
 
+    /// Backend used to measure widget text (null = 8px per character)
+    text_backend: ?RenderBackend = null,
+
+    /// Measured text sizes keyed by string hash + font size.
+    /// Immediate mode re-submits the same labels every frame; the backend
+    /// only sees each string once.
+    text_sizes: std.AutoHashMapUnmanaged(u64, Size) = .{},
+
+    // =========================================================================
+    // Hit Testing
+    // =========================================================================
+
+    /// Absolute, clipped rects of every widget by ID. Layout nodes are
+    /// synced from the engine's moved set after layout; immediate widgets
+    /// register as they are declared. Hover is one lookup per frame instead
+    /// of a rect test per widget, and respects layers, clips and overlap.
+    hit_index: SpatialGrid,
+
+    /// Immediate widget ID → frame it was last declared in (stale ones are
+    /// dropped from hit_index at endFrame)
+    im_hit_frames: std.AutoHashMapUnmanaged(u32, u32) = .{},
+    im_hit_order: u32 = 0,
+
+    /// An insert into hit_index failed (out of memory) and dropped its entry:
+    /// the next syncHitIndex re-indexes every layout node
+    hit_index_stale: bool = false,
+
     /// Initialize the GUI system (headless mode, no renderer)
     /// Use initWithRenderer() if you have a platform renderer ready.
     pub fn init(allocator: std.mem.Allocator, config: GUIConfig) !*GUI {
@@ -214,7 +287,12 @@ pub const GUI = struct {
             .running = true,
             .widget_to_layout = std.AutoHashMap(u32, u32).init(allocator),
             .draw_list = DrawList.init(allocator),
+            .hit_index = SpatialGrid.init(allocator, SpatialGrid.DEFAULT_CELL_SIZE),
+            .frame_arena = std.heap.ArenaAllocator.init(allocator),
         };
+        errdefer gui.widget_meta.deinit(allocator);
+
+        try gui.syncWidgetCapacity();
 
         return gui;
     }
@@ -226,6 +304,11 @@ pub const GUI = struct {
 
         // Clean up reconciliation structures
         self.widget_to_layout.deinit();
+        self.text_sizes.deinit(self.allocator);
+        self.hit_index.deinit();
+        self.im_hit_frames.deinit(self.allocator);
+        self.widget_meta.deinit(self.allocator);
+        self.frame_arena.deinit();
         self.id_stack.deinit();
 
         // Clean up all subsystems in reverse order of creation
@@ -268,15 +351,19 @@ pub const GUI = struct {
         self.im_cursor_x = self.im_padding;
         self.im_cursor_y = self.im_padding;
 
-        // Clear hot ID (will be set during rendering)
-        self.im_hot_id = 0;
+        // Hover comes from the hit index (last frame's geometry, i.e. what
+        // is on screen); widgets compare their ID against it
+        self.im_hit_order = 0;
+        self.updateHover();
 
         // Clear clicked ID from previous frame
         self.im_clicked_id = 0;
 
         // === Immediate Mode Reconciliation ===
-        // Clear the "seen this frame" tracking
-        self.seen_this_frame = std.StaticBitSet(MAX_WIDGETS).initEmpty();
+        // New generation: every widget is unseen until declared again
+        self.frame_index +%= 1;
+        _ = self.frame_arena.reset(.retain_capacity);
+        self.reorder_parents = .{};
 
         // Clear ID stack for fresh frame
         self.id_stack.clear();
@@ -292,21 +379,25 @@ pub const GUI = struct {
                 .height = @floatFromInt(self.config.window_height),
             });
             self.root_layout_index = root_index;
+            try self.syncWidgetCapacity();
             try self.widget_to_layout.put(0, root_index); // Hash 0 = root
         }
 
         // Start with root as current parent
         self.parent_stack.appendAssumeCapacity(self.root_layout_index.?);
-        self.seen_this_frame.set(self.root_layout_index.?);
 
         // Begin layout frame
         self.layout_engine.beginFrame();
+        self.layout_engine.clearDamage();
 
         // Process any queued events
         {
             profiler.zone(@src(), "EventManager.processEvents", .{});
             defer profiler.endZone();
             self.event_manager.processEvents();
+            const wheel = self.event_manager.getScrollDelta();
+            self.im_scroll_x += wheel.x;
+            self.im_scroll_y += wheel.y;
         }
 
         // Process asset loading requests
@@ -334,27 +425,22 @@ pub const GUI = struct {
         defer profiler.endZone();
 
         // === Immediate Mode Reconciliation ===
-        // Remove widgets that weren't seen this frame
+        // Remove widgets that weren't seen this frame: one linear pass over
+        // the slot table, no hash map iteration, no allocation
         {
             profiler.zone(@src(), "GUI.reconcileWidgets", .{});
             defer profiler.endZone();
 
-            var to_remove = std.ArrayList(u32).init(self.allocator);
-            defer to_remove.deinit();
-
-            var iter = self.widget_to_layout.iterator();
-            while (iter.next()) |entry| {
-                const layout_index = entry.value_ptr.*;
-                if (!self.seen_this_frame.isSet(layout_index)) {
-                    to_remove.append(entry.key_ptr.*) catch {};
-                }
+            const slots = self.widget_meta.items[0..self.layout_engine.getElementCount()];
+            for (slots, 0..) |meta, layout_index| {
+                // Unused slots and the root (hash 0) are never stale
+                if (meta.widget_hash == 0 or meta.generation == self.frame_index) continue;
+                self.removeWidget(@intCast(layout_index));
             }
 
-            for (to_remove.items) |widget_hash| {
-                if (self.widget_to_layout.get(widget_hash)) |layout_index| {
-                    self.layout_engine.removeElement(layout_index);
-                    _ = self.widget_to_layout.remove(widget_hash);
-                }
+            // Children emitted in a new order: one relink per parent
+            for (self.reorder_parents.items) |parent| {
+                self.applySiblingOrder(parent);
             }
         }
 
@@ -368,6 +454,35 @@ pub const GUI = struct {
             try self.layout_engine.computeLayout(frame_width, frame_height);
         }
 
+        // Wheel input scrolls the innermost container under the mouse.
+        // Only positions move: the next frame does no layout work for it.
+        if (self.im_scroll_target) |target| {
+            if (self.im_scroll_x != 0 or self.im_scroll_y != 0) {
+                const scroll = self.layout_engine.getScrollOffset(target);
+                self.layout_engine.setScrollOffset(
+                    target,
+                    scroll.x - self.im_scroll_x * self.im_scroll_step,
+                    scroll.y - self.im_scroll_y * self.im_scroll_step,
+                );
+            }
+        }
+        self.im_scroll_x = 0;
+        self.im_scroll_y = 0;
+        self.im_scroll_target = null;
+
+        // Before syncHitIndex, which acknowledges the moved nodes
+        _ = self.layout_engine.collectDamage();
+
+        {
+            profiler.zone(@src(), "GUI.syncHitIndex", .{});
+            defer profiler.endZone();
+            self.syncHitIndex();
+            self.updateHover();
+        }
+
+        // Layers sorted back to front and batched for getDrawData
+        self.draw_list.finalize();
+
         // Render if we have a renderer
         if (self.renderer) |renderer| {
             {
@@ -409,10 +524,12 @@ pub const GUI = struct {
     pub fn getDrawData(self: *const GUI) DrawData {
         return DrawData{
             .commands = self.draw_list.getCommands(),
+            .batches = self.draw_list.getBatches(),
             .display_size = Size{
                 .width = @floatFromInt(self.config.window_width),
                 .height = @floatFromInt(self.config.window_height),
             },
+            .damage = self.layout_engine.getDamage(),
         };
     }
 
@@ -430,6 +547,7 @@ pub const GUI = struct {
     pub fn setMousePosition(self: *GUI, x: f32, y: f32) void {
         self.im_mouse_x = x;
         self.im_mouse_y = y;
+        self.updateHover();
     }
 
     /// Update mouse button state (called by platform)
@@ -437,6 +555,14 @@ pub const GUI = struct {
         self.im_mouse_down = down;
     }
 
+    /// Accumulate wheel movement in notches, +y = away from the user
+    /// (called by platform; scroll events queued on the event manager are
+    /// added automatically)
+    pub fn addScrollDelta(self: *GUI, dx: f32, dy: f32) void {
+        self.im_scroll_x += dx;
+        self.im_scroll_y += dy;
+    }
+
     /// Handle raw input data
     pub fn handleInput(self: *GUI, _: ?*anyopaque) void {
         _ = self;
@@ -493,45 +619,288 @@ pub const GUI = struct {
 
         if (self.widget_to_layout.get(widget_hash)) |existing_index| {
             // Widget exists - check if parent changed (re-parenting needed)
-            const meta = &self.widget_meta[existing_index];
+            const meta = &self.widget_meta.items[existing_index];
+            var reparented = false;
             if (meta.parent_hash != current_parent_hash) {
                 // Re-parent the widget
                 self.layout_engine.reparent(existing_index, current_parent_layout);
                 meta.parent_hash = current_parent_hash;
+                reparented = true;
             }
 
-            // Update style if needed
-            self.layout_engine.setStyle(existing_index, style);
+            // Update style only if it changed (keeps steady-state frames clean)
+            _ = self.layout_engine.updateStyle(existing_index, style);
 
             // Mark as seen
-            self.seen_this_frame.set(existing_index);
+            meta.generation = self.frame_index;
+            self.trackSiblingOrder(current_parent_layout, existing_index, reparented);
             return existing_index;
         }
 
         // New widget - create layout element
         const new_index = try self.layout_engine.addElement(current_parent_layout, style);
+        try self.syncWidgetCapacity();
 
         try self.widget_to_layout.put(widget_hash, new_index);
-        self.widget_meta[new_index] = .{
+        self.widget_meta.items[new_index] = .{
+            .widget_hash = widget_hash,
+            .generation = self.frame_index,
             .parent_hash = current_parent_hash,
-            .sibling_order = 0,
             .widget_type = widget_type,
         };
-
-        // Mark as seen
-        self.seen_this_frame.set(new_index);
+        self.trackSiblingOrder(current_parent_layout, new_index, true);
 
         return new_index;
     }
 
-    /// Get the computed rect for a widget by its hash
+    /// Record `child`'s position among the children declared under `parent`
+    /// this frame and check it against the layout order. Each parent walks
+    /// its layout child list as children are declared, so an unchanged
+    /// order costs one compare per child; anything else queues the parent
+    /// for applySiblingOrder. `appended` = just linked at the end of the list.
+    fn trackSiblingOrder(self: *GUI, parent: u32, child: u32, appended: bool) void {
+        const parent_meta = &self.widget_meta.items[parent];
+        if (parent_meta.child_generation != self.frame_index) {
+            parent_meta.child_generation = self.frame_index;
+            parent_meta.child_counter = 0;
+            parent_meta.child_cursor = self.layout_engine.first_child[parent];
+        }
+        self.widget_meta.items[child].sibling_order = parent_meta.child_counter;
+        parent_meta.child_counter +|= 1;
+
+        if (child == parent_meta.child_cursor) {
+            parent_meta.child_cursor = self.layout_engine.next_sibling[child];
+        } else if (!(appended and parent_meta.child_cursor == NO_CHILD)) {
+            // Out of layout order - or after siblings about to be removed,
+            // which applySiblingOrder finds to be a no-op
+            if (!parent_meta.reorder_pending) {
+                self.reorder_parents.append(self.frameAllocator(), parent) catch return;
+                parent_meta.reorder_pending = true;
+            }
+        }
+    }
+
+    /// Put a parent's children in declaration order (after unseen children
+    /// were removed). The list is relinked in one reorderSiblings call,
+    /// which dirties the parent only - the children keep their nodes and
+    /// caches. Declaration orders are the positions 0..n-1, so the new list
+    /// is built by placing each child at its order: O(n), no sort.
+    fn applySiblingOrder(self: *GUI, parent: u32) void {
+        const parent_meta = &self.widget_meta.items[parent];
+        if (!parent_meta.reorder_pending) return; // Removed since it was queued
+        parent_meta.reorder_pending = false;
+
+        const engine = self.layout_engine;
+        const count: usize = engine.child_count[parent];
+        const ordered = self.frameAllocator().alloc(u32, count) catch return;
+        @memset(ordered, NO_CHILD);
+
+        // Queued only for removals: already in order
+        var in_order = true;
+        var child = engine.first_child[parent];
+        for (0..count) |position| {
+            const order = self.widget_meta.items[child].sibling_order;
+            in_order = in_order and order == position;
+            // Every child was declared this frame, so orders never collide
+            if (order >= count or ordered[order] != NO_CHILD) return;
+            ordered[order] = child;
+            child = engine.next_sibling[child];
+        }
+        if (in_order) return;
+
+        engine.reorderSiblings(parent, ordered);
+        self.sibling_relinks += 1;
+    }
+
+    /// Keep per-index widget tables as large as the layout engine's storage
+    /// (the engine grows in power-of-two steps, so this rarely allocates)
+    fn syncWidgetCapacity(self: *GUI) !void {
+        const capacity: usize = self.layout_engine.getCapacity();
+        if (self.widget_meta.items.len < capacity) {
+            try self.widget_meta.appendNTimes(self.allocator, .{}, capacity - self.widget_meta.items.len);
+        }
+    }
+
+    /// Remove a widget and every widget below it. Children of an unseen
+    /// container are unseen too; clearing their slots here keeps the endFrame
+    /// scan from removing them a second time.
+    fn removeWidget(self: *GUI, layout_index: u32) void {
+        for (self.layout_engine.removeSubtree(layout_index)) |freed| {
+            const meta = &self.widget_meta.items[freed];
+            if (meta.widget_hash != 0) {
+                _ = self.widget_to_layout.remove(meta.widget_hash);
+                self.hit_index.remove(meta.widget_hash);
+            }
+            meta.* = .{};
+        }
+    }
+
+    /// Scratch allocator for the current frame: freed wholesale at the next
+    /// beginFrame. For temporaries built while declaring widgets.
+    pub fn frameAllocator(self: *GUI) std.mem.Allocator {
+        return self.frame_arena.allocator();
+    }
+
+    /// Renumber layout nodes into depth-first order with contiguous children
+    /// (see LayoutEngine.compact) and remap widget_to_layout and the
+    /// per-index widget tables. Worth calling once the widget tree has
+    /// settled after heavy churn. Call between frames.
+    pub fn compactLayout(self: *GUI) !void {
+        std.debug.assert(!self.in_frame);
+
+        const count = self.layout_engine.getElementCount();
+        const scratch = self.frameAllocator();
+        const remap = try scratch.alloc(u32, count);
+        const old_meta = try scratch.dupe(WidgetMeta, self.widget_meta.items[0..count]);
+
+        try self.layout_engine.compact(remap);
+
+        var layout_indices = self.widget_to_layout.valueIterator();
+        while (layout_indices.next()) |layout_index| {
+            layout_index.* = remap[layout_index.*];
+        }
+        for (old_meta, remap) |meta, new_index| {
+            if (new_index != std.math.maxInt(u32)) self.widget_meta.items[new_index] = meta;
+        }
+        if (self.root_layout_index) |root| {
+            self.root_layout_index = remap[root];
+        }
+    }
+
+    // =========================================================================
+    // Hit Testing
+    // =========================================================================
+
+    /// Topmost widget at a point in window coordinates (its full scoped
+    /// ID hash), or null. Uses the geometry of the last endFrame plus any
+    /// immediate widgets declared since.
+    pub fn widgetAt(self: *const GUI, x: f32, y: f32) ?u32 {
+        return self.hit_index.hitTest(x, y);
+    }
+
+    /// Append every widget whose visible rect overlaps `rect` to `out`
+    /// (unordered; e.g. rubber-band selection, damage queries)
+    pub fn widgetsInRect(self: *const GUI, rect: Rect, out: *std.ArrayList(u32)) !void {
+        try self.hit_index.query(rect, out);
+    }
+
+    /// Whether (x, y) lies in the visible (clipped) part of a widget,
+    /// regardless of what is drawn over it
+    pub fn hitTestWidget(self: *const GUI, widget_hash: u32, x: f32, y: f32) bool {
+        const entry = self.hit_index.get(widget_hash) orelse return false;
+        return pointInRect(x, y, entry.rect);
+    }
+
+    fn updateHover(self: *GUI) void {
+        self.im_hover_id = self.hit_index.hitTest(self.im_mouse_x, self.im_mouse_y) orelse 0;
+        self.im_hot_id = self.im_hover_id;
+    }
+
+    /// Record an immediate widget's rect for this frame, under the current
+    /// clip and layer. Returns whether it is the topmost widget under the
+    /// mouse (as of the last hover update).
+    fn registerHit(self: *GUI, id: u32, rect: Rect) bool {
+        const order = IM_HIT_ORDER_BASE +| self.im_hit_order;
+        self.im_hit_order +|= 1;
+        self.hit_index.update(id, rect, self.draw_list.currentClip(), self.draw_list.current_layer, order) catch {
+            self.hit_index_stale = true;
+        };
+        if (self.im_hit_frames.getPtr(id)) |frame| {
+            frame.* = self.frame_index;
+        } else {
+            self.im_hit_frames.put(self.allocator, id, self.frame_index) catch {};
+        }
+        return id != 0 and self.im_hover_id == id;
+    }
+
+    /// Bring the hit index up to date after layout: re-index layout nodes
+    /// whose absolute rect changed, drop immediate widgets not declared this
+    /// frame. Unchanged widgets cost nothing.
+    fn syncHitIndex(self: *GUI) void {
+        const engine = self.layout_engine;
+        engine.updatePositions();
+
+        // A failed insert dropped a widget from the index: rebuild it all
+        // rather than leave it unclickable until it next moves
+        if (self.hit_index_stale) {
+            self.hit_index_stale = false;
+            if (self.root_layout_index) |root| engine.markDescendantsMoved(root);
+        }
+
+        // A moved or resized clipping node changes the clip of its whole
+        // subtree, including children whose own rects stayed put
+        var next_clip = engine.nextMoved(0);
+        while (next_clip) |index| : (next_clip = engine.nextMoved(index + 1)) {
+            if (engine.flex_styles[index].overflow != .visible) engine.markDescendantsMoved(index);
+        }
+
+        var next = engine.nextMoved(0);
+        while (next) |index| : (next = engine.nextMoved(index + 1)) {
+            const widget_hash = self.widget_meta.items[index].widget_hash;
+            if (widget_hash == 0) continue;
+            const current = self.widget_to_layout.get(widget_hash) orelse continue;
+            if (current != index) continue;
+
+            // Clip to every clipping ancestor; deeper nodes draw on top.
+            // Style layers add up along the path, as in the draw list.
+            var clip: ?Rect = null;
+            var depth: u32 = 0;
+            var layer: u16 = engine.flex_styles[index].layer;
+            var ancestor = engine.parent[index];
+            while (ancestor != std.math.maxInt(u32)) : (ancestor = engine.parent[ancestor]) {
+                depth += 1;
+                layer +|= engine.flex_styles[ancestor].layer;
+                if (engine.flex_styles[ancestor].overflow == .visible) continue;
+                const bounds = engine.getAbsoluteRect(ancestor);
+                clip = if (clip) |c| draw.rectIntersect(c, bounds) else bounds;
+            }
+            self.hit_index.update(widget_hash, engine.getAbsoluteRect(index), clip, layer, depth) catch {
+                self.hit_index_stale = true;
+            };
+        }
+        engine.clearMoved();
+
+        // Hash map removal leaves tombstones, so removing while iterating is safe
+        var iter = self.im_hit_frames.iterator();
+        while (iter.next()) |entry| {
+            if (entry.value_ptr.* == self.frame_index) continue;
+            self.hit_index.remove(entry.key_ptr.*);
+            self.im_hit_frames.removeByPtr(entry.key_ptr);
+        }
+    }
+
+    /// Get the computed rect for a widget by its hash (window coordinates)
     pub fn getWidgetRect(self: *GUI, widget_hash: u32) ?Rect {
         if (self.widget_to_layout.get(widget_hash)) |layout_index| {
-            return self.layout_engine.getRect(layout_index);
+            return self.layout_engine.getAbsoluteRect(layout_index);
+        }
+        return null;
+    }
+
+    /// Translate a widget and its children without re-running layout
+    /// (dragged panels, scrolled content). Persists until changed.
+    pub fn setWidgetOffset(self: *GUI, widget_hash: u32, x: f32, y: f32) void {
+        if (self.widget_to_layout.get(widget_hash)) |layout_index| {
+            self.layout_engine.setOffset(layout_index, x, y);
+        }
+    }
+
+    /// Content position of a scroll container (0,0 = scrolled to the top-left)
+    pub fn getScrollOffset(self: *const GUI, widget_hash: u32) ?Point {
+        if (self.widget_to_layout.get(widget_hash)) |layout_index| {
+            return self.layout_engine.getScrollOffset(layout_index);
         }
         return null;
     }
 
+    /// Scroll a container programmatically (e.g. keep a log pane at its tail).
+    /// Clamped to the content extent of the last layout.
+    pub fn setScrollOffset(self: *GUI, widget_hash: u32, x: f32, y: f32) void {
+        if (self.widget_to_layout.get(widget_hash)) |layout_index| {
+            self.layout_engine.setScrollOffset(layout_index, x, y);
+        }
+    }
+
     // =========================================================================
     // Container API (design-aligned: auto ID scope push)
     // =========================================================================
@@ -546,7 +915,7 @@ pub const GUI = struct {
     /// if (gui.button("file")) { ... }  // ID: toolbar ^ file
     /// ```
     pub fn begin(self: *GUI, comptime label: []const u8, style: FlexStyle) void {
-        self.beginCore(comptime WidgetId.from(label).hash, style);
+        _ = self.beginCore(comptime WidgetId.from(label).hash, style);
     }
 
     /// Begin a container with index - for loops
@@ -562,39 +931,174 @@ pub const GUI = struct {
     pub fn beginIndexed(self: *GUI, comptime label: []const u8, index: usize, style: FlexStyle) void {
         const base_hash = comptime WidgetId.from(label).hash;
         const indexed_hash = base_hash ^ (@as(u32, @truncate(index)) +% 1) *% 0x9e3779b9;
-        self.beginCore(indexed_hash, style);
+        _ = self.beginCore(indexed_hash, style);
     }
 
     /// Begin a container with runtime string - for dynamic content
     pub fn beginDynamic(self: *GUI, label: []const u8, style: FlexStyle) void {
-        self.beginCore(WidgetId.runtime(label).hash, style);
+        _ = self.beginCore(WidgetId.runtime(label).hash, style);
     }
 
     /// Begin a container with pre-computed ID - for C API interop
     pub fn beginById(self: *GUI, id: u32, style: FlexStyle) void {
-        self.beginCore(id, style);
+        _ = self.beginCore(id, style);
     }
 
-    /// Core container begin - takes pre-computed hash
-    fn beginCore(self: *GUI, id_hash: u32, style: FlexStyle) void {
+    /// Core container begin - takes pre-computed hash, returns the layout index
+    fn beginCore(self: *GUI, id_hash: u32, style: FlexStyle) ?u32 {
         // Combine with current scope
         const final_id = self.id_stack.combine(id_hash);
 
         // Create/update layout element
-        const layout_idx = self.getOrCreateElement(final_id, .container, style) catch return;
+        const layout_idx = self.getOrCreateElement(final_id, .container, style) catch return null;
 
         // Push ID scope (so children inherit this container's scope)
         self.id_stack.pushHash(id_hash);
 
         // Push as current parent (so children are laid out inside this container)
-        self.parent_stack.append(layout_idx) catch return;
+        self.parent_stack.append(layout_idx) catch return null;
+
+        // Everything inside draws (and hit-tests) above the layers around it
+        if (style.layer > 0) self.draw_list.pushLayerAbove(style.layer);
+        return layout_idx;
+    }
+
+    /// Begin a scroll container - content is laid out at its natural size
+    /// and moved by the scroll offset, never re-laid out by scrolling.
+    /// Draw commands inside are clipped to the viewport and anything fully
+    /// outside it is culled (DrawList.isVisible lets callers skip whole rows).
+    /// The viewport comes from the previous frame's layout, like getWidgetRect;
+    /// on the frame it is created, the enclosing clip applies instead.
+    /// Must be closed with endScroll().
+    ///
+    /// Example:
+    /// ```zig
+    /// gui.beginScroll("log", .{ .flex_grow = 1 });
+    /// defer gui.endScroll();
+    /// for (lines, 0..) |line, i| { ... }
+    /// ```
+    pub fn beginScroll(self: *GUI, comptime label: []const u8, style: FlexStyle) void {
+        _ = self.beginScrollCore(comptime WidgetId.from(label).hash, style);
+    }
+
+    fn beginScrollCore(self: *GUI, id_hash: u32, style: FlexStyle) ?u32 {
+        var scroll_style = style;
+        scroll_style.overflow = .scroll;
+
+        const layout_idx = self.beginCore(id_hash, scroll_style) orelse {
+            // Keep the clip stack balanced for endScroll; nothing is visible
+            self.draw_list.pushClip(Rect.zero());
+            return null;
+        };
+
+        // Created this frame: no viewport yet, so keep the enclosing clip
+        // rather than culling the first frame's content to a zero rect
+        const bounds = self.layout_engine.getAbsoluteRect(layout_idx);
+        if (bounds.width == 0 and bounds.height == 0 and self.layout_engine.isDirty(layout_idx)) {
+            self.draw_list.pushClip(self.draw_list.currentClip() orelse Rect{
+                .x = 0,
+                .y = 0,
+                .width = @floatFromInt(self.config.window_width),
+                .height = @floatFromInt(self.config.window_height),
+            });
+            return layout_idx;
+        }
+        self.draw_list.pushClip(bounds);
+
+        // Nested containers begin later, so the innermost one under the mouse
+        // wins. Testing the clipped viewport skips panes scrolled out of view.
+        const viewport = self.draw_list.currentClip().?;
+        if (pointInRect(self.im_mouse_x, self.im_mouse_y, viewport)) {
+            self.im_scroll_target = layout_idx;
+        }
+        return layout_idx;
+    }
+
+    /// End a scroll container - pops its clip, then the container itself
+    pub fn endScroll(self: *GUI) void {
+        self.draw_list.popClip();
+        self.end();
     }
 
-    /// End a container - pops ID scope and parent stack
+    /// Begin a virtualized list - a scroll container in which only the rows
+    /// in view (plus overscan) exist as layout nodes, so a million-row list
+    /// costs the same per frame as a screenful.
+    ///
+    /// Emit exactly the rows in the returned range with beginListRow/end,
+    /// then close with endVirtualList. Rows sit in a window container moved
+    /// to the first row's offset; a spacer after it stands in for the rest,
+    /// so the scroll range covers the whole list. Moving the window is an
+    /// offset; rows that stay in view keep their nodes, so a scroll lays out
+    /// only the rows that entered (plus the window above them). Use
+    /// align_items = .stretch for full-width rows.
+    ///
+    /// Example:
+    /// ```zig
+    /// const range = gui.beginVirtualList("trades", .{ .flex_grow = 1, .align_items = .stretch }, &list);
+    /// for (range.first..range.end) |i| {
+    ///     gui.beginListRow(&list, range, @intCast(i), .{ .direction = .row });
+    ///     defer gui.end();
+    ///     // ... cells for trades[i] ...
+    /// }
+    /// gui.endVirtualList(&list, range);
+    /// ```
+    pub fn beginVirtualList(self: *GUI, comptime label: []const u8, style: FlexStyle, list: *const VirtualList) VirtualList.Range {
+        var range = VirtualList.Range{};
+        if (self.beginScrollCore(comptime WidgetId.from(label).hash, style)) |list_idx| {
+            // Viewport from the previous layout (the style on the first frame)
+            const rect = self.layout_engine.getRect(list_idx);
+            const viewport_height = if (rect.height > 0)
+                rect.height
+            else if (style.height >= 0)
+                style.height
+            else
+                @as(f32, @floatFromInt(self.config.window_height));
+            range = list.visibleRange(self.layout_engine.getScrollOffset(list_idx).y, viewport_height);
+        }
+
+        const window_style = FlexStyle{ .direction = .column, .align_items = .stretch, .flex_shrink = 0 };
+        if (self.beginCore(comptime WidgetId.from("virtual_list.window").hash, window_style)) |window_idx| {
+            // Moving the window is a position update, not a layout change
+            self.layout_engine.setOffset(window_idx, 0, list.rowOffset(range.first));
+        }
+        return range;
+    }
+
+    /// Begin row `row` of a virtual list (must lie in `range`). The row is a
+    /// container keyed by its index: while it stays in view it keeps its
+    /// node and its layout, and widgets inside keep their identity (focus,
+    /// hover). Rows entering the window are created and relinked into
+    /// order; rows leaving it are removed. Close with end().
+    pub fn beginListRow(self: *GUI, list: *const VirtualList, range: VirtualList.Range, row: u32, style: FlexStyle) void {
+        std.debug.assert(row >= range.first and row < range.end);
+
+        const row_base = comptime WidgetId.from("virtual_list.row").hash;
+        const row_hash = row_base ^ (row +% 1) *% 0x9e3779b9;
+
+        var row_style = style;
+        row_style.height = list.rowHeight(row);
+        row_style.flex_shrink = 0;
+        _ = self.beginCore(row_hash, row_style);
+    }
+
+    /// End a virtual list - closes the row window, sizes the spacer for the
+    /// rows outside it and closes the scroll container
+    pub fn endVirtualList(self: *GUI, list: *const VirtualList, range: VirtualList.Range) void {
+        self.end(); // window
+
+        const window_height = list.rowOffset(range.end) - list.rowOffset(range.first);
+        const spacer_style = FlexStyle{ .height = @max(0, list.contentHeight() - window_height), .flex_shrink = 0 };
+        self.widgetCore(comptime WidgetId.from("virtual_list.spacer").hash, spacer_style) catch {};
+
+        self.endScroll();
+    }
+
+    /// End a container - pops ID scope, parent stack and the container's layer
     pub fn end(self: *GUI) void {
         // Pop parent stack
         if (self.parent_stack.len > 0) {
-            self.parent_stack.len -= 1;
+            const layout_idx = self.parent_stack.pop();
+            if (self.layout_engine.flex_styles[layout_idx].layer > 0) self.draw_list.popLayer();
         }
 
         // Pop ID scope
@@ -675,11 +1179,35 @@ pub const GUI = struct {
         self.textRaw(formatted);
     }
 
+    /// Measure text with a backend's font metrics instead of the fixed
+    /// 8px-per-character approximation. Sizes are memoized per string.
+    pub fn setTextBackend(self: *GUI, backend: ?RenderBackend) void {
+        self.text_backend = backend;
+        self.text_sizes.clearRetainingCapacity();
+    }
+
+    /// Size of `str` in the immediate-mode font (memoized)
+    pub fn measureText(self: *GUI, str: []const u8) Size {
+        const backend = self.text_backend orelse return .{
+            .width = @as(f32, @floatFromInt(str.len)) * FALLBACK_CHAR_WIDTH,
+            .height = self.im_line_height,
+        };
+
+        const key = std.hash.Wyhash.hash(@as(u32, @bitCast(IM_FONT_SIZE)), str);
+        if (self.text_sizes.get(key)) |size| return size;
+
+        const size = backend.measureText(str, IM_FONT_SIZE, 0);
+        if (self.text_sizes.count() >= TEXT_SIZE_CACHE_MAX) {
+            self.text_sizes.clearRetainingCapacity();
+        }
+        // Memo is best-effort: on OOM just measure again next time
+        self.text_sizes.put(self.allocator, key, size) catch {};
+        return size;
+    }
+
     /// Create a text element with raw string
     pub fn textRaw(self: *GUI, str: []const u8) void {
-        // Calculate text dimensions (approximate: 8 pixels per character)
-        const char_width: f32 = 8;
-        const text_width = @as(f32, @floatFromInt(str.len)) * char_width;
+        const text_width = self.measureText(str).width;
         const text_height = self.im_line_height;
 
         const position = Point{
@@ -744,8 +1272,7 @@ pub const GUI = struct {
         const final_id: u64 = self.id_stack.combine(id_hash);
 
         // Calculate button dimensions
-        const char_width: f32 = 8;
-        const text_width = @as(f32, @floatFromInt(display_label.len)) * char_width;
+        const text_width = self.measureText(display_label).width;
         const button_width = text_width + self.im_padding * 2;
         const button_height = self.im_line_height + self.im_padding;
 
@@ -756,11 +1283,8 @@ pub const GUI = struct {
             .height = button_height,
         };
 
-        // Check if mouse is over button
-        const is_hot = pointInRect(self.im_mouse_x, self.im_mouse_y, rect);
-        if (is_hot) {
-            self.im_hot_id = final_id;
-        }
+        // Topmost under the mouse (hit index: respects clips and overlap)
+        const is_hot = self.registerHit(@intCast(final_id), rect);
 
         // Handle interaction
         const is_active = self.im_active_id == final_id;
@@ -920,11 +1444,8 @@ pub const GUI = struct {
             .height = size,
         };
 
-        // Check if mouse is over checkbox
-        const is_hot = pointInRect(self.im_mouse_x, self.im_mouse_y, rect);
-        if (is_hot) {
-            self.im_hot_id = final_id;
-        }
+        // Topmost under the mouse (hit index: respects clips and overlap)
+        const is_hot = self.registerHit(@intCast(final_id), rect);
 
         // Handle interaction
         var toggled = false;
@@ -1046,11 +1567,8 @@ pub const GUI = struct {
             .height = input_height,
         };
 
-        // Check if mouse is over input
-        const is_hot = pointInRect(self.im_mouse_x, self.im_mouse_y, rect);
-        if (is_hot) {
-            self.im_hot_id = id;
-        }
+        // Topmost under the mouse (hit index: respects clips and overlap)
+        const is_hot = self.registerHit(@intCast(id), rect);
 
         // Handle interaction
         var focused = false;
@@ -1085,7 +1603,7 @@ pub const GUI = struct {
 
         if (is_active) {
             const cursor_x = rect.x + self.im_padding / 2 +
-                @as(f32, @floatFromInt(current_text.len)) * 8.0;
+                self.measureText(current_text).width;
             const cursor_rect = Rect{
                 .x = cursor_x,
                 .y = rect.y + 4,
@@ -1271,6 +1789,102 @@ test "GUI text rendering" {
     try gui.endFrame();
 }
 
+test "GUI text measured by backend and memoized" {
+    const CountingBackend = struct {
+        measure_calls: u32 = 0,
+
+        const vtable = RenderBackend.VTable{
+            .beginFrame = beginFrame,
+            .render = beginFrame,
+            .endFrame = endFrame,
+            .createTexture = createTexture,
+            .destroyTexture = destroyTexture,
+            .measureText = measureText,
+        };
+
+        fn beginFrame(_: *anyopaque, _: *const DrawData) void {}
+        fn endFrame(_: *anyopaque) void {}
+        fn createTexture(_: *anyopaque, _: u32, _: u32, _: []const u8) u32 {
+            return 0;
+        }
+        fn destroyTexture(_: *anyopaque, _: u32) void {}
+
+        fn measureText(ptr: *anyopaque, str: []const u8, font_size: f32, _: u16) Size {
+            const self: *@This() = @ptrCast(@alignCast(ptr));
+            self.measure_calls += 1;
+            return .{ .width = @as(f32, @floatFromInt(str.len)) * 5, .height = font_size };
+        }
+    };
+
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    var backend = CountingBackend{};
+    gui.setTextBackend(.{ .ptr = &backend, .vtable = &CountingBackend.vtable });
+
+    for (0..3) |_| {
+        try gui.beginFrame();
+        const start_x = gui.im_cursor_x;
+        gui.textRaw("Label");
+        try std.testing.expectEqual(start_x + 25 + gui.im_spacing, gui.im_cursor_x);
+        gui.button("OK");
+        try gui.endFrame();
+    }
+
+    // Two distinct strings, measured once each across three frames
+    try std.testing.expectEqual(@as(u32, 2), backend.measure_calls);
+}
+
+test "GUI compactLayout keeps widgets and rects" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    // Churn: a transient widget in the middle frees a slot
+    for (0..2) |frame| {
+        try gui.beginFrame();
+        gui.begin("panel", .{ .direction = .row, .height = 40 });
+        try gui.widget("a", .{ .width = 20, .height = 20 });
+        if (frame == 0) try gui.widget("tmp", .{ .width = 5, .height = 5 });
+        gui.end();
+        gui.begin("side", .{ .direction = .column, .width = 100, .height = 100 });
+        try gui.widget("b", .{ .height = 30 });
+        gui.end();
+        try gui.endFrame();
+    }
+
+    // Rects by widget hash before compaction
+    var before = std.AutoHashMap(u32, Rect).init(std.testing.allocator);
+    defer before.deinit();
+    var entries = gui.widget_to_layout.iterator();
+    while (entries.next()) |entry| {
+        try before.put(entry.key_ptr.*, gui.layout_engine.getAbsoluteRect(entry.value_ptr.*));
+    }
+
+    try gui.compactLayout();
+    try std.testing.expect(gui.layout_engine.hasContiguousChildren());
+    try std.testing.expectEqual(@as(u32, 0), gui.root_layout_index.?);
+    try std.testing.expectEqual(before.count(), gui.widget_to_layout.count());
+
+    var rects = before.iterator();
+    while (rects.next()) |entry| {
+        try std.testing.expectEqual(entry.value_ptr.*, gui.getWidgetRect(entry.key_ptr.*).?);
+    }
+
+    // Same widgets next frame: found, not recreated
+    const count = gui.layout_engine.getElementCount();
+    try gui.beginFrame();
+    gui.begin("panel", .{ .direction = .row, .height = 40 });
+    try gui.widget("a", .{ .width = 20, .height = 20 });
+    gui.end();
+    gui.begin("side", .{ .direction = .column, .width = 100, .height = 100 });
+    try gui.widget("b", .{ .height = 30 });
+    gui.end();
+    try gui.endFrame();
+
+    try std.testing.expectEqual(count, gui.layout_engine.getElementCount());
+    try std.testing.expect(gui.layout_engine.hasContiguousChildren());
+}
+
 test "GUI checkbox with comptime label" {
     const gui = try GUI.init(std.testing.allocator, .{});
     defer gui.deinit();
@@ -1508,3 +2122,471 @@ test "GUI display size matches config" {
     try std.testing.expectEqual(@as(f32, 1920), draw_data.display_size.width);
     try std.testing.expectEqual(@as(f32, 1080), draw_data.display_size.height);
 }
+
+test "GUI steady-state frames leave layout clean" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    for (0..3) |_| {
+        try gui.beginFrame();
+        gui.begin("panel", .{ .direction = .row, .height = 40 });
+        try gui.widget("a", .{ .width = 20, .height = 20 });
+        try gui.widget("b", .{ .flex_grow = 1 });
+        gui.end();
+        try gui.endFrame();
+    }
+
+    // Re-submitted styles are identical, so nothing is dirtied after frame 1
+    const stats = gui.layout_engine.getCacheStats();
+    try std.testing.expectEqual(@as(u64, 6), stats.style_writes_skipped);
+    try std.testing.expectEqual(@as(usize, 0), gui.layout_engine.getDirtyCount());
+
+    // A real change still goes through
+    try gui.beginFrame();
+    gui.begin("panel", .{ .direction = .row, .height = 80 });
+    gui.end();
+    try std.testing.expect(gui.layout_engine.getDirtyCount() > 0);
+    try gui.endFrame();
+}
+
+test "GUI scroll container follows the wheel without relayout" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    const log_hash = comptime WidgetId.from("log").hash;
+    var ids = IdStack.init(null);
+    ids.pushId(WidgetId.from("log"));
+    // widgetIndexed numbers lines from 1, like IdStack.pushIndex
+    const line10_hash = ids.combine(WidgetId.from("line").indexed(10 + 1));
+
+    for (0..3) |frame| {
+        if (frame == 2) {
+            // Two notches towards the user over the pane: content moves up 80px
+            gui.setMousePosition(50, 50);
+            gui.addScrollDelta(0, -2);
+            gui.layout_engine.resetCacheStats();
+        }
+
+        try gui.beginFrame();
+        gui.beginScroll("log", .{ .direction = .column, .width = 300, .height = 200 });
+        if (frame == 2) {
+            try std.testing.expectEqual(@as(f32, 200), gui.draw_list.currentClip().?.height);
+        }
+        for (0..50) |i| {
+            try gui.widgetIndexed("line", i, .{ .height = 20 });
+        }
+        gui.endScroll();
+        try std.testing.expectEqual(@as(?Rect, null), gui.draw_list.currentClip());
+        try gui.endFrame();
+    }
+
+    try std.testing.expectEqual(@as(f32, 80), gui.getScrollOffset(log_hash).?.y);
+    try std.testing.expectEqual(@as(f32, 120), gui.getWidgetRect(line10_hash).?.y);
+
+    // Scrolling did not touch layout
+    const stats = gui.layout_engine.getCacheStats();
+    try std.testing.expectEqual(@as(u64, 0), stats.hits + stats.misses);
+    try std.testing.expectEqual(@as(usize, 0), gui.layout_engine.getDirtyCount());
+}
+
+test "GUI scroll container draws on its first frame" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    // A one-shot render: the pane has never been laid out
+    try gui.beginFrame();
+    gui.beginScroll("log", .{ .direction = .column, .width = 300, .height = 200 });
+    try std.testing.expectEqual(@as(f32, 800), gui.draw_list.currentClip().?.width);
+    gui.button("OK");
+    gui.endScroll();
+    try gui.endFrame();
+
+    try std.testing.expect(gui.getDrawData().commands.len > 0);
+    try std.testing.expectEqual(@as(u32, 0), gui.draw_list.culled_count);
+
+    // From the next frame on, the laid-out viewport clips
+    try gui.beginFrame();
+    gui.beginScroll("log", .{ .direction = .column, .width = 300, .height = 200 });
+    try std.testing.expectEqual(Rect{ .x = 0, .y = 0, .width = 300, .height = 200 }, gui.draw_list.currentClip().?);
+    gui.button("OK");
+    gui.endScroll();
+    try gui.endFrame();
+}
+
+test "GUI hit index resolves overlap and clips" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    const pane_hash = comptime WidgetId.from("pane").hash;
+    var ids = IdStack.init(null);
+    ids.pushId(WidgetId.from("pane"));
+    var rows: [5]u32 = undefined;
+    for (&rows, 0..) |*row, i| {
+        // widgetIndexed numbers rows from 1, like IdStack.pushIndex
+        row.* = ids.combine(WidgetId.from("row").indexed(i + 1));
+    }
+    const ok_hash = comptime WidgetId.from("OK").hash;
+
+    for (0..4) |frame| {
+        try gui.beginFrame();
+        gui.beginScroll("pane", .{ .direction = .column, .width = 300, .height = 100 });
+        for (0..5) |i| {
+            try gui.widgetIndexed("row", i, .{ .width = 300, .height = 40 });
+        }
+        gui.endScroll();
+        if (frame < 2) {
+            gui.button("OK");
+            if (frame == 1) try std.testing.expect(gui.isHovered("OK"));
+        }
+        try gui.endFrame();
+
+        switch (frame) {
+            0 => {
+                // Deepest layout node wins over its container
+                try std.testing.expectEqual(@as(?u32, rows[1]), gui.widgetAt(10, 50));
+                // Row 2 is cut at the viewport edge, row 3 is not visible at all
+                try std.testing.expectEqual(@as(?u32, null), gui.widgetAt(10, 110));
+                try std.testing.expect(gui.hitTestWidget(rows[2], 10, 90));
+                try std.testing.expect(!gui.hitTestWidget(rows[2], 10, 105));
+                try std.testing.expectEqual(@as(?SpatialGrid.Entry, null), gui.hit_index.get(rows[3]));
+
+                // Immediate widgets sit above layout nodes
+                try std.testing.expectEqual(@as(?u32, ok_hash), gui.widgetAt(12, 12));
+                gui.setMousePosition(12, 12);
+                gui.setScrollOffset(pane_hash, 0, 60);
+            },
+            1 => {
+                // Scrolled without relayout: the index follows the moved rows
+                try std.testing.expectEqual(@as(?u32, rows[2]), gui.widgetAt(10, 50));
+                try std.testing.expect(gui.hitTestWidget(rows[3], 10, 90));
+
+                var found = std.ArrayList(u32).init(std.testing.allocator);
+                defer found.deinit();
+                try gui.widgetsInRect(.{ .x = 0, .y = 45, .width = 50, .height = 10 }, &found);
+                try std.testing.expect(std.mem.indexOfScalar(u32, found.items, rows[2]) != null);
+                try std.testing.expect(std.mem.indexOfScalar(u32, found.items, pane_hash) != null);
+                try std.testing.expectEqual(@as(usize, 2), found.items.len);
+            },
+            else => {
+                // The button is gone from the index with the frame that dropped it
+                try std.testing.expectEqual(@as(?SpatialGrid.Entry, null), gui.hit_index.get(ok_hash));
+                try std.testing.expectEqual(@as(?u32, rows[1]), gui.widgetAt(12, 12));
+                try std.testing.expect(!gui.isHovered("OK"));
+            },
+        }
+    }
+}
+
+test "GUI hit index follows a shrinking clip" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    var ids = IdStack.init(null);
+    ids.pushId(WidgetId.from("pane"));
+    // widgetIndexed numbers rows from 1, like IdStack.pushIndex
+    const row_1 = ids.combine(WidgetId.from("row").indexed(1 + 1));
+
+    for ([_]f32{ 100, 60 }) |pane_height| {
+        try gui.beginFrame();
+        gui.beginScroll("pane", .{ .direction = .column, .width = 300, .height = pane_height });
+        for (0..3) |i| {
+            try gui.widgetIndexed("row", i, .{ .width = 300, .height = 40, .flex_shrink = 0 });
+        }
+        gui.endScroll();
+        try gui.endFrame();
+    }
+
+    // The rows did not move, but row 1 is now cut at the new viewport edge
+    try std.testing.expectEqual(Rect{ .x = 0, .y = 40, .width = 300, .height = 40 }, gui.getWidgetRect(row_1).?);
+    try std.testing.expect(gui.hitTestWidget(row_1, 10, 50));
+    try std.testing.expect(!gui.hitTestWidget(row_1, 10, 70));
+    try std.testing.expectEqual(@as(?u32, null), gui.widgetAt(10, 70));
+}
+
+test "GUI re-indexes every widget after a failed hit index insert" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    var ids = IdStack.init(null);
+    ids.pushId(WidgetId.from("pane"));
+    // widgetIndexed numbers rows from 1, like IdStack.pushIndex
+    const row_1 = ids.combine(WidgetId.from("row").indexed(1 + 1));
+
+    for (0..3) |frame| {
+        if (frame == 2) {
+            // What SpatialGrid.update leaves behind when linking runs out of memory
+            gui.hit_index.remove(row_1);
+            gui.hit_index_stale = true;
+        }
+        try gui.beginFrame();
+        gui.beginScroll("pane", .{ .direction = .column, .width = 300, .height = 100 });
+        for (0..3) |i| {
+            try gui.widgetIndexed("row", i, .{ .width = 300, .height = 40, .flex_shrink = 0 });
+        }
+        gui.endScroll();
+        try gui.endFrame();
+    }
+
+    // Nothing moved, yet the dropped row is back
+    try std.testing.expect(!gui.hit_index_stale);
+    try std.testing.expect(gui.hitTestWidget(row_1, 10, 50));
+    try std.testing.expectEqual(@as(?u32, row_1), gui.widgetAt(10, 50));
+}
+
+test "GUI steady-state frames do not touch the allocator" {
+    var failing = std.testing.FailingAllocator.init(std.testing.allocator, .{});
+    const gui = try GUI.init(failing.allocator(), .{});
+    defer gui.deinit();
+
+    const ui = struct {
+        fn frame(g: *GUI, toolbar: bool) !void {
+            try g.beginFrame();
+            if (toolbar) {
+                g.begin("toolbar", .{ .direction = .row, .height = 40 });
+                for (0..8) |i| try g.widgetIndexed("tool", i, .{ .width = 32, .height = 32 });
+                g.end();
+            }
+            g.beginScroll("log", .{ .direction = .column, .width = 300, .height = 200 });
+            for (0..50) |i| try g.widgetIndexed("line", i, .{ .height = 20 });
+            g.endScroll();
+            g.button("Save");
+            _ = g.checkbox("autosave", true);
+            try g.text("{d} lines", .{50});
+            try g.endFrame();
+        }
+    };
+
+    gui.setMousePosition(20, 60);
+    for (0..3) |_| try ui.frame(gui, true);
+
+    const allocs = failing.alloc_index;
+    const resizes = failing.resize_index;
+    for (0..10) |_| try ui.frame(gui, true);
+    try std.testing.expectEqual(allocs, failing.alloc_index);
+    try std.testing.expectEqual(resizes, failing.resize_index);
+
+    // Dropping the toolbar frees it and its 8 children exactly once
+    const widgets = gui.widget_to_layout.count();
+    try ui.frame(gui, false);
+    try std.testing.expectEqual(widgets - 9, gui.widget_to_layout.count());
+    try std.testing.expectEqual(@as(usize, 9), gui.layout_engine.free_list.len);
+}
+
+test "GUI reorders keyed rows without rebuilding them" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    const ui = struct {
+        fn frame(g: *GUI, rows: []const u32) !void {
+            try g.beginFrame();
+            // Taller than the window: keep rows at 10px rather than shrinking
+            g.begin("table", .{ .direction = .column, .flex_shrink = 0 });
+            for (rows) |row| try g.widgetIndexed("row", row, .{ .height = 10, .flex_shrink = 0 });
+            g.end();
+            try g.endFrame();
+        }
+
+        fn rowHash(row: u32) u32 {
+            var ids = IdStack.init(null);
+            ids.pushId(WidgetId.from("table"));
+            // widgetIndexed numbers rows from 1, like IdStack.pushIndex
+            return ids.combine(WidgetId.from("row").indexed(row + 1));
+        }
+    };
+
+    var order: [5000]u32 = undefined;
+    for (&order, 0..) |*row, i| row.* = @intCast(i);
+    try ui.frame(gui, &order);
+    try ui.frame(gui, &order);
+    try std.testing.expectEqual(@as(u64, 0), gui.sibling_relinks);
+
+    const first_node = gui.widget_to_layout.get(ui.rowHash(0)).?;
+    const widgets = gui.widget_to_layout.count();
+
+    // Sort descending: every row keeps its node, the table is relinked once
+    std.mem.reverse(u32, &order);
+    gui.layout_engine.resetCacheStats();
+    try ui.frame(gui, &order);
+
+    try std.testing.expectEqual(@as(u64, 1), gui.sibling_relinks);
+    try std.testing.expectEqual(first_node, gui.widget_to_layout.get(ui.rowHash(0)).?);
+    try std.testing.expectEqual(widgets, gui.widget_to_layout.count());
+    try std.testing.expectEqual(@as(usize, 0), gui.layout_engine.free_list.len);
+    try std.testing.expectEqual(@as(f32, 49_990), gui.getWidgetRect(ui.rowHash(0)).?.y);
+    try std.testing.expectEqual(@as(f32, 0), gui.getWidgetRect(ui.rowHash(4999)).?.y);
+    // A few container lookups (root, table), none per row
+    try std.testing.expect(gui.layout_engine.getCacheStats().misses < 10);
+
+    // Moving one row relinks the table once more
+    const moved = order[4000];
+    std.mem.copyBackwards(u32, order[1..4001], order[0..4000]);
+    order[0] = moved;
+    try ui.frame(gui, &order);
+    try std.testing.expectEqual(@as(u64, 2), gui.sibling_relinks);
+    try std.testing.expectEqual(@as(f32, 0), gui.getWidgetRect(ui.rowHash(moved)).?.y);
+
+    // Same order again: nothing to do
+    try ui.frame(gui, &order);
+    try std.testing.expectEqual(@as(u64, 2), gui.sibling_relinks);
+}
+
+test "GUI style layers reach draw commands and hit testing" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    var ids = IdStack.init(null);
+    ids.pushId(WidgetId.from("form"));
+    const field_hash = ids.combineLabel("field");
+    const menu_hash = ids.combineLabel("menu");
+
+    for (0..2) |_| {
+        try gui.beginFrame();
+        gui.begin("form", .{ .direction = .column, .width = 300, .height = 200 });
+        try gui.widget("field", .{ .width = 300, .height = 200 });
+        gui.begin("menu", .{ .position = .absolute, .top = 10, .left = 10, .width = 100, .height = 50, .layer = 2 });
+        gui.button("Open");
+        gui.end();
+        gui.end();
+        try std.testing.expectEqual(@as(u16, 0), gui.draw_list.current_layer);
+        try gui.endFrame();
+    }
+
+    // Everything drawn inside the menu is two layers up, and finalized
+    const data = gui.getDrawData();
+    try std.testing.expect(data.commands.len > 0);
+    for (data.commands) |command| try std.testing.expectEqual(@as(u16, 2), command.layer);
+    try std.testing.expect(data.batches.len > 0);
+
+    // The menu covers the field without taking space from it
+    try std.testing.expectEqual(Rect{ .x = 10, .y = 10, .width = 100, .height = 50 }, gui.getWidgetRect(menu_hash).?);
+    try std.testing.expectEqual(@as(?u32, menu_hash), gui.widgetAt(105, 55));
+    try std.testing.expectEqual(@as(?u32, field_hash), gui.widgetAt(50, 150));
+}
+
+test "GUI draw data carries this frame's damage" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    const ui = struct {
+        fn frame(g: *GUI, header_height: f32) !void {
+            try g.beginFrame();
+            try g.widget("header", .{ .width = 200, .height = header_height });
+            try g.widget("body", .{ .width = 200, .height = 100 });
+            try g.endFrame();
+        }
+    };
+
+    // First frame: the whole window is new
+    try ui.frame(gui, 40);
+    const first = gui.getDrawData().damage;
+    try std.testing.expectEqual(@as(usize, 1), first.len);
+    try std.testing.expectEqual(@as(f32, 800), first[0].width);
+
+    // Identical frame: nothing to repaint
+    try ui.frame(gui, 40);
+    try std.testing.expectEqual(@as(usize, 0), gui.getDrawData().damage.len);
+
+    // Taller header: header and the body it pushes down, nothing else
+    try ui.frame(gui, 60);
+    const damage_rects = gui.getDrawData().damage;
+    try std.testing.expectEqual(@as(usize, 1), damage_rects.len);
+    try std.testing.expectEqual(Rect{ .x = 0, .y = 0, .width = 200, .height = 160 }, damage_rects[0]);
+}
+
+test "GUI virtual list keeps a million rows to a window of nodes" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    var list = VirtualList.initUniform(1_000_000, 20);
+    const list_hash = comptime WidgetId.from("blotter").hash;
+    const style = FlexStyle{ .direction = .column, .align_items = .stretch, .width = 400, .height = 200 };
+
+    var range = VirtualList.Range{};
+    for (0..4) |frame| {
+        // Jump to the middle once the first layout has sized the content
+        if (frame == 2) gui.setScrollOffset(list_hash, 0, 20 * 500_000);
+
+        try gui.beginFrame();
+        range = gui.beginVirtualList("blotter", style, &list);
+        for (range.first..range.end) |i| {
+            gui.beginListRow(&list, range, @intCast(i), .{ .direction = .row });
+            try gui.widget("cell", .{ .width = 50 });
+            gui.end();
+        }
+        gui.endVirtualList(&list, range);
+        try gui.endFrame();
+    }
+
+    // 10 rows in view plus overscan on both sides
+    try std.testing.expectEqual(@as(u32, 500_000 - list.overscan), range.first);
+    try std.testing.expectEqual(@as(u32, 10 + 2 * list.overscan), range.count());
+    try std.testing.expectEqual(@as(f32, 10_000_000), gui.getScrollOffset(list_hash).?.y);
+
+    // root, list, window, spacer + one row and one cell per emitted row
+    try std.testing.expectEqual(@as(u32, 4 + 2 * range.count()), gui.widget_to_layout.count());
+
+    // Row 500000 (the fifth row node) sits at the top of the viewport
+    const list_index = gui.widget_to_layout.get(list_hash).?;
+    const window = gui.layout_engine.first_child[list_index];
+    var row = gui.layout_engine.first_child[window];
+    for (0..4) |_| row = gui.layout_engine.next_sibling[row];
+    try std.testing.expectEqual(@as(f32, 0), gui.layout_engine.getAbsoluteRect(row).y);
+    try std.testing.expectEqual(@as(f32, 20), gui.layout_engine.getAbsoluteRect(row).height);
+}
+
+test "GUI virtual list scroll lays out only the rows that enter" {
+    const gui = try GUI.init(std.testing.allocator, .{});
+    defer gui.deinit();
+
+    var list = VirtualList.initUniform(1000, 20);
+    const list_hash = comptime WidgetId.from("blotter").hash;
+    const style = FlexStyle{ .direction = .column, .align_items = .stretch, .width = 400, .height = 200 };
+
+    var ids = IdStack.init(null);
+    ids.pushId(WidgetId.from("blotter"));
+    ids.pushId(WidgetId.from("virtual_list.window"));
+    const row_base = WidgetId.from("virtual_list.row");
+
+    const ui = struct {
+        fn rows(g: *GUI, l: *const VirtualList, s: FlexStyle) VirtualList.Range {
+            const range = g.beginVirtualList("blotter", s, l);
+            for (range.first..range.end) |i| {
+                g.beginListRow(l, range, @intCast(i), .{ .direction = .row });
+                g.widget("cell", .{ .width = 50 }) catch {};
+                g.end();
+            }
+            g.endVirtualList(l, range);
+            return range;
+        }
+    };
+
+    for (0..2) |_| {
+        try gui.beginFrame();
+        _ = ui.rows(gui, &list, style);
+        try gui.endFrame();
+    }
+    gui.setScrollOffset(list_hash, 0, 20 * 100);
+    try gui.beginFrame();
+    const before = ui.rows(gui, &list, style);
+    try gui.endFrame();
+
+    // Rows that stay in view keep their nodes (IDs count rows from 1, so
+    // this is the last row)
+    const kept_hash = ids.combine(row_base.indexed(before.end));
+    const kept_index = gui.widget_to_layout.get(kept_hash).?;
+    const relinks = gui.sibling_relinks;
+
+    // One row down: the row that entered, its cell, the window and the
+    // fixed-size list above it; no row that stayed in view
+    gui.setScrollOffset(list_hash, 0, 20 * 101);
+    try gui.beginFrame();
+    const after = ui.rows(gui, &list, style);
+    try std.testing.expectEqual(before.first + 1, after.first);
+    try std.testing.expectEqual(before.count(), after.count());
+    try std.testing.expectEqual(@as(usize, 4), gui.layout_engine.getDirtyCount());
+    try gui.endFrame();
+
+    try std.testing.expectEqual(kept_index, gui.widget_to_layout.get(kept_hash).?);
+    try std.testing.expectEqual(relinks, gui.sibling_relinks);
+    try std.testing.expectEqual(@as(usize, 0), gui.layout_engine.getDirtyCount());
+}
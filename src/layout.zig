@@ -11,16 +11,43 @@ const std = @import("std");
 // Core layout engine (data-oriented, cache-friendly)
 pub const LayoutEngine = @import("layout/engine.zig").LayoutEngine;
 
+// Content measurement for leaves (text, images)
+pub const MeasureFn = @import("layout/engine.zig").MeasureFn;
+
+// Uniform-grid spatial index over absolute rects (hit testing)
+pub const SpatialGrid = @import("layout/spatial.zig").SpatialGrid;
+
+// Changed regions after layout (LayoutEngine.collectDamage)
+pub const DamageList = @import("layout/damage.zig").DamageList;
+
+// Work-stealing pool for LayoutEngine.computeLayoutParallel (shared with
+// the software renderer's tiled path)
+pub const LayoutPool = @import("core/pool.zig").Pool;
+
 // Flexbox algorithm and types
 pub const FlexStyle = @import("layout/flexbox.zig").FlexStyle;
 pub const FlexDirection = @import("layout/flexbox.zig").FlexDirection;
 pub const JustifyContent = @import("layout/flexbox.zig").JustifyContent;
 pub const AlignItems = @import("layout/flexbox.zig").AlignItems;
+pub const FlexWrap = @import("layout/flexbox.zig").FlexWrap;
+pub const AlignContent = @import("layout/flexbox.zig").AlignContent;
+pub const Overflow = @import("layout/flexbox.zig").Overflow;
+pub const Position = @import("layout/flexbox.zig").Position;
 pub const LayoutResult = @import("layout/flexbox.zig").LayoutResult;
+pub const computeFlexLayout = @import("layout/flexbox.zig").computeFlexLayout;
+
+// Flexbox over other layout scalars (i32 pixels, Q16.16 for FPU-less cores)
+pub const Flexbox = @import("layout/flexbox.zig").Flexbox;
+pub const scalar = @import("layout/scalar.zig");
+
+// Vector kernels behind flex resolution (clamp, freeze loop, prefix sums)
+pub const simd = @import("layout/simd.zig");
 
 // Performance and debugging
 pub const CacheStats = @import("layout/cache.zig").CacheStats;
 pub const LayoutCacheEntry = @import("layout/cache.zig").LayoutCacheEntry;
+pub const SlotKind = @import("layout/cache.zig").SlotKind;
+pub const MeasureCacheEntry = @import("layout/cache.zig").MeasureCacheEntry;
 pub const DirtyBits = @import("layout/dirty_tracking.zig").DirtyBits;
 
 // Geometry types (from core)
@@ -1,71 +1,209 @@
 //! Layout Cache - Aggressive caching for layout results
 //!
 //! Research shows layout caching can provide 2-5x speedup for incremental updates.
-//! We cache layout results keyed by constraints and style version.
+//! We cache layout results keyed by constraints (available size + sizing
+//! mode per axis) and style version, with a few LRU slots per node.
 
 const std = @import("std");
 const Size = @import("../core/geometry.zig").Size;
 
-/// Cache entry for a single element's layout result
+/// How a constraint bounds one axis (Yoga/Taffy measure modes)
+pub const SizingMode = enum(u2) {
+    /// The node's own size is explicit; the available size is irrelevant
+    exact = 0,
+    /// Bounded by the available size (the usual case under a parent)
+    at_most = 1,
+    /// Unbounded: max-content probe
+    undefined = 2,
+};
+
+/// Statistics bucket a cache slot falls into
+pub const SlotKind = enum(u2) {
+    /// Both axes exact
+    exact = 0,
+    /// Final layout under parent-provided space
+    at_most = 1,
+    /// Intrinsic-size probe (some axis undefined)
+    max_content = 2,
+};
+
+/// Cache lookup key: available size plus sizing mode per axis.
+/// Available sizes are ignored for axes in undefined mode.
+pub const Constraint = struct {
+    available_width: f32,
+    available_height: f32,
+    width_mode: SizingMode,
+    height_mode: SizingMode,
+
+    pub fn kind(self: Constraint) SlotKind {
+        if (self.width_mode == .undefined or self.height_mode == .undefined) return .max_content;
+        if (self.width_mode == .exact and self.height_mode == .exact) return .exact;
+        return .at_most;
+    }
+
+    fn tag(self: Constraint) u8 {
+        return @as(u8, @intFromEnum(self.width_mode)) | (@as(u8, @intFromEnum(self.height_mode)) << 2);
+    }
+};
+
+/// Number of constraint slots per node
+pub const CACHE_SLOTS = 3;
+
+/// Multi-slot cache entry for a single element's layout results
 ///
-/// Memory: 48 bytes (fits in one cache line with other hot data)
+/// A node can be sized under several constraints in one pass (e.g. a
+/// max-content probe by its parent, then its final size). Each distinct
+/// constraint gets a slot; slots are kept in most-recently-used order and
+/// the least recently used one is evicted. All slots share the node's
+/// style version: a style change empties the entry.
+///
+/// One slot is additionally marked as the node's last full layout (its
+/// children were positioned for that constraint); containers can only skip
+/// re-laying out children when they hit that slot.
+///
+/// Memory: 64 bytes (one cache line)
 pub const LayoutCacheEntry = struct {
-    /// Input constraints hash (to detect cache invalidation)
+    /// Style version all slots were computed under
+    style_version: u64 = 0,
+
+    /// Slots, most recently used first
+    slots: [CACHE_SLOTS]Slot = undefined,
+    /// Sizing modes of each slot (width | height << 2 | LAYOUT_FLAG)
+    tags: [CACHE_SLOTS]u8 = undefined,
+    /// Number of filled slots
+    len: u8 = 0,
+    _padding: [4]u8 = undefined, // Pad to 64 bytes
+
+    const LAYOUT_FLAG: u8 = 0x80;
+    const MODE_MASK: u8 = 0x0F;
+
+    pub const Slot = struct {
+        available_width: f32,
+        available_height: f32,
+        computed_width: f32,
+        computed_height: f32,
+    };
+
+    /// Result of a cache probe
+    pub const Lookup = struct {
+        size: Size,
+        /// The hit slot holds the node's last full layout
+        is_layout: bool,
+    };
+
+    /// Find a slot for `constraint` (moves it to most-recently-used)
+    pub fn lookup(self: *LayoutCacheEntry, constraint: Constraint, style_ver: u64) ?Lookup {
+        if (self.style_version != style_ver) return null;
+
+        const tag = constraint.tag();
+        for (0..self.len) |i| {
+            if (self.tags[i] & MODE_MASK != tag) continue;
+            const slot = self.slots[i];
+            if (constraint.width_mode != .undefined and slot.available_width != constraint.available_width) continue;
+            if (constraint.height_mode != .undefined and slot.available_height != constraint.available_height) continue;
+
+            const slot_tag = self.tags[i];
+            self.promote(i);
+            return .{
+                .size = .{ .width = slot.computed_width, .height = slot.computed_height },
+                .is_layout = slot_tag & LAYOUT_FLAG != 0,
+            };
+        }
+        return null;
+    }
+
+    /// Record a result. `is_layout` marks it as the node's last full layout.
+    /// Returns true if a slot had to be evicted.
+    pub fn store(self: *LayoutCacheEntry, constraint: Constraint, style_ver: u64, size: Size, is_layout: bool) bool {
+        if (self.style_version != style_ver) {
+            self.style_version = style_ver;
+            self.len = 0;
+        }
+
+        const slot = Slot{
+            .available_width = constraint.available_width,
+            .available_height = constraint.available_height,
+            .computed_width = size.width,
+            .computed_height = size.height,
+        };
+        var tag = constraint.tag();
+
+        if (is_layout) {
+            // Only one slot describes the current positions of the children
+            for (self.tags[0..self.len]) |*t| t.* &= ~LAYOUT_FLAG;
+            tag |= LAYOUT_FLAG;
+        }
+
+        // Replace an existing slot for the same constraint
+        if (self.lookup(constraint, style_ver) != null) {
+            self.slots[0] = slot;
+            self.tags[0] = tag;
+            return false;
+        }
+
+        const evicted = self.len == CACHE_SLOTS;
+        if (!evicted) self.len += 1;
+        self.promote(self.len - 1);
+        self.slots[0] = slot;
+        self.tags[0] = tag;
+        return evicted;
+    }
+
+    /// Invalidate all slots
+    pub inline fn invalidate(self: *LayoutCacheEntry) void {
+        self.len = 0;
+    }
+
+    pub inline fn isEmpty(self: *const LayoutCacheEntry) bool {
+        return self.len == 0;
+    }
+
+    /// Move slot `i` to the front, shifting the more recent ones back
+    fn promote(self: *LayoutCacheEntry, i: usize) void {
+        if (i == 0) return;
+        const slot = self.slots[i];
+        const tag = self.tags[i];
+        std.mem.copyBackwards(Slot, self.slots[1 .. i + 1], self.slots[0..i]);
+        std.mem.copyBackwards(u8, self.tags[1 .. i + 1], self.tags[0..i]);
+        self.slots[0] = slot;
+        self.tags[0] = tag;
+    }
+};
+
+/// Memoized result of a node's measure callback (text, images, ...)
+///
+/// Keyed by available size and version: the callback reruns only when the space
+/// offered to the node or its content/style version changes.
+/// Version 0 never matches (engine versions start at 1).
+///
+/// Memory: 24 bytes
+pub const MeasureCacheEntry = struct {
     available_width: f32 = -1.0,
     available_height: f32 = -1.0,
+    version: u64 = 0,
+    width: f32 = 0,
+    height: f32 = 0,
 
-    /// Style version (incremented on style changes)
-    style_version: u64 = 0,
-
-    /// Cached layout result
-    computed_width: f32 = 0,
-    computed_height: f32 = 0,
-
-    /// Cache metadata
-    valid: bool = false,
-    _padding: [23]u8 = undefined,  // Pad to 48 bytes for cache efficiency
-
-    /// Check if cache entry is valid for given inputs
-    pub inline fn isValid(
-        self: *const LayoutCacheEntry,
-        avail_w: f32,
-        avail_h: f32,
-        style_ver: u64,
-    ) bool {
-        return self.valid and
+    pub inline fn isValid(self: *const MeasureCacheEntry, avail_w: f32, avail_h: f32, version: u64) bool {
+        return self.version == version and
                self.available_width == avail_w and
-               self.available_height == avail_h and
-               self.style_version == style_ver;
+               self.available_height == avail_h;
     }
 
-    /// Invalidate this cache entry
-    pub inline fn invalidate(self: *LayoutCacheEntry) void {
-        self.valid = false;
-    }
-
-    /// Update cache with new result
-    pub fn update(
-        self: *LayoutCacheEntry,
-        avail_w: f32,
-        avail_h: f32,
-        style_ver: u64,
-        result_w: f32,
-        result_h: f32,
-    ) void {
+    pub inline fn invalidate(self: *MeasureCacheEntry) void {
+        self.version = 0;
+    }
+
+    pub fn update(self: *MeasureCacheEntry, avail_w: f32, avail_h: f32, version: u64, size: Size) void {
         self.available_width = avail_w;
         self.available_height = avail_h;
-        self.style_version = style_ver;
-        self.computed_width = result_w;
-        self.computed_height = result_h;
-        self.valid = true;
+        self.version = version;
+        self.width = size.width;
+        self.height = size.height;
     }
 
-    /// Get cached size (assumes isValid check passed)
-    pub inline fn getSize(self: *const LayoutCacheEntry) Size {
-        return Size{
-            .width = self.computed_width,
-            .height = self.computed_height,
-        };
+    pub inline fn getSize(self: *const MeasureCacheEntry) Size {
+        return Size{ .width = self.width, .height = self.height };
     }
 };
 
@@ -74,6 +212,17 @@ pub const CacheStats = struct {
     hits: u64 = 0,
     misses: u64 = 0,
     invalidations: u64 = 0,
+    /// Style updates that matched the stored style and were not applied
+    style_writes_skipped: u64 = 0,
+    /// Measure callback invocations
+    measure_calls: u64 = 0,
+    /// Measurements answered from MeasureCacheEntry
+    measure_hits: u64 = 0,
+    /// Hits/misses per slot kind (indexed by SlotKind)
+    slot_hits: [3]u64 = .{ 0, 0, 0 },
+    slot_misses: [3]u64 = .{ 0, 0, 0 },
+    /// Slots replaced because all CACHE_SLOTS were in use
+    evictions: u64 = 0,
 
     pub fn reset(self: *CacheStats) void {
         self.* = .{};
@@ -87,10 +236,51 @@ pub const CacheStats = struct {
         self.misses += 1;
     }
 
+    pub fn recordSlotHit(self: *CacheStats, kind: SlotKind) void {
+        self.hits += 1;
+        self.slot_hits[@intFromEnum(kind)] += 1;
+    }
+
+    pub fn recordSlotMiss(self: *CacheStats, kind: SlotKind) void {
+        self.misses += 1;
+        self.slot_misses[@intFromEnum(kind)] += 1;
+    }
+
+    pub fn recordEviction(self: *CacheStats) void {
+        self.evictions += 1;
+    }
+
     pub fn recordInvalidation(self: *CacheStats) void {
         self.invalidations += 1;
     }
 
+    pub fn recordStyleSkip(self: *CacheStats) void {
+        self.style_writes_skipped += 1;
+    }
+
+    pub fn recordMeasureCall(self: *CacheStats) void {
+        self.measure_calls += 1;
+    }
+
+    pub fn recordMeasureHit(self: *CacheStats) void {
+        self.measure_hits += 1;
+    }
+
+    /// Add counts gathered elsewhere (e.g. by a parallel layout worker)
+    pub fn merge(self: *CacheStats, other: CacheStats) void {
+        self.hits += other.hits;
+        self.misses += other.misses;
+        self.invalidations += other.invalidations;
+        self.style_writes_skipped += other.style_writes_skipped;
+        self.measure_calls += other.measure_calls;
+        self.measure_hits += other.measure_hits;
+        for (0..3) |k| {
+            self.slot_hits[k] += other.slot_hits[k];
+            self.slot_misses[k] += other.slot_misses[k];
+        }
+        self.evictions += other.evictions;
+    }
+
     pub fn getHitRate(self: *const CacheStats) f32 {
         const total = self.hits + self.misses;
         if (total == 0) return 0;
@@ -101,48 +291,105 @@ pub const CacheStats = struct {
 comptime {
     // Verify cache entry size
     const size = @sizeOf(LayoutCacheEntry);
-    if (size != 48) {
+    if (size != 64) {
         @compileError(std.fmt.comptimePrint(
-            "LayoutCacheEntry size changed! Expected 48 bytes, got {} bytes",
+            "LayoutCacheEntry size changed! Expected 64 bytes, got {} bytes",
             .{size}
         ));
     }
+    if (@sizeOf(MeasureCacheEntry) != 24) {
+        @compileError("MeasureCacheEntry size changed! Expected 24 bytes");
+    }
+}
+
+fn atMost(w: f32, h: f32) Constraint {
+    return .{ .available_width = w, .available_height = h, .width_mode = .at_most, .height_mode = .at_most };
 }
 
 test "LayoutCacheEntry: basic operations" {
     var entry = LayoutCacheEntry{};
 
-    // Initially invalid
-    try std.testing.expect(!entry.isValid(100, 200, 1));
+    // Initially empty
+    try std.testing.expect(entry.lookup(atMost(100, 200), 1) == null);
+
+    _ = entry.store(atMost(100, 200), 1, .{ .width = 50, .height = 75 }, true);
+
+    const hit = entry.lookup(atMost(100, 200), 1).?;
+    try std.testing.expectEqual(@as(f32, 50), hit.size.width);
+    try std.testing.expectEqual(@as(f32, 75), hit.size.height);
+    try std.testing.expect(hit.is_layout);
+
+    // Different constraints = miss
+    try std.testing.expect(entry.lookup(atMost(150, 200), 1) == null);
+    try std.testing.expect(entry.lookup(atMost(100, 250), 1) == null);
+
+    // Same numbers, different mode = miss
+    try std.testing.expect(entry.lookup(.{ .available_width = 100, .available_height = 200, .width_mode = .exact, .height_mode = .at_most }, 1) == null);
+
+    // Different style version = miss
+    try std.testing.expect(entry.lookup(atMost(100, 200), 2) == null);
+}
+
+test "LayoutCacheEntry: probe and layout slots coexist" {
+    var entry = LayoutCacheEntry{};
+    const probe = Constraint{ .available_width = 0, .available_height = 300, .width_mode = .undefined, .height_mode = .at_most };
+
+    _ = entry.store(probe, 1, .{ .width = 120, .height = 40 }, false);
+    _ = entry.store(atMost(400, 300), 1, .{ .width = 400, .height = 40 }, true);
+
+    // Undefined axes ignore the available size
+    var other_probe = probe;
+    other_probe.available_width = 999;
+    const p = entry.lookup(other_probe, 1).?;
+    try std.testing.expectEqual(@as(f32, 120), p.size.width);
+    try std.testing.expect(!p.is_layout);
 
-    // Update cache
-    entry.update(100, 200, 1, 50, 75);
+    try std.testing.expect(entry.lookup(atMost(400, 300), 1).?.is_layout);
+}
 
-    // Now valid
-    try std.testing.expect(entry.isValid(100, 200, 1));
-    try std.testing.expect(entry.valid);
+test "LayoutCacheEntry: LRU eviction and single layout slot" {
+    var entry = LayoutCacheEntry{};
+    for (0..CACHE_SLOTS) |i| {
+        const w: f32 = @floatFromInt(100 * (i + 1));
+        try std.testing.expect(!entry.store(atMost(w, 100), 1, .{ .width = w, .height = 10 }, true));
+    }
 
-    const size = entry.getSize();
-    try std.testing.expectEqual(@as(f32, 50), size.width);
-    try std.testing.expectEqual(@as(f32, 75), size.height);
+    // Only the newest layout keeps the layout flag
+    try std.testing.expect(!entry.lookup(atMost(200, 100), 1).?.is_layout);
 
-    // Different constraints = invalid
-    try std.testing.expect(!entry.isValid(150, 200, 1));
-    try std.testing.expect(!entry.isValid(100, 250, 1));
+    // Touch 100: recency is now 100, 200, 300, so 300 is evicted next
+    _ = entry.lookup(atMost(100, 100), 1);
+    try std.testing.expect(entry.store(atMost(400, 100), 1, .{ .width = 400, .height = 10 }, false));
 
-    // Different style version = invalid
-    try std.testing.expect(!entry.isValid(100, 200, 2));
+    try std.testing.expect(entry.lookup(atMost(300, 100), 1) == null);
+    try std.testing.expect(entry.lookup(atMost(100, 100), 1) != null);
+    try std.testing.expect(entry.lookup(atMost(200, 100), 1) != null);
+    try std.testing.expect(entry.lookup(atMost(400, 100), 1) != null);
 }
 
 test "LayoutCacheEntry: invalidation" {
     var entry = LayoutCacheEntry{};
-    entry.update(100, 200, 1, 50, 75);
+    _ = entry.store(atMost(100, 200), 1, .{ .width = 50, .height = 75 }, true);
+    try std.testing.expect(!entry.isEmpty());
+
+    entry.invalidate();
+    try std.testing.expect(entry.isEmpty());
+    try std.testing.expect(entry.lookup(atMost(100, 200), 1) == null);
+}
+
+test "MeasureCacheEntry: keyed by constraints and version" {
+    var entry = MeasureCacheEntry{};
+    try std.testing.expect(!entry.isValid(-1, -1, 0));
+
+    entry.update(300, 100, 7, .{ .width = 42, .height = 16 });
+    try std.testing.expect(entry.isValid(300, 100, 7));
+    try std.testing.expectEqual(@as(f32, 42), entry.getSize().width);
 
-    try std.testing.expect(entry.valid);
+    try std.testing.expect(!entry.isValid(200, 100, 7));
+    try std.testing.expect(!entry.isValid(300, 100, 8));
 
     entry.invalidate();
-    try std.testing.expect(!entry.valid);
-    try std.testing.expect(!entry.isValid(100, 200, 1));
+    try std.testing.expect(!entry.isValid(300, 100, 7));
 }
 
 test "CacheStats: hit rate calculation" {
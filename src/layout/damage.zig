@@ -0,0 +1,161 @@
+//! Damage list - screen regions a renderer must repaint after layout
+//!
+//! For every node whose absolute rect changed, the layout engine adds where
+//! it was and where it is now. Rects that touch merge into their bounding
+//! box, and the list never holds more than MAX_REGIONS boxes: once full, a
+//! new rect is folded into the region that wastes the least area doing so.
+//!
+//! Regions over-cover (a bounding box repaints the gaps between the rects it
+//! absorbed) but never miss a changed pixel. A handful of boxes is cheap to
+//! scissor on a GPU and to clip a software rasterizer to.
+
+const std = @import("std");
+const geometry = @import("../core/geometry.zig");
+const Rect = geometry.Rect;
+
+/// Upper bound on regions; beyond it rects merge with the nearest region
+pub const MAX_REGIONS = 8;
+
+pub const DamageList = struct {
+    regions: [MAX_REGIONS]Rect = undefined,
+    len: u32 = 0,
+
+    /// Add a changed area (empty rects are ignored)
+    pub fn add(self: *DamageList, rect: Rect) void {
+        if (!(rect.width > 0 and rect.height > 0)) return;
+
+        var merged = rect;
+        while (true) {
+            // Absorb every region the rect touches; a grown box can reach
+            // regions it missed before, so rescan after each merge
+            var i: u32 = 0;
+            while (i < self.len) {
+                if (touches(self.regions[i], merged)) {
+                    merged = bounds(merged, self.regions[i]);
+                    self.removeAt(i);
+                    i = 0;
+                } else {
+                    i += 1;
+                }
+            }
+            if (self.len < MAX_REGIONS) break;
+
+            // Full: merge with the region whose shared box wastes the least
+            const nearest = self.cheapestMerge(merged);
+            merged = bounds(merged, self.regions[nearest]);
+            self.removeAt(nearest);
+        }
+
+        self.regions[self.len] = merged;
+        self.len += 1;
+    }
+
+    pub fn items(self: *const DamageList) []const Rect {
+        return self.regions[0..self.len];
+    }
+
+    pub fn isEmpty(self: *const DamageList) bool {
+        return self.len == 0;
+    }
+
+    pub fn clear(self: *DamageList) void {
+        self.len = 0;
+    }
+
+    fn removeAt(self: *DamageList, i: u32) void {
+        self.len -= 1;
+        self.regions[i] = self.regions[self.len];
+    }
+
+    fn cheapestMerge(self: *const DamageList, rect: Rect) u32 {
+        var best: u32 = 0;
+        var best_waste = std.math.inf(f32);
+        for (self.items(), 0..) |region, i| {
+            const waste = area(bounds(region, rect)) - area(region) - area(rect);
+            if (waste < best_waste) {
+                best_waste = waste;
+                best = @intCast(i);
+            }
+        }
+        return best;
+    }
+};
+
+/// Overlapping or sharing an edge (adjacent rows merge into one strip)
+fn touches(a: Rect, b: Rect) bool {
+    return a.x <= b.x + b.width and b.x <= a.x + a.width and
+        a.y <= b.y + b.height and b.y <= a.y + a.height;
+}
+
+fn bounds(a: Rect, b: Rect) Rect {
+    const x1 = @min(a.x, b.x);
+    const y1 = @min(a.y, b.y);
+    const x2 = @max(a.x + a.width, b.x + b.width);
+    const y2 = @max(a.y + a.height, b.y + b.height);
+    return .{ .x = x1, .y = y1, .width = x2 - x1, .height = y2 - y1 };
+}
+
+fn area(rect: Rect) f32 {
+    return rect.width * rect.height;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+fn covers(list: *const DamageList, rect: Rect) bool {
+    for (list.items()) |region| {
+        if (region.x <= rect.x and region.y <= rect.y and
+            region.x + region.width >= rect.x + rect.width and
+            region.y + region.height >= rect.y + rect.height) return true;
+    }
+    return false;
+}
+
+test "DamageList: touching rects merge, distant ones stay apart" {
+    var damage = DamageList{};
+
+    // Three stacked rows become one strip
+    damage.add(.{ .x = 0, .y = 0, .width = 100, .height = 20 });
+    damage.add(.{ .x = 0, .y = 40, .width = 100, .height = 20 });
+    damage.add(.{ .x = 0, .y = 20, .width = 100, .height = 20 });
+    try std.testing.expectEqual(@as(usize, 1), damage.items().len);
+    try std.testing.expectEqual(Rect{ .x = 0, .y = 0, .width = 100, .height = 60 }, damage.items()[0]);
+
+    // A status bar far below is its own region
+    damage.add(.{ .x = 0, .y = 580, .width = 800, .height = 20 });
+    try std.testing.expectEqual(@as(usize, 2), damage.items().len);
+
+    // Empty rects are not damage
+    damage.add(Rect.zero());
+    try std.testing.expectEqual(@as(usize, 2), damage.items().len);
+
+    damage.clear();
+    try std.testing.expect(damage.isEmpty());
+}
+
+test "DamageList: stays bounded and covers everything added" {
+    var damage = DamageList{};
+    var added: [40]Rect = undefined;
+
+    var prng = std.Random.DefaultPrng.init(0xda3a6e);
+    const random = prng.random();
+    for (&added) |*rect| {
+        rect.* = .{
+            .x = @floatFromInt(random.uintLessThan(u32, 1000)),
+            .y = @floatFromInt(random.uintLessThan(u32, 1000)),
+            .width = @floatFromInt(random.intRangeAtMost(u32, 1, 30)),
+            .height = @floatFromInt(random.intRangeAtMost(u32, 1, 30)),
+        };
+        damage.add(rect.*);
+        try std.testing.expect(damage.items().len <= MAX_REGIONS);
+    }
+
+    for (added) |rect| try std.testing.expect(covers(&damage, rect));
+
+    // No two regions touch: merging is complete
+    const regions = damage.items();
+    for (regions, 0..) |a, i| {
+        for (regions[i + 1 ..]) |b| try std.testing.expect(!touches(a, b));
+    }
+}
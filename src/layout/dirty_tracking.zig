@@ -8,6 +8,14 @@
 //! - Pass 2 (top-down): Traverse from root, recursing only into dirty subtrees
 //!   or children whose size changed.
 //!
+//! The layout engine keeps three independent DirtyBits:
+//! - size: style/content changed, flexbox must rerun (algorithm above)
+//! - position: only the node's origin moved (parent relayout placed it
+//!   elsewhere, or its translation changed). No propagation: the bit marks
+//!   a subtree whose absolute positions are recomputed lazily.
+//! - moved: set per node when its absolute rect is recomputed, cleared by
+//!   whoever mirrors rects elsewhere (spatial index, damage tracking).
+//!
 //! We evaluated Spineless Traversal (https://arxiv.org/html/2411.10659v8) which
 //! achieves 1.8x speedup in browser engines. However, it requires an order
 //! maintenance data structure, adding memory and complexity. For UI toolkit
@@ -15,64 +23,144 @@
 
 const std = @import("std");
 
-/// Maximum number of elements that can be tracked
-/// Configured via build option: -Dmax_layout_elements=N
-const build_options = @import("build_options");
-pub const MAX_CAPACITY: u32 = build_options.max_layout_elements;
-
 /// Two-Pass Dirty Bits
 ///
 /// Simple bitset for tracking which nodes need layout recomputation.
-/// Memory: MAX_CAPACITY / 8 bytes (e.g., 512 bytes for 4096 elements)
+/// The masks live in the layout engine's storage block so the bitset grows
+/// with the engine's capacity.
+/// Memory: capacity / 8 bytes (e.g., 512 bytes for 4096 elements)
 pub const DirtyBits = struct {
+    pub const MaskInt = usize;
+    const ShiftInt = std.math.Log2Int(MaskInt);
+    const mask_bits = @bitSizeOf(MaskInt);
+
     /// Bitset of dirty nodes
-    bits: std.StaticBitSet(MAX_CAPACITY),
+    masks: []MaskInt,
+    bit_length: u32,
 
     /// Statistics for performance analysis
     total_marks: u64 = 0,
     total_clears: u64 = 0,
 
-    pub fn init() DirtyBits {
+    /// Number of masks needed to track `bit_length` nodes
+    pub fn maskCount(bit_length: u32) usize {
+        return (@as(usize, bit_length) + mask_bits - 1) / mask_bits;
+    }
+
+    /// Create an empty bitset over caller-provided masks
+    pub fn init(masks: []MaskInt, bit_length: u32) DirtyBits {
+        const count = maskCount(bit_length);
+        std.debug.assert(masks.len >= count);
+        @memset(masks[0..count], 0);
         return .{
-            .bits = std.StaticBitSet(MAX_CAPACITY).initEmpty(),
+            .masks = masks[0..count],
+            .bit_length = bit_length,
         };
     }
 
+    /// Move to larger masks (after storage growth), keeping current bits
+    pub fn rebind(self: *DirtyBits, masks: []MaskInt, bit_length: u32) void {
+        std.debug.assert(bit_length >= self.bit_length);
+        const count = maskCount(bit_length);
+        std.debug.assert(masks.len >= count);
+        @memcpy(masks[0..self.masks.len], self.masks);
+        @memset(masks[self.masks.len..count], 0);
+        self.masks = masks[0..count];
+        self.bit_length = bit_length;
+    }
+
+    inline fn bit(index: u32) MaskInt {
+        return @as(MaskInt, 1) << @as(ShiftInt, @truncate(index));
+    }
+
     /// Mark a node as dirty (O(1) operation)
     pub inline fn markDirty(self: *DirtyBits, index: u32) void {
-        std.debug.assert(index < MAX_CAPACITY);
-        if (!self.bits.isSet(index)) {
-            self.bits.set(index);
+        std.debug.assert(index < self.bit_length);
+        const mask = &self.masks[index / mask_bits];
+        if (mask.* & bit(index) == 0) {
+            mask.* |= bit(index);
             self.total_marks += 1;
         }
     }
 
     /// Check if a node is dirty
     pub inline fn isDirty(self: *const DirtyBits, index: u32) bool {
-        std.debug.assert(index < MAX_CAPACITY);
-        return self.bits.isSet(index);
+        std.debug.assert(index < self.bit_length);
+        return self.masks[index / mask_bits] & bit(index) != 0;
     }
 
     /// Clear dirty bit for a single node (called during top-down pass)
     pub inline fn clearDirty(self: *DirtyBits, index: u32) void {
-        std.debug.assert(index < MAX_CAPACITY);
-        self.bits.unset(index);
+        std.debug.assert(index < self.bit_length);
+        self.masks[index / mask_bits] &= ~bit(index);
+    }
+
+    /// Clear bits [first, end) a word at a time (bulk removal)
+    pub fn clearRange(self: *DirtyBits, first: u32, end: u32) void {
+        std.debug.assert(first <= end and end <= self.bit_length);
+        var index = first;
+        while (index < end) {
+            const word = index / mask_bits;
+            const word_end = @min((word + 1) * mask_bits, end);
+            const span = word_end - index;
+            const ones: MaskInt = if (span == mask_bits) ~@as(MaskInt, 0) else (@as(MaskInt, 1) << @as(ShiftInt, @intCast(span))) - 1;
+            self.masks[word] &= ~(ones << @as(ShiftInt, @truncate(index)));
+            index = word_end;
+        }
+    }
+
+    /// Atomic variants for parallel layout, where workers own disjoint
+    /// subtrees whose bits may still share a mask word
+    pub inline fn clearDirtyAtomic(self: *DirtyBits, index: u32) void {
+        std.debug.assert(index < self.bit_length);
+        _ = @atomicRmw(MaskInt, &self.masks[index / mask_bits], .And, ~bit(index), .monotonic);
+    }
+
+    pub inline fn markDirtyAtomic(self: *DirtyBits, index: u32) void {
+        std.debug.assert(index < self.bit_length);
+        _ = @atomicRmw(MaskInt, &self.masks[index / mask_bits], .Or, bit(index), .monotonic);
+    }
+
+    pub inline fn isDirtyAtomic(self: *const DirtyBits, index: u32) bool {
+        std.debug.assert(index < self.bit_length);
+        return @atomicLoad(MaskInt, &self.masks[index / mask_bits], .monotonic) & bit(index) != 0;
+    }
+
+    /// First dirty index >= start (word-at-a-time scan)
+    pub fn nextDirty(self: *const DirtyBits, start: u32) ?u32 {
+        if (start >= self.bit_length) return null;
+
+        var word = start / mask_bits;
+        var mask = self.masks[word] & (~@as(MaskInt, 0) << @as(ShiftInt, @truncate(start)));
+        while (true) {
+            if (mask != 0) return @intCast(word * mask_bits + @ctz(mask));
+            word += 1;
+            if (word >= self.masks.len) return null;
+            mask = self.masks[word];
+        }
     }
 
     /// Clear all dirty bits (called after full layout)
     pub fn clearAll(self: *DirtyBits) void {
-        self.bits = std.StaticBitSet(MAX_CAPACITY).initEmpty();
+        @memset(self.masks, 0);
         self.total_clears += 1;
     }
 
     /// Check if any node is dirty
     pub inline fn anyDirty(self: *const DirtyBits) bool {
-        return self.bits.count() > 0;
+        for (self.masks) |mask| {
+            if (mask != 0) return true;
+        }
+        return false;
     }
 
     /// Get count of dirty nodes (for diagnostics)
     pub inline fn dirtyCount(self: *const DirtyBits) usize {
-        return self.bits.count();
+        var count: usize = 0;
+        for (self.masks) |mask| {
+            count += @popCount(mask);
+        }
+        return count;
     }
 
     /// Reset statistics
@@ -87,7 +175,8 @@ pub const DirtyBits = struct {
 // ============================================================================
 
 test "DirtyBits: basic operations" {
-    var dirty = DirtyBits.init();
+    var masks: [DirtyBits.maskCount(64)]DirtyBits.MaskInt = undefined;
+    var dirty = DirtyBits.init(&masks, 64);
 
     // Initially empty
     try std.testing.expect(!dirty.isDirty(0));
@@ -109,7 +198,8 @@ test "DirtyBits: basic operations" {
 }
 
 test "DirtyBits: clearDirty" {
-    var dirty = DirtyBits.init();
+    var masks: [DirtyBits.maskCount(64)]DirtyBits.MaskInt = undefined;
+    var dirty = DirtyBits.init(&masks, 64);
 
     dirty.markDirty(10);
     dirty.markDirty(20);
@@ -122,7 +212,8 @@ test "DirtyBits: clearDirty" {
 }
 
 test "DirtyBits: clearAll" {
-    var dirty = DirtyBits.init();
+    var masks: [DirtyBits.maskCount(64)]DirtyBits.MaskInt = undefined;
+    var dirty = DirtyBits.init(&masks, 64);
 
     dirty.markDirty(5);
     dirty.markDirty(10);
@@ -137,7 +228,8 @@ test "DirtyBits: clearAll" {
 }
 
 test "DirtyBits: duplicate marking is idempotent" {
-    var dirty = DirtyBits.init();
+    var masks: [DirtyBits.maskCount(64)]DirtyBits.MaskInt = undefined;
+    var dirty = DirtyBits.init(&masks, 64);
 
     dirty.markDirty(10);
     dirty.markDirty(10);
@@ -151,7 +243,8 @@ test "DirtyBits: duplicate marking is idempotent" {
 }
 
 test "DirtyBits: statistics" {
-    var dirty = DirtyBits.init();
+    var masks: [DirtyBits.maskCount(64)]DirtyBits.MaskInt = undefined;
+    var dirty = DirtyBits.init(&masks, 64);
 
     dirty.markDirty(1);
     dirty.markDirty(2);
@@ -162,3 +255,69 @@ test "DirtyBits: statistics" {
     try std.testing.expectEqual(@as(u64, 3), dirty.total_marks);
     try std.testing.expectEqual(@as(u64, 2), dirty.total_clears);
 }
+
+test "DirtyBits: nextDirty scans set bits in order" {
+    var masks: [DirtyBits.maskCount(200)]DirtyBits.MaskInt = undefined;
+    var dirty = DirtyBits.init(&masks, 200);
+
+    try std.testing.expectEqual(@as(?u32, null), dirty.nextDirty(0));
+
+    dirty.markDirty(3);
+    dirty.markDirty(64);
+    dirty.markDirty(199);
+
+    try std.testing.expectEqual(@as(?u32, 3), dirty.nextDirty(0));
+    try std.testing.expectEqual(@as(?u32, 64), dirty.nextDirty(4));
+    try std.testing.expectEqual(@as(?u32, 199), dirty.nextDirty(65));
+    try std.testing.expectEqual(@as(?u32, null), dirty.nextDirty(200));
+}
+
+test "DirtyBits: clearRange spans word boundaries" {
+    var masks: [DirtyBits.maskCount(200)]DirtyBits.MaskInt = undefined;
+    var dirty = DirtyBits.init(&masks, 200);
+    for (0..200) |i| dirty.markDirty(@intCast(i));
+
+    dirty.clearRange(10, 150);
+    dirty.clearRange(192, 200);
+    dirty.clearRange(5, 5);
+
+    try std.testing.expect(dirty.isDirty(9));
+    try std.testing.expect(!dirty.isDirty(10));
+    try std.testing.expect(!dirty.isDirty(64));
+    try std.testing.expect(!dirty.isDirty(149));
+    try std.testing.expect(dirty.isDirty(150));
+    try std.testing.expect(dirty.isDirty(191));
+    try std.testing.expectEqual(@as(usize, 200 - 140 - 8), dirty.dirtyCount());
+}
+
+test "DirtyBits: rebind keeps bits when growing" {
+    var small: [DirtyBits.maskCount(64)]DirtyBits.MaskInt = undefined;
+    var dirty = DirtyBits.init(&small, 64);
+    dirty.markDirty(3);
+    dirty.markDirty(63);
+
+    var large: [DirtyBits.maskCount(256)]DirtyBits.MaskInt = undefined;
+    dirty.rebind(&large, 256);
+
+    try std.testing.expect(dirty.isDirty(3));
+    try std.testing.expect(dirty.isDirty(63));
+    try std.testing.expect(!dirty.isDirty(200));
+    try std.testing.expectEqual(@as(usize, 2), dirty.dirtyCount());
+
+    dirty.markDirty(200);
+    try std.testing.expect(dirty.isDirty(200));
+}
+
+test "DirtyBits: atomic mark and clear" {
+    var masks: [DirtyBits.maskCount(128)]DirtyBits.MaskInt = undefined;
+    var dirty = DirtyBits.init(&masks, 128);
+
+    dirty.markDirtyAtomic(7);
+    dirty.markDirtyAtomic(100);
+    try std.testing.expect(dirty.isDirtyAtomic(7));
+    try std.testing.expect(dirty.isDirty(100));
+
+    dirty.clearDirtyAtomic(7);
+    try std.testing.expect(!dirty.isDirty(7));
+    try std.testing.expectEqual(@as(usize, 1), dirty.dirtyCount());
+}
@@ -17,19 +17,53 @@
 //! ## Optimizations
 //!
 //! - SIMD constraint clamping (vectorized min/max)
-//! - Layout caching (skip unchanged elements)
+//! - Layout caching: a few LRU slots per node keyed by constraint and
+//!   sizing mode, so max-content probes and final layouts both hit
+//! - Measure callbacks for content-sized leaves, memoized per node
 //! - SoA data layout (cache-friendly traversal)
 //! - Free list recycling (no allocation churn)
+//! - compact(): renumber into depth-first families so children are
+//!   gathered with linear scans instead of sibling-link chasing
+//! - Parallel mode: fixed-size subtrees on a work-stealing pool (core/pool.zig)
 //!
-//! ## Embedded Configuration
+//! ## Positions
 //!
-//! For embedded systems with limited RAM, configure at build time:
-//!   zig build -Dmax_layout_elements=64
+//! computed_rects hold flexbox output relative to the parent. Each node also
+//! carries a translation (setOffset) that moves its subtree without affecting
+//! layout - dragged panels, scrolled content. Absolute positions are a lazy
+//! column: a second dirty class (position_dirty) marks subtrees whose
+//! origin moved, and getAbsoluteRect() refreshes just those subtrees on
+//! demand. Moving a panel is O(subtree) adds instead of a flexbox pass.
 //!
-//! Memory usage scales with max_layout_elements:
-//!   - 64 elements:  ~9KB (fits in 32KB embedded)
-//!   - 256 elements: ~36KB
-//!   - 4096 elements (default): ~580KB
+//! Every node whose absolute rect is recomputed also lands in a third class
+//! (moved) until the consumer calls clearMoved(). Spatial indexes and
+//! damage tracking walk nextMoved() instead of the whole tree.
+//!
+//! collectDamage() turns moved nodes into a damage list (damage.zig): the
+//! rect each node was last reported at and the one it has now, merged into
+//! at most MAX_DAMAGE_REGIONS boxes. Removed nodes add their last reported
+//! rect. Renderers repaint those boxes instead of the whole window.
+//!
+//! Scroll containers (overflow = .scroll) lay their content out once at its
+//! natural size and record its extent (getContentSize). Their scroll offset
+//! is one more translation, applied to the children only: setScrollOffset
+//! marks the container position-dirty and never touches size dirty bits, so
+//! scrolling runs at input rate with no relayout.
+//!
+//! ## Storage
+//!
+//! All per-node columns live in one contiguous block sized by capacity:
+//!   - init()/initOptions(): heap block, grows in power-of-two steps when full
+//!   - initFixed()/initBuffer(): caller-owned block, fixed capacity, no heap
+//!
+//! Memory usage is ~270 bytes per node of capacity (checked by the
+//! "storage size matches the documented figures" test):
+//!   - 64 nodes:   ~17KB (fits in 32KB embedded)
+//!   - 256 nodes:  ~69KB
+//!   - 4096 nodes: ~1.1MB
+//!
+//! The build option -Dmax_layout_elements=N sets MAX_ELEMENTS, the capacity
+//! used by FixedStorage(MAX_ELEMENTS) on no-allocator targets.
 
 const std = @import("std");
 const build_options = @import("build_options");
@@ -37,23 +71,163 @@ const flexbox = @import("flexbox.zig");
 const cache = @import("cache.zig");
 const dirty_tracking = @import("dirty_tracking.zig");
 const simd = @import("simd.zig");
+const thread_pool = @import("../core/pool.zig");
+const damage = @import("damage.zig");
 const geometry = @import("../core/geometry.zig");
 
 const Rect = geometry.Rect;
 const Size = geometry.Size;
+const Point = geometry.Point;
 const FlexStyle = flexbox.FlexStyle;
 const LayoutResult = flexbox.LayoutResult;
 const LayoutCacheEntry = cache.LayoutCacheEntry;
+const MeasureCacheEntry = cache.MeasureCacheEntry;
+const Constraint = cache.Constraint;
+const SizingMode = cache.SizingMode;
 const CacheStats = cache.CacheStats;
 const DirtyBits = dirty_tracking.DirtyBits;
+const DamageList = damage.DamageList;
 
-/// Maximum number of elements in the layout tree
+/// Most regions collectDamage() reports (more changes merge into them)
+pub const MAX_DAMAGE_REGIONS = damage.MAX_REGIONS;
+
+/// Capacity of the build-time fixed-storage variant
 /// Configurable via build option: -Dmax_layout_elements=N
 pub const MAX_ELEMENTS: u32 = build_options.max_layout_elements;
 
+/// Upper bound for growable engines (indices must stay below NULL_INDEX)
+pub const MAX_CAPACITY: u32 = 1 << 31;
+
+/// Initial capacity of heap-backed engines created with init()
+pub const DEFAULT_INITIAL_CAPACITY: u32 = 64;
+
 /// Null index sentinel
 const NULL_INDEX: u32 = 0xFFFFFFFF;
 
+/// Marks recycled slots while compacting
+const FREE_SLOT: u32 = NULL_INDEX - 1;
+
+/// Marks visited entries of compact's in-place permutation (indices stay
+/// below MAX_CAPACITY, so the top bit is free)
+const PERMUTED: u32 = 1 << 31;
+
+/// Measure callback for leaves whose size depends on content (text, images).
+/// Receives the space available to the node and returns its content size.
+/// Results are memoized: the callback only reruns when the available space
+/// or the node's content version changes (see markContentDirty).
+pub const MeasureFn = *const fn (context: ?*anyopaque, index: u32, available_width: f32, available_height: f32) Size;
+
+/// Per-node measure callback and its user context
+pub const Measure = struct {
+    func: ?MeasureFn = null,
+    context: ?*anyopaque = null,
+};
+
+/// SoA columns packed into the storage block, in block order.
+/// Largest alignment first so consecutive columns need no padding.
+const columns = .{
+    .{ "style_versions", u64 },
+    .{ "layout_cache", LayoutCacheEntry },
+    .{ "measure_cache", MeasureCacheEntry },
+    .{ "measures", Measure },
+    .{ "flex_styles", FlexStyle },
+    .{ "computed_rects", Rect },
+    .{ "reported_rects", Rect },
+    .{ "offsets", Point },
+    .{ "absolute_positions", Point },
+    .{ "scroll_offsets", Point },
+    .{ "content_sizes", Size },
+    .{ "parent", u32 },
+    .{ "first_child", u32 },
+    .{ "next_sibling", u32 },
+    .{ "child_count", u16 },
+};
+
+/// Alignment of the storage block (strictest column)
+pub const STORAGE_ALIGN = blk: {
+    var alignment = @alignOf(DirtyBits.MaskInt);
+    inline for (columns) |col| alignment = @max(alignment, @alignOf(col[1]));
+    break :blk alignment;
+};
+
+/// Bytes needed to back a layout engine of the given capacity
+pub fn storageSize(capacity: u32) usize {
+    var offset: usize = 0;
+    inline for (columns) |col| {
+        offset = std.mem.alignForward(usize, offset, @alignOf(col[1])) + @sizeOf(col[1]) * @as(usize, capacity);
+    }
+    // Free list
+    offset = std.mem.alignForward(usize, offset, @alignOf(u32)) + @sizeOf(u32) * @as(usize, capacity);
+    // Dirty bits (size, position and moved classes)
+    offset = std.mem.alignForward(usize, offset, @alignOf(DirtyBits.MaskInt)) +
+        @sizeOf(DirtyBits.MaskInt) * DirtyBits.maskCount(capacity) * 3;
+    return offset;
+}
+
+/// Carve the next column out of the storage block
+fn takeColumn(comptime T: type, block: []align(STORAGE_ALIGN) u8, offset: *usize, len: usize) []T {
+    offset.* = std.mem.alignForward(usize, offset.*, @alignOf(T));
+    const bytes = block[offset.*..][0 .. len * @sizeOf(T)];
+    offset.* += bytes.len;
+    return @as([*]T, @ptrCast(@alignCast(bytes.ptr)))[0..len];
+}
+
+/// LIFO stack of recycled indices (backed by a storage column)
+const FreeList = struct {
+    buffer: []u32,
+    len: usize = 0,
+
+    fn push(self: *FreeList, index: u32) void {
+        self.buffer[self.len] = index;
+        self.len += 1;
+    }
+
+    fn pop(self: *FreeList) ?u32 {
+        if (self.len == 0) return null;
+        self.len -= 1;
+        return self.buffer[self.len];
+    }
+};
+
+/// Per-thread state for one layout pass
+const Scratch = struct {
+    /// Temporary storage for containers with more than STACK_CHILDREN_MAX children
+    allocator: std.mem.Allocator,
+    stats: *CacheStats,
+    /// Other threads touch the dirty bits concurrently (use atomic ops)
+    shared: bool = false,
+    /// Parallel mode: fixed-size subtrees are queued here instead of recursed into
+    deferred: ?*std.ArrayListUnmanaged(thread_pool.Task) = null,
+    /// Running on a pool worker: nested fixed-size subtrees are spawned on it
+    worker: ?*thread_pool.Worker = null,
+
+    fn defersSubtrees(self: *const Scratch) bool {
+        return self.deferred != null or self.worker != null;
+    }
+
+    fn deferSubtree(self: *Scratch, index: u32, size: Size) !void {
+        const task = subtreeTask(index, size);
+        if (self.worker) |worker| return worker.spawn(task);
+        try self.deferred.?.append(self.allocator, task);
+    }
+};
+
+/// Pool task payload of a subtree: the size its parent gave it
+const SubtreeSize = packed struct(u64) {
+    width: f32,
+    height: f32,
+};
+
+fn subtreeTask(index: u32, size: Size) thread_pool.Task {
+    return .{ .index = index, .payload = @bitCast(SubtreeSize{ .width = size.width, .height = size.height }) };
+}
+
+/// Context of one pool run: worker w records cache statistics in stats[w]
+const PoolRun = struct {
+    engine: *LayoutEngine,
+    stats: []CacheStats,
+};
+
 /// Stack buffer size for small child counts (avoids heap allocation)
 const STACK_CHILDREN_MAX: usize = 32;
 
@@ -65,6 +239,39 @@ fn isFixedSize(style: FlexStyle) bool {
     return style.width >= 0 and style.height >= 0;
 }
 
+/// Out of the parent's flow: not in its flex pass, not in its content size
+fn isAbsolute(style: FlexStyle) bool {
+    return style.position == .absolute;
+}
+
+/// Inset set (auto insets are unbounded)
+fn isInset(inset: f32) bool {
+    return std.math.isFinite(inset);
+}
+
+/// Offset of an absolute box of `size` in a padding box of `box` on one axis
+fn insetOffset(start: f32, end: f32, box: f32, size: f32) f32 {
+    if (isInset(start)) return start;
+    if (isInset(end)) return box - end - size;
+    return 0;
+}
+
+/// Sizing mode of one axis: explicit size, bounded by available space, or unbounded
+fn axisMode(size: f32, available: f32) SizingMode {
+    if (size >= 0) return .exact;
+    return if (std.math.isFinite(available)) .at_most else .undefined;
+}
+
+/// Cache key for laying out a node with `style` in the given space
+fn layoutConstraint(style: FlexStyle, available_width: f32, available_height: f32) Constraint {
+    return .{
+        .available_width = if (style.width >= 0) style.width else available_width,
+        .available_height = if (style.height >= 0) style.height else available_height,
+        .width_mode = axisMode(style.width, available_width),
+        .height_mode = axisMode(style.height, available_height),
+    };
+}
+
 /// Check if two sizes are approximately equal (within epsilon)
 fn sizesApproxEqual(a: Size, b: Size) bool {
     return @abs(a.width - b.width) < SIZE_EPSILON and
@@ -76,63 +283,148 @@ pub const LayoutEngine = struct {
     allocator: std.mem.Allocator,
     arena: std.heap.ArenaAllocator,
 
+    // =========================================================================
+    // Storage (one contiguous block backs every column below)
+    // =========================================================================
+    storage: []align(STORAGE_ALIGN) u8,
+    capacity: u32,
+    growable: bool,
+    owns_storage: bool,
+
     // =========================================================================
     // Tree structure (hot data - frequently accessed during traversal)
     // =========================================================================
-    parent: [MAX_ELEMENTS]u32,
-    first_child: [MAX_ELEMENTS]u32,
-    next_sibling: [MAX_ELEMENTS]u32,
-    child_count: [MAX_ELEMENTS]u16,
+    parent: []u32 = undefined,
+    first_child: []u32 = undefined,
+    next_sibling: []u32 = undefined,
+    child_count: []u16 = undefined,
 
     // =========================================================================
     // Layout state (hot data)
     // =========================================================================
-    flex_styles: [MAX_ELEMENTS]FlexStyle,
-    computed_rects: [MAX_ELEMENTS]Rect,
-    style_versions: [MAX_ELEMENTS]u64,
+    flex_styles: []FlexStyle = undefined,
+    computed_rects: []Rect = undefined,
+    style_versions: []u64 = undefined,
+
+    // =========================================================================
+    // Positions (translation per node, lazily resolved absolute origins)
+    // =========================================================================
+    offsets: []Point = undefined,
+    absolute_positions: []Point = undefined,
+    /// Translation of a scroll container's children (content coordinates
+    /// of the viewport's top-left corner)
+    scroll_offsets: []Point = undefined,
+    /// Extent of a container's children plus padding, from the last layout
+    content_sizes: []Size = undefined,
+    /// Absolute rect as of the last collectDamage() (zero until reported)
+    reported_rects: []Rect = undefined,
+
+    /// Regions changed since the last clearDamage()
+    damage_list: DamageList = .{},
 
     // =========================================================================
     // Cache (warm data - accessed on cache hit)
     // =========================================================================
-    layout_cache: [MAX_ELEMENTS]LayoutCacheEntry,
+    layout_cache: []LayoutCacheEntry = undefined,
+    measure_cache: []MeasureCacheEntry = undefined,
+
+    // =========================================================================
+    // Content measurement (cold unless the node has a callback)
+    // =========================================================================
+    measures: []Measure = undefined,
 
     // =========================================================================
     // Dirty tracking (two-pass algorithm)
     // =========================================================================
-    dirty_bits: DirtyBits,
+    dirty_bits: DirtyBits = undefined,
+    /// Subtrees whose absolute positions are stale (no relayout needed)
+    position_dirty: DirtyBits = undefined,
+    /// Nodes whose absolute rect was recomputed since the last clearMoved()
+    moved: DirtyBits = undefined,
 
     // =========================================================================
     // Metadata
     // =========================================================================
-    element_count: u32,
-    global_style_version: u64,
-    cache_stats: CacheStats,
-    free_list: std.BoundedArray(u32, MAX_ELEMENTS),
+    element_count: u32 = 0,
+    global_style_version: u64 = 1,
+    cache_stats: CacheStats = .{},
+    free_list: FreeList = undefined,
+
+    /// Every node's children sit at consecutive indices (set by compact(),
+    /// cleared by structural changes). Enables linear child gathering.
+    children_contiguous: bool = false,
+
+    /// Options for heap-backed engines
+    pub const Options = struct {
+        /// Node capacity allocated up front
+        initial_capacity: u32 = DEFAULT_INITIAL_CAPACITY,
+        /// Grow to the next power of two when full (false = hard cap)
+        growable: bool = true,
+    };
+
+    /// Caller-owned backing memory for a fixed-capacity engine.
+    ///
+    /// Example (no heap for node data):
+    /// ```zig
+    /// var storage: LayoutEngine.FixedStorage(64) = .{};
+    /// var engine = LayoutEngine.initFixed(scratch_allocator, &storage);
+    /// ```
+    pub fn FixedStorage(comptime capacity: u32) type {
+        return struct {
+            pub const node_capacity = capacity;
+            bytes: [storageSize(capacity)]u8 align(STORAGE_ALIGN) = undefined,
+        };
+    }
 
+    /// Heap-backed engine that starts small and grows on demand
     pub fn init(allocator: std.mem.Allocator) !LayoutEngine {
-        const arena = std.heap.ArenaAllocator.init(allocator);
-
-        return LayoutEngine{
-            .allocator = allocator,
-            .arena = arena,
-            .parent = [_]u32{NULL_INDEX} ** MAX_ELEMENTS,
-            .first_child = [_]u32{NULL_INDEX} ** MAX_ELEMENTS,
-            .next_sibling = [_]u32{NULL_INDEX} ** MAX_ELEMENTS,
-            .child_count = [_]u16{0} ** MAX_ELEMENTS,
-            .flex_styles = [_]FlexStyle{.{}} ** MAX_ELEMENTS,
-            .computed_rects = [_]Rect{Rect.zero()} ** MAX_ELEMENTS,
-            .style_versions = [_]u64{0} ** MAX_ELEMENTS,
-            .layout_cache = [_]LayoutCacheEntry{.{}} ** MAX_ELEMENTS,
-            .dirty_bits = DirtyBits.init(),
-            .element_count = 0,
-            .global_style_version = 1,
-            .cache_stats = .{},
-            .free_list = .{},
+        return initOptions(allocator, .{});
+    }
+
+    /// Heap-backed engine with explicit capacity/growth policy
+    pub fn initOptions(allocator: std.mem.Allocator, options: Options) !LayoutEngine {
+        const capacity = std.math.clamp(options.initial_capacity, 1, MAX_CAPACITY);
+        const block = try allocator.alignedAlloc(u8, STORAGE_ALIGN, storageSize(capacity));
+
+        var engine = initBuffer(allocator, block, capacity);
+        engine.growable = options.growable;
+        engine.owns_storage = true;
+        return engine;
+    }
+
+    /// Fixed-capacity engine over comptime-sized storage (see FixedStorage)
+    pub fn initFixed(scratch_allocator: std.mem.Allocator, storage: anytype) LayoutEngine {
+        const capacity = @TypeOf(storage.*).node_capacity;
+        return initBuffer(scratch_allocator, &storage.bytes, capacity);
+    }
+
+    /// Fixed-capacity engine over a caller-owned block of storageSize(capacity) bytes.
+    /// `scratch_allocator` only backs the per-frame arena used for containers
+    /// with more than STACK_CHILDREN_MAX children.
+    pub fn initBuffer(scratch_allocator: std.mem.Allocator, block: []align(STORAGE_ALIGN) u8, capacity: u32) LayoutEngine {
+        std.debug.assert(block.len >= storageSize(capacity));
+
+        var engine = LayoutEngine{
+            .allocator = scratch_allocator,
+            .arena = std.heap.ArenaAllocator.init(scratch_allocator),
+            .storage = block,
+            .capacity = capacity,
+            .growable = false,
+            .owns_storage = false,
+            .free_list = .{ .buffer = undefined },
         };
+        const masks = engine.bindStorage(block, capacity);
+        engine.dirty_bits = DirtyBits.init(masks.size, capacity);
+        engine.position_dirty = DirtyBits.init(masks.position, capacity);
+        engine.moved = DirtyBits.init(masks.moved, capacity);
+        return engine;
     }
 
     pub fn deinit(self: *LayoutEngine) void {
         self.arena.deinit();
+        if (self.owns_storage) {
+            self.allocator.free(self.storage);
+        }
     }
 
     /// Reset for new frame
@@ -159,50 +451,95 @@ pub const LayoutEngine = struct {
         self.flex_styles[index] = style;
         self.style_versions[index] = self.global_style_version;
 
-        // Link to parent
+        // Link to parent. An absolute child leaves its siblings alone: it is
+        // placed on its own once the parent's rect is known (unless it turns
+        // a leaf into a container).
         if (parent_index) |parent| {
             self.parent[index] = parent;
             self.linkChild(parent, index);
-            self.markDirty(parent);
+            if (!isAbsolute(style) or self.child_count[parent] == 1) self.markDirty(parent);
         } else {
             self.parent[index] = NULL_INDEX;
         }
 
         // New element is dirty
         self.markDirty(index);
+        self.position_dirty.markDirty(index);
 
         return index;
     }
 
-    /// Remove element from tree (recursively removes children)
+    /// Remove element from tree along with its descendants (see removeSubtree)
     pub fn removeElement(self: *LayoutEngine, index: u32) void {
-        // Recursively remove all children
-        var child = self.first_child[index];
-        while (child != NULL_INDEX) {
-            const next = self.next_sibling[child];
-            self.removeElement(child);
-            child = next;
-        }
+        _ = self.removeSubtree(index);
+    }
 
-        // Unlink from parent
+    /// Remove `index` and everything below it in one pass.
+    ///
+    /// Only the subtree root is unlinked and only its parent marked dirty;
+    /// descendants are collected breadth-first into the free list's spare
+    /// tail (no recursion, no allocation) and their columns cleared one run
+    /// of consecutive indices at a time. The freed indices are pushed highest
+    /// first, so later allocations pop each run lowest first: a subtree
+    /// added back in the same order lands in the slots it left, keeping
+    /// compact()'s contiguous families intact.
+    ///
+    /// Returns the freed indices (highest first), valid until the next
+    /// addElement.
+    pub fn removeSubtree(self: *LayoutEngine, index: u32) []const u32 {
         const parent = self.parent[index];
         if (parent != NULL_INDEX) {
             self.unlinkChild(parent, index);
-            self.markDirty(parent);
+            if (!isAbsolute(self.flex_styles[index]) or self.child_count[parent] == 0) self.markDirty(parent);
         }
 
-        // Clear element data
-        self.parent[index] = NULL_INDEX;
-        self.first_child[index] = NULL_INDEX;
-        self.next_sibling[index] = NULL_INDEX;
-        self.child_count[index] = 0;
-        self.flex_styles[index] = .{};
-        self.computed_rects[index] = Rect.zero();
-        self.layout_cache[index].invalidate();
-        self.dirty_bits.clearDirty(index);
+        // Live nodes and free slots are disjoint, so the subtree fits in the tail
+        const tail = self.free_list.buffer[self.free_list.len..];
+        tail[0] = index;
+        var len: usize = 1;
+        var head: usize = 0;
+        while (head < len) : (head += 1) {
+            // Whatever was painted there is gone
+            self.damage_list.add(self.reported_rects[tail[head]]);
+            var child = self.first_child[tail[head]];
+            while (child != NULL_INDEX) : (child = self.next_sibling[child]) {
+                tail[len] = child;
+                len += 1;
+            }
+        }
+        const freed = tail[0..len];
+        std.sort.pdq(u32, freed, {}, std.sort.desc(u32));
+
+        var run_start: usize = 0;
+        while (run_start < len) {
+            var run_end = run_start + 1;
+            while (run_end < len and freed[run_end] + 1 == freed[run_end - 1]) run_end += 1;
+            self.clearSlots(freed[run_end - 1], freed[run_start] + 1);
+            run_start = run_end;
+        }
 
-        // Add to free list for reuse
-        self.free_list.append(index) catch {};
+        self.free_list.len += len;
+        return freed;
+    }
+
+    /// Reset the columns of free slots [first, end)
+    fn clearSlots(self: *LayoutEngine, first: u32, end: u32) void {
+        @memset(self.parent[first..end], NULL_INDEX);
+        @memset(self.first_child[first..end], NULL_INDEX);
+        @memset(self.next_sibling[first..end], NULL_INDEX);
+        @memset(self.child_count[first..end], 0);
+        @memset(self.flex_styles[first..end], .{});
+        @memset(self.computed_rects[first..end], Rect.zero());
+        @memset(self.reported_rects[first..end], Rect.zero());
+        @memset(self.offsets[first..end], Point.zero());
+        @memset(self.scroll_offsets[first..end], Point.zero());
+        @memset(self.content_sizes[first..end], .{ .width = 0, .height = 0 });
+        @memset(self.layout_cache[first..end], .{});
+        @memset(self.measure_cache[first..end], .{});
+        @memset(self.measures[first..end], .{});
+        self.dirty_bits.clearRange(first, end);
+        self.position_dirty.clearRange(first, end);
+        self.moved.clearRange(first, end);
     }
 
     /// Move element to new parent
@@ -221,12 +558,15 @@ pub const LayoutEngine = struct {
         self.parent[index] = new_parent;
         self.markDirty(new_parent);
         self.markDirty(index);
+        self.position_dirty.markDirty(index);
     }
 
     /// Reorder siblings
     pub fn reorderSiblings(self: *LayoutEngine, parent: u32, new_order: []const u32) void {
         if (new_order.len == 0) return;
 
+        self.children_contiguous = false;
+
         self.first_child[parent] = new_order[0];
         for (new_order[0 .. new_order.len - 1], new_order[1..]) |current, next| {
             self.next_sibling[current] = next;
@@ -236,6 +576,180 @@ pub const LayoutEngine = struct {
         self.markDirty(parent);
     }
 
+    /// Renumber nodes so every node's children sit at consecutive indices,
+    /// with families in depth-first order (each root, then its children,
+    /// then each child's children, ...). Free slots are squeezed out.
+    ///
+    /// Until the next structural change, container layout gathers children,
+    /// styles and sizes with linear scans instead of following sibling links.
+    ///
+    /// `remap` must hold getElementCount() entries and receives the new
+    /// index of every old one (NULL_INDEX for free slots). Indices held
+    /// outside the engine must be translated through it. Layout results,
+    /// caches and dirty state move with their nodes.
+    ///
+    /// Heap-backed engines write the result into a fresh block; caller-owned
+    /// storage (initFixed/initBuffer) is permuted in place, without
+    /// allocating.
+    pub fn compact(self: *LayoutEngine, remap: []u32) !void {
+        const old_count = self.element_count;
+        std.debug.assert(remap.len >= old_count);
+        const map = remap[0..old_count];
+
+        // Free slots are not part of any tree
+        @memset(map, NULL_INDEX);
+        for (self.free_list.buffer[0..self.free_list.len]) |free| {
+            map[free] = FREE_SLOT;
+        }
+
+        var next: u32 = 0;
+        for (0..old_count) |i| {
+            const index: u32 = @intCast(i);
+            if (self.parent[index] != NULL_INDEX or map[index] == FREE_SLOT) continue;
+            map[index] = next;
+            next += 1;
+            self.assignFamilies(map, index, &next);
+        }
+        for (map) |*new_index| {
+            if (new_index.* == FREE_SLOT) new_index.* = NULL_INDEX;
+        }
+
+        if (self.owns_storage) {
+            try self.compactIntoNewBlock(map);
+        } else {
+            self.compactInPlace(map, next);
+        }
+
+        self.element_count = next;
+        self.free_list.len = 0;
+        self.children_contiguous = true;
+    }
+
+    /// Write the permuted columns into a fresh block and free the old one
+    fn compactIntoNewBlock(self: *LayoutEngine, map: []const u32) !void {
+        const block = try self.allocator.alignedAlloc(u8, STORAGE_ALIGN, storageSize(self.capacity));
+        var target = self.*;
+        const target_masks = target.bindStorage(block, self.capacity);
+        var target_dirty = DirtyBits.init(target_masks.size, self.capacity);
+        var target_position_dirty = DirtyBits.init(target_masks.position, self.capacity);
+        var target_moved = DirtyBits.init(target_masks.moved, self.capacity);
+
+        for (map, 0..) |new_index, i| {
+            if (new_index == NULL_INDEX) continue;
+            inline for (columns) |col| {
+                @field(target, col[0])[new_index] = @field(self, col[0])[i];
+            }
+            target.parent[new_index] = remapIndex(map, self.parent[i]);
+            target.first_child[new_index] = remapIndex(map, self.first_child[i]);
+            target.next_sibling[new_index] = remapIndex(map, self.next_sibling[i]);
+            if (self.dirty_bits.isDirty(@intCast(i))) target_dirty.markDirty(new_index);
+            if (self.position_dirty.isDirty(@intCast(i))) target_position_dirty.markDirty(new_index);
+            if (self.moved.isDirty(@intCast(i))) target_moved.markDirty(new_index);
+        }
+
+        self.allocator.free(self.storage);
+        self.storage = block;
+        inline for (columns) |col| {
+            @field(self, col[0]) = @field(target, col[0]);
+        }
+        self.free_list.buffer = target.free_list.buffer;
+        self.dirty_bits.masks = target_dirty.masks;
+        self.position_dirty.masks = target_position_dirty.masks;
+        self.moved.masks = target_moved.masks;
+    }
+
+    /// Permute caller-owned storage in place (no second block on the
+    /// small-RAM targets fixed storage exists for). `map` is restored.
+    fn compactInPlace(self: *LayoutEngine, map: []u32, live_count: u32) void {
+        // Links first, while they still index old slots
+        for (map, 0..) |new_index, i| {
+            if (new_index == NULL_INDEX) continue;
+            self.parent[i] = remapIndex(map, self.parent[i]);
+            self.first_child[i] = remapIndex(map, self.first_child[i]);
+            self.next_sibling[i] = remapIndex(map, self.next_sibling[i]);
+        }
+
+        // Free slots go after the live ones, making `map` a permutation
+        var spare = live_count;
+        for (map) |*new_index| {
+            if (new_index.* != NULL_INDEX) continue;
+            new_index.* = spare;
+            spare += 1;
+        }
+
+        inline for (columns) |col| {
+            permuteColumn(col[1], @field(self, col[0])[0..map.len], map);
+        }
+        permuteBits(&self.dirty_bits, map);
+        permuteBits(&self.position_dirty, map);
+        permuteBits(&self.moved, map);
+
+        for (map) |*new_index| {
+            if (new_index.* >= live_count) new_index.* = NULL_INDEX;
+        }
+    }
+
+    /// Move `column[i]` to `column[map[i]]` for every i by following the
+    /// permutation's cycles, one element held aside at a time
+    fn permuteColumn(comptime T: type, column: []T, map: []u32) void {
+        for (0..map.len) |start| {
+            if (map[start] & PERMUTED != 0) continue;
+            var carry = column[start];
+            var i = start;
+            while (true) {
+                const dest = map[i];
+                map[i] |= PERMUTED;
+                const displaced = column[dest];
+                column[dest] = carry;
+                carry = displaced;
+                i = dest;
+                if (i == start) break;
+            }
+        }
+        for (map) |*new_index| new_index.* &= ~PERMUTED;
+    }
+
+    /// permuteColumn for a dirty bitset
+    fn permuteBits(bits: *DirtyBits, map: []u32) void {
+        for (0..map.len) |start| {
+            if (map[start] & PERMUTED != 0) continue;
+            var carry = bits.isDirty(@intCast(start));
+            var i: u32 = @intCast(start);
+            while (true) {
+                const dest = map[i];
+                map[i] |= PERMUTED;
+                const displaced = bits.isDirty(dest);
+                if (carry) bits.markDirty(dest) else bits.clearDirty(dest);
+                carry = displaced;
+                i = dest;
+                if (i == start) break;
+            }
+        }
+        for (map) |*new_index| new_index.* &= ~PERMUTED;
+    }
+
+    /// Number children of `index` consecutively, then recurse into each
+    fn assignFamilies(self: *const LayoutEngine, map: []u32, index: u32, next: *u32) void {
+        var child = self.first_child[index];
+        while (child != NULL_INDEX) : (child = self.next_sibling[child]) {
+            map[child] = next.*;
+            next.* += 1;
+        }
+        child = self.first_child[index];
+        while (child != NULL_INDEX) : (child = self.next_sibling[child]) {
+            self.assignFamilies(map, child, next);
+        }
+    }
+
+    fn remapIndex(map: []const u32, index: u32) u32 {
+        return if (index == NULL_INDEX) NULL_INDEX else map[index];
+    }
+
+    /// True while every node's children occupy consecutive indices
+    pub fn hasContiguousChildren(self: *const LayoutEngine) bool {
+        return self.children_contiguous;
+    }
+
     // =========================================================================
     // Pass 1: Bottom-Up Dirty Marking
     // =========================================================================
@@ -244,28 +758,125 @@ pub const LayoutEngine = struct {
     pub fn markDirty(self: *LayoutEngine, index: u32) void {
         // Mark the node itself
         self.dirty_bits.markDirty(index);
+        self.invalidateCache(index);
 
-        // Propagate up to ancestors
-        var current = self.parent[index];
+        // Propagate up to ancestors. An absolute node is out of its parent's
+        // flow, so nothing above it (or beside it) needs re-layout.
+        var current = if (isAbsolute(self.flex_styles[index])) NULL_INDEX else self.parent[index];
         while (current != NULL_INDEX) {
             // Already dirty? Ancestors must be too, stop here
             if (self.dirty_bits.isDirty(current)) break;
 
+            // A descendant changed, so the ancestor's cached size is stale too
             self.dirty_bits.markDirty(current);
+            self.invalidateCache(current);
 
-            // Fixed-size container? Won't affect parent layout, stop here
-            if (isFixedSize(self.flex_styles[current])) break;
+            // Fixed-size or absolute container? Won't affect parent layout, stop here
+            const style = self.flex_styles[current];
+            if (isFixedSize(style) or isAbsolute(style)) break;
 
             current = self.parent[current];
         }
     }
 
+    fn invalidateCache(self: *LayoutEngine, index: u32) void {
+        if (!self.layout_cache[index].isEmpty()) {
+            self.layout_cache[index].invalidate();
+            self.cache_stats.recordInvalidation();
+        }
+    }
+
     /// Update element style (marks dirty with proper propagation)
     pub fn setStyle(self: *LayoutEngine, index: u32, style: FlexStyle) void {
+        const old_position = self.flex_styles[index].position;
         self.flex_styles[index] = style;
         self.style_versions[index] = self.global_style_version;
         self.global_style_version += 1;
         self.markDirty(index);
+
+        // Entering or leaving the flow changes the parent's flex pass
+        const parent = self.parent[index];
+        if (old_position != style.position and parent != NULL_INDEX) self.markDirty(parent);
+    }
+
+    /// Set style only if it differs from the current one.
+    /// Immediate-mode callers re-submit every style every frame; skipping
+    /// identical writes keeps unchanged subtrees clean and cacheable.
+    /// Returns true if the style changed (and the element was marked dirty).
+    pub fn updateStyle(self: *LayoutEngine, index: u32, style: FlexStyle) bool {
+        if (self.flex_styles[index].eql(style)) {
+            self.cache_stats.recordStyleSkip();
+            return false;
+        }
+        self.setStyle(index, style);
+        return true;
+    }
+
+    /// Attach a measure callback to a leaf (null removes it).
+    /// Auto width/height of the leaf then come from the callback instead of
+    /// min_width/min_height; explicit sizes still win.
+    pub fn setMeasureFunc(self: *LayoutEngine, index: u32, func: ?MeasureFn, context: ?*anyopaque) void {
+        self.measures[index] = .{ .func = func, .context = context };
+        self.markContentDirty(index);
+    }
+
+    /// The measured content of a node changed (e.g. new text): drop its
+    /// memoized size and re-layout. Cheaper than setStyle for this case
+    /// because the style is left untouched.
+    pub fn markContentDirty(self: *LayoutEngine, index: u32) void {
+        self.style_versions[index] = self.global_style_version;
+        self.global_style_version += 1;
+        self.measure_cache[index].invalidate();
+        self.markDirty(index);
+    }
+
+    /// Translate a node (and its subtree) by (x, y) on top of its flexbox
+    /// position. Layout is untouched: only the subtree's absolute positions
+    /// go stale, so dragging or scrolling never reruns flexbox.
+    pub fn setOffset(self: *LayoutEngine, index: u32, x: f32, y: f32) void {
+        const offset = &self.offsets[index];
+        if (offset.x == x and offset.y == y) return;
+        offset.* = .{ .x = x, .y = y };
+        self.position_dirty.markDirty(index);
+    }
+
+    pub fn getOffset(self: *const LayoutEngine, index: u32) Point {
+        return self.offsets[index];
+    }
+
+    /// Scroll a container's content to (x, y), clamped to the range its last
+    /// layout allows (0 .. content size - viewport size). Like setOffset this
+    /// only moves absolute positions; the content is never re-laid out.
+    pub fn setScrollOffset(self: *LayoutEngine, index: u32, x: f32, y: f32) void {
+        const max = self.maxScrollOffset(index);
+        const clamped = Point{
+            .x = std.math.clamp(x, 0, max.x),
+            .y = std.math.clamp(y, 0, max.y),
+        };
+        const scroll = &self.scroll_offsets[index];
+        if (scroll.x == clamped.x and scroll.y == clamped.y) return;
+        scroll.* = clamped;
+        self.position_dirty.markDirty(index);
+    }
+
+    pub fn getScrollOffset(self: *const LayoutEngine, index: u32) Point {
+        return self.scroll_offsets[index];
+    }
+
+    /// Size of a container's content (children extent plus padding) as of
+    /// the last layout. Larger than the computed rect when content overflows.
+    pub fn getContentSize(self: *const LayoutEngine, index: u32) Size {
+        return self.content_sizes[index];
+    }
+
+    /// Largest scroll offset that still keeps the viewport inside the content
+    pub fn maxScrollOffset(self: *const LayoutEngine, index: u32) Point {
+        const content = self.content_sizes[index];
+        const rect = self.computed_rects[index];
+        return .{
+            .x = @max(0, content.width - rect.width),
+            .y = @max(0, content.height - rect.height),
+        };
     }
 
     // =========================================================================
@@ -274,60 +885,291 @@ pub const LayoutEngine = struct {
 
     /// Compute layout for all dirty elements using two-pass algorithm
     pub fn computeLayout(self: *LayoutEngine, available_width: f32, available_height: f32) !void {
-        // No elements? Nothing to do
+        // No elements or nothing dirty? Nothing to do
         if (self.element_count == 0) return;
+        if (!self.dirty_bits.anyDirty()) return;
+
+        var scratch = Scratch{
+            .allocator = self.arena.allocator(),
+            .stats = &self.cache_stats,
+        };
 
-        // Root not dirty? Nothing to do
-        if (!self.dirty_bits.isDirty(0)) return;
+        // Collected up front: the passes below may clear their bits
+        const absolute_roots = try self.collectAbsoluteRoots(scratch.allocator);
+
+        // Subtrees behind fixed-size barriers (marking stopped below a clean
+        // parent). A root nested in another's subtree is left dirty by it
+        // (see clearDescendantDirtyBits) unless reached, so index order works.
+        var next = self.dirty_bits.nextDirty(0);
+        while (next) |index| : (next = self.dirty_bits.nextDirty(index + 1)) {
+            if (!self.isLayoutRoot(index)) continue;
+            const rect = self.computed_rects[index];
+            try self.computeNode(&scratch, index, rect.width, rect.height);
+        }
 
         // Top-down traversal from root
-        try self.computeNode(0, available_width, available_height);
+        if (self.dirty_bits.isDirty(0)) {
+            try self.computeNode(&scratch, 0, available_width, available_height);
+        }
+
+        // Absolute subtrees whose parents stayed clean, against final rects
+        for (absolute_roots) |index| {
+            try self.layoutAbsolute(&scratch, self.parent[index], index, true);
+        }
+    }
+
+    /// Compute layout with independent subtrees spread over `pool`.
+    ///
+    /// Fixed-size containers are layout roots: their size does not depend on
+    /// their children, so once placed, each subtree can be computed on its own
+    /// thread. The tree above them is still laid out on the calling thread.
+    /// Results are identical to computeLayout().
+    ///
+    /// The engine's allocator must be thread-safe.
+    pub fn computeLayoutParallel(self: *LayoutEngine, pool: *thread_pool.Pool, available_width: f32, available_height: f32) !void {
+        if (self.element_count == 0) return;
+        if (!self.dirty_bits.anyDirty()) return;
+
+        const absolute_roots = try self.collectAbsoluteRoots(self.arena.allocator());
+
+        // Phase 1: subtrees behind fixed-size barriers whose parents stayed
+        // clean. Roots nested inside another root's subtree wait for a later
+        // round, so no two tasks share nodes.
+        var barrier_roots: std.ArrayListUnmanaged(thread_pool.Task) = .{};
+        while (true) {
+            barrier_roots.clearRetainingCapacity();
+            var next = self.dirty_bits.nextDirty(0);
+            while (next) |index| : (next = self.dirty_bits.nextDirty(index + 1)) {
+                if (!self.isLayoutRoot(index) or self.hasLayoutRootAbove(index)) continue;
+                const rect = self.computed_rects[index];
+                try barrier_roots.append(self.arena.allocator(), subtreeTask(index, .{ .width = rect.width, .height = rect.height }));
+            }
+            if (barrier_roots.items.len == 0) break;
+            try self.runOnPool(pool, barrier_roots.items);
+        }
+
+        // Phase 2: top-down from root, deferring fixed-size containers
+        if (self.dirty_bits.isDirty(0)) {
+            var deferred: std.ArrayListUnmanaged(thread_pool.Task) = .{};
+            var scratch = Scratch{
+                .allocator = self.arena.allocator(),
+                .stats = &self.cache_stats,
+                .deferred = &deferred,
+            };
+            try self.computeNode(&scratch, 0, available_width, available_height);
+            try self.runOnPool(pool, deferred.items);
+        }
+
+        // Phase 3: absolute subtrees whose parents stayed clean
+        if (absolute_roots.len > 0) {
+            var deferred: std.ArrayListUnmanaged(thread_pool.Task) = .{};
+            var scratch = Scratch{
+                .allocator = self.arena.allocator(),
+                .stats = &self.cache_stats,
+                .deferred = &deferred,
+            };
+            for (absolute_roots) |index| {
+                try self.layoutAbsolute(&scratch, self.parent[index], index, true);
+            }
+            try self.runOnPool(pool, deferred.items);
+        }
+    }
+
+    /// Absolute nodes the dirty marking stopped at (their parents are clean)
+    fn collectAbsoluteRoots(self: *const LayoutEngine, allocator: std.mem.Allocator) ![]const u32 {
+        var roots: std.ArrayListUnmanaged(u32) = .{};
+        var next = self.dirty_bits.nextDirty(0);
+        while (next) |index| : (next = self.dirty_bits.nextDirty(index + 1)) {
+            if (isAbsolute(self.flex_styles[index]) and self.isBarrierRoot(index)) {
+                try roots.append(allocator, index);
+            }
+        }
+        return roots.items;
+    }
+
+    /// Dirty node whose parent is clean: its ancestors never saw the change
+    fn isBarrierRoot(self: *const LayoutEngine, index: u32) bool {
+        const parent = self.parent[index];
+        return parent != NULL_INDEX and !self.dirty_bits.isDirty(parent);
+    }
+
+    /// Dirty barrier root laid out in the barrier pass (absolute ones wait
+    /// for their final containing block)
+    fn isLayoutRoot(self: *const LayoutEngine, index: u32) bool {
+        return self.dirty_bits.isDirty(index) and self.isBarrierRoot(index) and !isAbsolute(self.flex_styles[index]);
+    }
+
+    /// Whether another barrier-pass root contains `index`
+    fn hasLayoutRootAbove(self: *const LayoutEngine, index: u32) bool {
+        var ancestor = self.parent[index];
+        while (ancestor != NULL_INDEX) : (ancestor = self.parent[ancestor]) {
+            if (self.isLayoutRoot(ancestor)) return true;
+        }
+        return false;
+    }
+
+    fn runOnPool(self: *LayoutEngine, pool: *thread_pool.Pool, tasks: []const thread_pool.Task) !void {
+        if (tasks.len == 0) return;
+
+        const stats = try self.arena.allocator().alloc(CacheStats, pool.getThreadCount());
+        @memset(stats, .{});
+        var context = PoolRun{ .engine = self, .stats = stats };
+        try pool.run(&context, runSubtreeTask, tasks);
+
+        var failed = false;
+        for (pool.workers, stats) |*worker, worker_stats| {
+            self.cache_stats.merge(worker_stats);
+            failed = failed or worker.failed;
+        }
+        if (failed) return error.OutOfMemory;
+    }
+
+    fn runSubtreeTask(context: *anyopaque, worker: *thread_pool.Worker, task: thread_pool.Task) void {
+        const run: *PoolRun = @ptrCast(@alignCast(context));
+        const size: SubtreeSize = @bitCast(task.payload);
+        var scratch = Scratch{
+            .allocator = worker.arena.allocator(),
+            .stats = &run.stats[worker.id],
+            .shared = true,
+            .worker = worker,
+        };
+        run.engine.computeNode(&scratch, task.index, size.width, size.height) catch {
+            worker.failed = true;
+        };
     }
 
     /// Compute layout for a node and recurse into dirty/size-changed children
-    fn computeNode(self: *LayoutEngine, index: u32, available_width: f32, available_height: f32) std.mem.Allocator.Error!void {
+    fn computeNode(self: *LayoutEngine, scratch: *Scratch, index: u32, available_width: f32, available_height: f32) std.mem.Allocator.Error!void {
         if (self.child_count[index] == 0) {
             // Leaf element - compute intrinsic size
-            self.computeLeafLayout(index, available_width, available_height);
+            self.computeLeafLayout(scratch, index, available_width, available_height);
         } else {
             // Container - compute flexbox layout
-            try self.computeContainerLayout(index, available_width, available_height);
+            try self.computeContainerLayout(scratch, index, available_width, available_height);
         }
 
         // Clear dirty bit after processing
-        self.dirty_bits.clearDirty(index);
+        self.clearDirtyBit(scratch, index);
     }
 
     /// Compute layout for a leaf element
-    fn computeLeafLayout(self: *LayoutEngine, index: u32, available_width: f32, available_height: f32) void {
+    fn computeLeafLayout(self: *LayoutEngine, scratch: *Scratch, index: u32, available_width: f32, available_height: f32) void {
         // Check cache first
         const cached = &self.layout_cache[index];
         const style_version = self.style_versions[index];
+        const constraint = layoutConstraint(self.flex_styles[index], available_width, available_height);
 
-        if (cached.isValid(available_width, available_height, style_version)) {
-            self.cache_stats.recordHit();
-            const cached_size = cached.getSize();
-            self.computed_rects[index].width = cached_size.width;
-            self.computed_rects[index].height = cached_size.height;
+        if (cached.lookup(constraint, style_version)) |hit| {
+            scratch.stats.recordSlotHit(constraint.kind());
+            self.computed_rects[index].width = hit.size.width;
+            self.computed_rects[index].height = hit.size.height;
             return;
         }
 
-        self.cache_stats.recordMiss();
+        scratch.stats.recordSlotMiss(constraint.kind());
 
+        const size = self.leafContentSize(scratch, index, available_width, available_height);
+        self.computed_rects[index].width = size.width;
+        self.computed_rects[index].height = size.height;
+
+        self.storeCache(scratch, index, constraint, style_version, size, true);
+    }
+
+    /// Size of a leaf: explicit > measured > min > 0
+    fn leafContentSize(self: *LayoutEngine, scratch: *Scratch, index: u32, available_width: f32, available_height: f32) Size {
         const style = self.flex_styles[index];
 
-        // Determine size: explicit > min > 0
-        const width = if (style.width >= 0) style.width else style.min_width;
-        const height = if (style.height >= 0) style.height else style.min_height;
+        var width = if (style.width >= 0) style.width else style.min_width;
+        var height = if (style.height >= 0) style.height else style.min_height;
+        if (self.measures[index].func != null) {
+            // An explicit size is the space the content gets (e.g. text wraps to it)
+            const measured = self.measureNode(
+                scratch,
+                index,
+                if (style.width >= 0) style.width else available_width,
+                if (style.height >= 0) style.height else available_height,
+            );
+            if (style.width < 0) width = @max(measured.width, style.min_width);
+            if (style.height < 0) height = @max(measured.height, style.min_height);
+        }
+        return .{ .width = width, .height = height };
+    }
+
+    /// Max-content size of a node: children at their own max-content size,
+    /// laid end to end on the main axis (undefined axes are unbounded).
+    /// Writes no rects or dirty bits, only caches, so a parent can probe
+    /// auto-sized children before placing them. Fixed-size nodes answer
+    /// from their style, so probes never enter independent subtrees.
+    fn intrinsicSize(self: *LayoutEngine, scratch: *Scratch, index: u32, constraint: Constraint) Size {
+        const style = self.flex_styles[index];
+        if (isFixedSize(style)) return .{ .width = style.width, .height = style.height };
+        if (self.child_count[index] == 0) {
+            return self.leafContentSize(scratch, index, constraint.available_width, constraint.available_height);
+        }
+
+        const cached = &self.layout_cache[index];
+        const style_version = self.style_versions[index];
+        const kind = constraint.kind();
+        if (cached.lookup(constraint, style_version)) |hit| {
+            scratch.stats.recordSlotHit(kind);
+            return hit.size;
+        }
+        scratch.stats.recordSlotMiss(kind);
+
+        const is_row = style.direction == .row;
+        const padding_h = style.padding_left + style.padding_right;
+        const padding_v = style.padding_top + style.padding_bottom;
+        const inner_width = (if (style.width >= 0) style.width else constraint.available_width) - padding_h;
+        const inner_height = (if (style.height >= 0) style.height else constraint.available_height) - padding_v;
+        const inner = probeConstraint(is_row, @max(0, inner_width), @max(0, inner_height));
+
+        var main_sum: f32 = 0;
+        var cross_max: f32 = 0;
+        var count: u32 = 0;
+        var child = self.first_child[index];
+        while (child != NULL_INDEX) : (child = self.next_sibling[child]) {
+            const child_style = self.flex_styles[child];
+            if (isAbsolute(child_style)) continue;
+            const size = self.intrinsicSize(scratch, child, inner);
+            const width = @min(@max(size.width, child_style.min_width), child_style.max_width);
+            const height = @min(@max(size.height, child_style.min_height), child_style.max_height);
+            main_sum += if (is_row) width else height;
+            cross_max = @max(cross_max, if (is_row) height else width);
+            count += 1;
+        }
+        if (count > 1) main_sum += style.gap * @as(f32, @floatFromInt(count - 1));
 
-        self.computed_rects[index].width = width;
-        self.computed_rects[index].height = height;
+        const content_width = (if (is_row) main_sum else cross_max) + padding_h;
+        const content_height = (if (is_row) cross_max else main_sum) + padding_v;
+        const size = Size{
+            .width = if (style.width >= 0) style.width else @max(content_width, style.min_width),
+            .height = if (style.height >= 0) style.height else @max(content_height, style.min_height),
+        };
 
-        cached.update(available_width, available_height, style_version, width, height);
+        self.storeCache(scratch, index, constraint, style_version, size, false);
+        return size;
+    }
+
+    /// Constraint for probing children of a row/column: unbounded main axis,
+    /// cross axis bounded by the container's content box (if finite)
+    fn probeConstraint(is_row: bool, content_width: f32, content_height: f32) Constraint {
+        const unbounded = std.math.inf(f32);
+        return .{
+            .available_width = if (is_row) unbounded else content_width,
+            .available_height = if (is_row) content_height else unbounded,
+            .width_mode = if (is_row) .undefined else axisMode(-1, content_width),
+            .height_mode = if (is_row) axisMode(-1, content_height) else .undefined,
+        };
+    }
+
+    fn storeCache(self: *LayoutEngine, scratch: *Scratch, index: u32, constraint: Constraint, style_version: u64, size: Size, is_layout: bool) void {
+        if (self.layout_cache[index].store(constraint, style_version, size, is_layout)) {
+            scratch.stats.recordEviction();
+        }
     }
 
     /// Compute flexbox layout for a container and its children
-    fn computeContainerLayout(self: *LayoutEngine, index: u32, available_width: f32, available_height: f32) std.mem.Allocator.Error!void {
+    fn computeContainerLayout(self: *LayoutEngine, scratch: *Scratch, index: u32, available_width: f32, available_height: f32) std.mem.Allocator.Error!void {
         const child_count = self.child_count[index];
         const style = self.flex_styles[index];
         const style_version = self.style_versions[index];
@@ -336,20 +1178,23 @@ pub const LayoutEngine = struct {
         const container_width = if (style.width >= 0) style.width else available_width;
         const container_height = if (style.height >= 0) style.height else available_height;
 
-        // Check cache first
+        // Check cache first. Only the slot of the last full layout will do:
+        // children are positioned for that constraint and no other.
         const cached = &self.layout_cache[index];
-        if (cached.isValid(container_width, container_height, style_version)) {
-            self.cache_stats.recordHit();
-            const cached_size = cached.getSize();
-            self.computed_rects[index].width = cached_size.width;
-            self.computed_rects[index].height = cached_size.height;
-
-            // Even on cache hit, we must clear dirty bits for all descendants
-            self.clearDescendantDirtyBits(index);
-            return;
+        const constraint = layoutConstraint(style, available_width, available_height);
+        if (cached.lookup(constraint, style_version)) |hit| {
+            if (hit.is_layout) {
+                scratch.stats.recordSlotHit(constraint.kind());
+                self.computed_rects[index].width = hit.size.width;
+                self.computed_rects[index].height = hit.size.height;
+
+                // Even on cache hit, we must clear dirty bits for all descendants
+                self.clearDescendantDirtyBits(scratch, index);
+                return;
+            }
         }
 
-        self.cache_stats.recordMiss();
+        scratch.stats.recordSlotMiss(constraint.kind());
 
         // Use stack buffers for small child counts, heap for large
         var children_stack: [STACK_CHILDREN_MAX]u32 = undefined;
@@ -360,55 +1205,120 @@ pub const LayoutEngine = struct {
         const use_heap = child_count > STACK_CHILDREN_MAX;
 
         const children = if (use_heap)
-            try self.arena.allocator().alloc(u32, child_count)
+            try scratch.allocator.alloc(u32, child_count)
         else
             children_stack[0..child_count];
-        defer if (use_heap) self.arena.allocator().free(children);
+        defer if (use_heap) scratch.allocator.free(children);
 
         const old_sizes = if (use_heap)
-            try self.arena.allocator().alloc(Size, child_count)
+            try scratch.allocator.alloc(Size, child_count)
         else
             old_sizes_stack[0..child_count];
-        defer if (use_heap) self.arena.allocator().free(old_sizes);
+        defer if (use_heap) scratch.allocator.free(old_sizes);
 
         const children_styles = if (use_heap)
-            try self.arena.allocator().alloc(FlexStyle, child_count)
+            try scratch.allocator.alloc(FlexStyle, child_count)
         else
             styles_stack[0..child_count];
-        defer if (use_heap) self.arena.allocator().free(children_styles);
+        defer if (use_heap) scratch.allocator.free(children_styles);
 
         const children_results = if (use_heap)
-            try self.arena.allocator().alloc(LayoutResult, child_count)
+            try scratch.allocator.alloc(LayoutResult, child_count)
         else
             results_stack[0..child_count];
-        defer if (use_heap) self.arena.allocator().free(children_results);
+        defer if (use_heap) scratch.allocator.free(children_results);
+
+        // Space offered to measured and probed children
+        const content_width = @max(0, container_width - style.padding_left - style.padding_right);
+        const content_height = @max(0, container_height - style.padding_top - style.padding_bottom);
+        const is_row = style.direction == .row;
+        const probe = probeConstraint(is_row, content_width, content_height);
+
+        // Collect children indices, old sizes, and styles
+        if (self.children_contiguous) {
+            // Compacted storage: one linear run per column
+            const first = self.first_child[index];
+            @memcpy(children_styles, self.flex_styles[first..][0..child_count]);
+            for (children, old_sizes, self.computed_rects[first..][0..child_count], 0..) |*c, *old_size, rect, k| {
+                c.* = first + @as(u32, @intCast(k));
+                old_size.* = .{ .width = rect.width, .height = rect.height };
+            }
+        } else {
+            var i: usize = 0;
+            var child = self.first_child[index];
+            while (child != NULL_INDEX) : (i += 1) {
+                children[i] = child;
+                old_sizes[i] = .{
+                    .width = self.computed_rects[child].width,
+                    .height = self.computed_rects[child].height,
+                };
+                children_styles[i] = self.flex_styles[child];
+                child = self.next_sibling[child];
+            }
+        }
 
-        // Collect children indices, old sizes, and styles in single pass
-        var i: usize = 0;
-        var child = self.first_child[index];
-        while (child != NULL_INDEX) : (i += 1) {
-            children[i] = child;
-            old_sizes[i] = .{
-                .width = self.computed_rects[child].width,
-                .height = self.computed_rects[child].height,
-            };
-            children_styles[i] = self.flex_styles[child];
-            child = self.next_sibling[child];
+        // Absolute children sit out the flex pass (placed once the container
+        // is sized); in-flow ones keep their order at the front
+        var flow_count: usize = 0;
+        for (0..child_count) |k| {
+            if (isAbsolute(children_styles[k])) continue;
+            children[flow_count] = children[k];
+            old_sizes[flow_count] = old_sizes[k];
+            children_styles[flow_count] = children_styles[k];
+            flow_count += 1;
+        }
+        const has_absolute = flow_count < child_count;
+        const flow_children = children[0..flow_count];
+        const flow_styles = children_styles[0..flow_count];
+        const flow_results = children_results[0..flow_count];
+
+        // Content sizes of measured leaves and auto-sized containers
+        for (flow_children, flow_styles) |child, *child_style_ptr| {
+            const child_style = child_style_ptr.*;
+            if (self.child_count[child] == 0) {
+                if (self.measures[child].func != null) {
+                    // Measured leaves behave as if their auto sizes were set to
+                    // content size, except a stretched cross axis
+                    const content = self.leafContentSize(scratch, child, content_width, content_height);
+                    const stretched = style.align_items == .stretch;
+                    if (is_row or !stretched) child_style_ptr.width = content.width;
+                    if (!is_row or !stretched) child_style_ptr.height = content.height;
+                }
+            } else {
+                // Auto-sized containers start from their max-content main size and,
+                // unless stretched, fit their content on the cross axis
+                const main_auto = (if (is_row) child_style.width else child_style.height) < 0;
+                const cross_auto = (if (is_row) child_style.height else child_style.width) < 0 and
+                    style.align_items != .stretch;
+                if (main_auto or cross_auto) {
+                    const content = self.intrinsicSize(scratch, child, probe);
+                    const fit_width = if (is_row) content.width else @min(content.width, content_width);
+                    const fit_height = if (is_row) @min(content.height, content_height) else content.height;
+                    if (if (is_row) main_auto else cross_auto) child_style_ptr.width = fit_width;
+                    if (if (is_row) cross_auto else main_auto) child_style_ptr.height = fit_height;
+                }
+            }
         }
 
         // Compute flexbox layout
         try flexbox.computeFlexLayout(
-            self.arena.allocator(),
+            scratch.allocator,
             container_width,
             container_height,
             style,
-            children_styles,
-            children_results,
+            flow_styles,
+            flow_results,
         );
 
-        // Apply results to children
-        for (children, 0..) |child_index, j| {
-            const result = children_results[j];
+        // Apply results to children; moved ones take their subtree with them,
+        // resized ones refresh their own absolute rect
+        for (flow_children, flow_results) |child_index, result| {
+            const old = self.computed_rects[child_index];
+            if (old.x != result.x or old.y != result.y or
+                old.width != result.width or old.height != result.height)
+            {
+                self.markPositionDirty(scratch, child_index);
+            }
             self.computed_rects[child_index] = .{
                 .x = result.x,
                 .y = result.y,
@@ -418,16 +1328,16 @@ pub const LayoutEngine = struct {
         }
 
         // Recurse into children that are dirty OR whose size changed
-        for (children, 0..) |child_index, j| {
+        for (flow_children, 0..) |child_index, j| {
             const is_container = self.child_count[child_index] > 0;
 
             if (!is_container) {
                 // Leaf node - just clear dirty bit (no children to layout)
-                self.dirty_bits.clearDirty(child_index);
+                self.clearDirtyBit(scratch, child_index);
                 continue;
             }
 
-            const is_dirty = self.dirty_bits.isDirty(child_index);
+            const is_dirty = self.isDirtyBit(scratch, child_index);
             const new_size = Size{
                 .width = self.computed_rects[child_index].width,
                 .height = self.computed_rects[child_index].height,
@@ -435,70 +1345,381 @@ pub const LayoutEngine = struct {
             const size_changed = !sizesApproxEqual(new_size, old_sizes[j]);
 
             if (is_dirty or size_changed) {
-                try self.computeNode(child_index, new_size.width, new_size.height);
+                if (scratch.defersSubtrees() and isFixedSize(self.flex_styles[child_index])) {
+                    // Independent subtree - hand it to the pool
+                    try scratch.deferSubtree(child_index, new_size);
+                } else {
+                    try self.computeNode(scratch, child_index, new_size.width, new_size.height);
+                }
             } else {
                 // Not dirty and size didn't change - clear dirty bits recursively
-                self.clearDescendantDirtyBits(child_index);
+                self.clearDescendantDirtyBits(scratch, child_index);
             }
         }
 
-        // Container size: use explicit size or compute from children + padding
-        const padding_h = style.padding_left + style.padding_right;
-        const padding_v = style.padding_top + style.padding_bottom;
+        // Content extent: children + padding. Child positions already include
+        // the start padding.
+        var max_x: f32 = style.padding_left;
+        var max_y: f32 = style.padding_top;
+        for (flow_results) |result| {
+            max_x = @max(max_x, result.x + result.width);
+            max_y = @max(max_y, result.y + result.height);
+        }
+        const content = Size{ .width = max_x + style.padding_right, .height = max_y + style.padding_bottom };
+        self.content_sizes[index] = content;
+
+        // Container size: explicit size, else content size. Auto-sized scroll
+        // containers take the space they were given (their viewport) instead,
+        // as long as it is bounded.
+        const scrolls = style.overflow == .scroll;
+        const final_width = if (style.width >= 0)
+            style.width
+        else if (scrolls and std.math.isFinite(container_width))
+            container_width
+        else
+            content.width;
+        const final_height = if (style.height >= 0)
+            style.height
+        else if (scrolls and std.math.isFinite(container_height))
+            container_height
+        else
+            content.height;
 
-        const final_width = if (style.width >= 0) style.width else blk: {
-            var max_x: f32 = 0;
-            for (children_results) |result| {
-                max_x = @max(max_x, result.x + result.width);
-            }
-            break :blk max_x + padding_h;
-        };
+        const old_rect = self.computed_rects[index];
+        if (old_rect.width != final_width or old_rect.height != final_height) {
+            self.markPositionDirty(scratch, index);
+        }
+        self.computed_rects[index].width = final_width;
+        self.computed_rects[index].height = final_height;
 
-        const final_height = if (style.height >= 0) style.height else blk: {
-            var max_y: f32 = 0;
-            for (children_results) |result| {
-                max_y = @max(max_y, result.y + result.height);
+        // Content may have shrunk under the current scroll position
+        if (scrolls) {
+            const max = self.maxScrollOffset(index);
+            const scroll = &self.scroll_offsets[index];
+            if (scroll.x > max.x or scroll.y > max.y) {
+                scroll.* = .{ .x = @min(scroll.x, max.x), .y = @min(scroll.y, max.y) };
+                self.markPositionDirty(scratch, index);
             }
-            break :blk max_y + padding_v;
-        };
+        }
 
-        self.computed_rects[index].width = final_width;
-        self.computed_rects[index].height = final_height;
+        // Absolute children, against the final padding box
+        if (has_absolute) {
+            var child = self.first_child[index];
+            while (child != NULL_INDEX) : (child = self.next_sibling[child]) {
+                if (isAbsolute(self.flex_styles[child])) try self.layoutAbsolute(scratch, index, child, false);
+            }
+        }
 
         // Update cache
-        cached.update(container_width, container_height, style_version, final_width, final_height);
+        self.storeCache(scratch, index, constraint, style_version, .{ .width = final_width, .height = final_height }, true);
     }
 
-    /// Clear dirty bits for a node and all its descendants
-    fn clearDescendantDirtyBits(self: *LayoutEngine, index: u32) void {
-        self.dirty_bits.clearDirty(index);
+    /// Size and place an absolute node against the padding box of `parent`
+    /// (whose rect is final), then lay out its subtree if it is dirty, was
+    /// resized or `force`d. Per axis: explicit size, else both insets set
+    /// stretches it between them, else its content size; clamped to min/max.
+    /// A start inset wins over an end inset; with neither it sits at the
+    /// padding box's start.
+    fn layoutAbsolute(self: *LayoutEngine, scratch: *Scratch, parent: u32, index: u32, force: bool) std.mem.Allocator.Error!void {
+        const parent_style = self.flex_styles[parent];
+        const parent_rect = self.computed_rects[parent];
+        const box_width = @max(0, parent_rect.width - parent_style.padding_left - parent_style.padding_right);
+        const box_height = @max(0, parent_rect.height - parent_style.padding_top - parent_style.padding_bottom);
+
+        const style = self.flex_styles[index];
+        const stretch_width = style.width < 0 and isInset(style.left) and isInset(style.right);
+        const stretch_height = style.height < 0 and isInset(style.top) and isInset(style.bottom);
+        const available_width = if (stretch_width) @max(0, box_width - style.left - style.right) else box_width;
+        const available_height = if (stretch_height) @max(0, box_height - style.top - style.bottom) else box_height;
+
+        var size = if (self.child_count[index] == 0)
+            self.leafContentSize(scratch, index, available_width, available_height)
+        else
+            self.intrinsicSize(scratch, index, .{
+                .available_width = available_width,
+                .available_height = available_height,
+                .width_mode = axisMode(style.width, available_width),
+                .height_mode = axisMode(style.height, available_height),
+            });
+        if (stretch_width) size.width = available_width;
+        if (stretch_height) size.height = available_height;
+        size.width = @min(@max(size.width, style.min_width), style.max_width);
+        size.height = @min(@max(size.height, style.min_height), style.max_height);
+
+        const old = self.computed_rects[index];
+        self.computed_rects[index].width = size.width;
+        self.computed_rects[index].height = size.height;
+
+        if (self.child_count[index] == 0) {
+            self.clearDirtyBit(scratch, index);
+        } else if (force or self.isDirtyBit(scratch, index) or
+            !sizesApproxEqual(size, .{ .width = old.width, .height = old.height }))
+        {
+            if (scratch.defersSubtrees() and isFixedSize(style)) {
+                try scratch.deferSubtree(index, size);
+            } else {
+                try self.computeNode(scratch, index, size.width, size.height);
+            }
+        } else {
+            self.clearDescendantDirtyBits(scratch, index);
+        }
+
+        // End insets need the final size (an auto container fits its content)
+        const rect = &self.computed_rects[index];
+        rect.x = parent_style.padding_left + insetOffset(style.left, style.right, box_width, rect.width);
+        rect.y = parent_style.padding_top + insetOffset(style.top, style.bottom, box_height, rect.height);
+        if (old.x != rect.x or old.y != rect.y or old.width != rect.width or old.height != rect.height) {
+            self.markPositionDirty(scratch, index);
+        }
+    }
+
+    /// Content size of a node with a measure callback, memoized per node
+    fn measureNode(self: *LayoutEngine, scratch: *Scratch, index: u32, available_width: f32, available_height: f32) Size {
+        const memo = &self.measure_cache[index];
+        const version = self.style_versions[index];
+        if (memo.isValid(available_width, available_height, version)) {
+            scratch.stats.recordMeasureHit();
+            return memo.getSize();
+        }
+
+        scratch.stats.recordMeasureCall();
+        const measure = self.measures[index];
+        const size = measure.func.?(measure.context, index, available_width, available_height);
+        memo.update(available_width, available_height, version, size);
+        return size;
+    }
+
+    /// Clear dirty bits for a node and all its descendants. A dirty node
+    /// below a clean one is a barrier root with its own edit: it keeps its
+    /// bits and is laid out from computeLayout's barrier pass.
+    fn clearDescendantDirtyBits(self: *LayoutEngine, scratch: *Scratch, index: u32) void {
+        const dirty = self.isDirtyBit(scratch, index);
+        self.clearDirtyBit(scratch, index);
 
         var child = self.first_child[index];
         while (child != NULL_INDEX) {
-            self.clearDescendantDirtyBits(child);
+            if (dirty or !self.isDirtyBit(scratch, child)) self.clearDescendantDirtyBits(scratch, child);
             child = self.next_sibling[child];
         }
     }
 
+    // Workers clear bits that share mask words with other subtrees
+    inline fn clearDirtyBit(self: *LayoutEngine, scratch: *const Scratch, index: u32) void {
+        if (scratch.shared) {
+            self.dirty_bits.clearDirtyAtomic(index);
+        } else {
+            self.dirty_bits.clearDirty(index);
+        }
+    }
+
+    inline fn isDirtyBit(self: *const LayoutEngine, scratch: *const Scratch, index: u32) bool {
+        return if (scratch.shared) self.dirty_bits.isDirtyAtomic(index) else self.dirty_bits.isDirty(index);
+    }
+
+    inline fn markPositionDirty(self: *LayoutEngine, scratch: *const Scratch, index: u32) void {
+        if (scratch.shared) {
+            self.position_dirty.markDirtyAtomic(index);
+        } else {
+            self.position_dirty.markDirty(index);
+        }
+    }
+
+    // =========================================================================
+    // Absolute Positions (lazy)
+    // =========================================================================
+
+    /// Rect of a node in root coordinates (offsets of the node and its
+    /// ancestors included). Refreshes the stale subtree containing the node
+    /// first, if any; otherwise this is a column read.
+    pub fn getAbsoluteRect(self: *LayoutEngine, index: u32) Rect {
+        // Topmost stale ancestor: everything below it must be recomputed
+        var stale: u32 = NULL_INDEX;
+        var current = index;
+        while (current != NULL_INDEX) : (current = self.parent[current]) {
+            if (self.position_dirty.isDirty(current)) stale = current;
+        }
+        if (stale != NULL_INDEX) self.refreshPositions(stale);
+
+        const position = self.absolute_positions[index];
+        const rect = self.computed_rects[index];
+        return .{ .x = position.x, .y = position.y, .width = rect.width, .height = rect.height };
+    }
+
+    /// Bring every stale absolute position up to date (e.g. once per frame
+    /// before drawing, so getAbsoluteRect never has to walk ancestors)
+    pub fn updatePositions(self: *LayoutEngine) void {
+        var next = self.position_dirty.nextDirty(0);
+        while (next) |index| : (next = self.position_dirty.nextDirty(index + 1)) {
+            // Start from the topmost stale ancestor so no subtree is walked twice
+            var stale = index;
+            var current = self.parent[index];
+            while (current != NULL_INDEX) : (current = self.parent[current]) {
+                if (self.position_dirty.isDirty(current)) stale = current;
+            }
+            self.refreshPositions(stale);
+        }
+    }
+
+    /// Recompute absolute positions of a subtree from its parent's origin
+    fn refreshPositions(self: *LayoutEngine, index: u32) void {
+        const parent = self.parent[index];
+        const origin = if (parent == NULL_INDEX) Point.zero() else self.absolute_positions[parent];
+        self.placeSubtree(index, origin);
+    }
+
+    fn placeSubtree(self: *LayoutEngine, index: u32, origin: Point) void {
+        const rect = self.computed_rects[index];
+        const offset = self.offsets[index];
+        const position = Point{ .x = origin.x + rect.x + offset.x, .y = origin.y + rect.y + offset.y };
+        self.absolute_positions[index] = position;
+        self.position_dirty.clearDirty(index);
+        self.moved.markDirty(index);
+
+        // Children of a scroll container are shifted by its scroll offset
+        const scroll = self.scroll_offsets[index];
+        const content_origin = Point{ .x = position.x - scroll.x, .y = position.y - scroll.y };
+        var child = self.first_child[index];
+        while (child != NULL_INDEX) : (child = self.next_sibling[child]) {
+            self.placeSubtree(child, content_origin);
+        }
+    }
+
+    /// First node >= start whose absolute rect changed since clearMoved().
+    /// Only refreshed positions count: call updatePositions() first.
+    pub fn nextMoved(self: *const LayoutEngine, start: u32) ?u32 {
+        return self.moved.nextDirty(start);
+    }
+
+    /// Acknowledge every moved node (after syncing whatever mirrors the rects)
+    pub fn clearMoved(self: *LayoutEngine) void {
+        self.moved.clearAll();
+    }
+
+    /// Report every descendant of `index` as moved, e.g. when a clipping
+    /// ancestor was resized around children whose own rects stayed put
+    pub fn markDescendantsMoved(self: *LayoutEngine, index: u32) void {
+        var child = self.first_child[index];
+        while (child != NULL_INDEX) : (child = self.next_sibling[child]) {
+            self.moved.markDirty(child);
+            self.markDescendantsMoved(child);
+        }
+    }
+
+    /// Fold nodes whose absolute rect changed since they were last reported
+    /// into the damage list (old rect and new rect) and return it. Call
+    /// after computeLayout and any offset/scroll changes. Walks moved nodes
+    /// only and leaves the moved class set: its owner still clears it.
+    pub fn collectDamage(self: *LayoutEngine) []const Rect {
+        self.updatePositions();
+
+        var next = self.moved.nextDirty(0);
+        while (next) |index| : (next = self.moved.nextDirty(index + 1)) {
+            const position = self.absolute_positions[index];
+            const size = self.computed_rects[index];
+            const rect = Rect{ .x = position.x, .y = position.y, .width = size.width, .height = size.height };
+            const reported = self.reported_rects[index];
+            if (std.meta.eql(rect, reported)) continue;
+
+            self.damage_list.add(reported);
+            self.damage_list.add(rect);
+            self.reported_rects[index] = rect;
+        }
+        return self.damage_list.items();
+    }
+
+    /// Regions gathered so far (see collectDamage)
+    pub fn getDamage(self: *const LayoutEngine) []const Rect {
+        return self.damage_list.items();
+    }
+
+    /// Start a new damage list (after the previous one was repainted)
+    pub fn clearDamage(self: *LayoutEngine) void {
+        self.damage_list.clear();
+    }
+
     // =========================================================================
     // Internal Helpers
     // =========================================================================
 
     fn allocateIndex(self: *LayoutEngine) !u32 {
-        if (self.free_list.len > 0) {
-            return self.free_list.pop();
+        if (self.free_list.pop()) |index| {
+            return index;
         }
 
-        if (self.element_count >= MAX_ELEMENTS) {
-            return error.TooManyElements;
+        if (self.element_count >= self.capacity) {
+            try self.grow();
         }
 
         const index = self.element_count;
         self.element_count += 1;
+
+        // Fresh slot: storage is uninitialized until first use
+        self.computed_rects[index] = Rect.zero();
+        self.offsets[index] = Point.zero();
+        self.absolute_positions[index] = Point.zero();
+        self.reported_rects[index] = Rect.zero();
+        self.scroll_offsets[index] = Point.zero();
+        self.content_sizes[index] = .{ .width = 0, .height = 0 };
+        self.layout_cache[index] = .{};
+        self.measure_cache[index] = .{};
+        self.measures[index] = .{};
         return index;
     }
 
+    /// Dirty-bit masks carved from a storage block, one set per dirty class
+    const DirtyMasks = struct {
+        size: []DirtyBits.MaskInt,
+        position: []DirtyBits.MaskInt,
+        moved: []DirtyBits.MaskInt,
+    };
+
+    /// Point every column at its range of `block`; returns the dirty-bit masks
+    fn bindStorage(self: *LayoutEngine, block: []align(STORAGE_ALIGN) u8, capacity: u32) DirtyMasks {
+        var offset: usize = 0;
+        inline for (columns) |col| {
+            @field(self, col[0]) = takeColumn(col[1], block, &offset, capacity);
+        }
+        self.free_list.buffer = takeColumn(u32, block, &offset, capacity);
+        return .{
+            .size = takeColumn(DirtyBits.MaskInt, block, &offset, DirtyBits.maskCount(capacity)),
+            .position = takeColumn(DirtyBits.MaskInt, block, &offset, DirtyBits.maskCount(capacity)),
+            .moved = takeColumn(DirtyBits.MaskInt, block, &offset, DirtyBits.maskCount(capacity)),
+        };
+    }
+
+    /// Move storage to a block with the next power-of-two capacity
+    fn grow(self: *LayoutEngine) !void {
+        if (!self.growable or self.capacity >= MAX_CAPACITY) {
+            return error.TooManyElements;
+        }
+
+        const new_capacity = std.math.ceilPowerOfTwo(u32, self.capacity + 1) catch
+            return error.TooManyElements;
+        const block = try self.allocator.alignedAlloc(u8, STORAGE_ALIGN, storageSize(new_capacity));
+
+        const old = self.*;
+        const masks = self.bindStorage(block, new_capacity);
+
+        const used = old.element_count;
+        inline for (columns) |col| {
+            @memcpy(@field(self, col[0])[0..used], @field(old, col[0])[0..used]);
+        }
+        self.free_list.len = old.free_list.len;
+        @memcpy(self.free_list.buffer[0..old.free_list.len], old.free_list.buffer[0..old.free_list.len]);
+        self.dirty_bits.rebind(masks.size, new_capacity);
+        self.position_dirty.rebind(masks.position, new_capacity);
+        self.moved.rebind(masks.moved, new_capacity);
+
+        if (old.owns_storage) {
+            self.allocator.free(old.storage);
+        }
+        self.storage = block;
+        self.capacity = new_capacity;
+        self.owns_storage = true;
+    }
+
     fn linkChild(self: *LayoutEngine, parent: u32, child: u32) void {
+        self.children_contiguous = false;
         if (self.first_child[parent] == NULL_INDEX) {
             self.first_child[parent] = child;
         } else {
@@ -512,6 +1733,7 @@ pub const LayoutEngine = struct {
     }
 
     fn unlinkChild(self: *LayoutEngine, parent: u32, child: u32) void {
+        self.children_contiguous = false;
         if (self.first_child[parent] == child) {
             self.first_child[parent] = self.next_sibling[child];
         } else {
@@ -531,6 +1753,8 @@ pub const LayoutEngine = struct {
     // Public Queries
     // =========================================================================
 
+    /// Rect relative to the parent's origin, as computed by flexbox
+    /// (offsets excluded; see getAbsoluteRect)
     pub fn getRect(self: *const LayoutEngine, index: u32) Rect {
         return self.computed_rects[index];
     }
@@ -547,6 +1771,22 @@ pub const LayoutEngine = struct {
         return self.element_count;
     }
 
+    /// Number of nodes the current storage block can hold without growing
+    pub fn getCapacity(self: *const LayoutEngine) u32 {
+        return self.capacity;
+    }
+
+    /// Bytes used by the node storage block
+    pub fn getMemoryUsage(self: *const LayoutEngine) usize {
+        return storageSize(self.capacity);
+    }
+
+    /// Whether a node awaits layout (its rect is from the last computeLayout,
+    /// or zero if it was added since)
+    pub fn isDirty(self: *const LayoutEngine, index: u32) bool {
+        return self.dirty_bits.isDirty(index);
+    }
+
     pub fn getDirtyCount(self: *const LayoutEngine) usize {
         return self.dirty_bits.dirtyCount();
     }
@@ -646,6 +1886,138 @@ test "LayoutEngine: dirty marking stops at fixed-size" {
     try std.testing.expect(!engine.dirty_bits.isDirty(root));
 }
 
+test "LayoutEngine: change inside fixed-size container is laid out" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+    const fixed = try engine.addElement(root, .{ .direction = .column, .width = 200, .height = 200 });
+    const first = try engine.addElement(fixed, .{ .height = 50 });
+    const second = try engine.addElement(fixed, .{ .height = 50 });
+
+    try engine.computeLayout(400, 600);
+    try std.testing.expectEqual(@as(f32, 50), engine.getRect(second).y);
+
+    // Root stays clean; the fixed container is recomputed on its own
+    engine.setStyle(first, .{ .height = 80 });
+    try std.testing.expect(!engine.dirty_bits.isDirty(root));
+
+    try engine.computeLayout(400, 600);
+    try std.testing.expectEqual(@as(f32, 80), engine.getRect(second).y);
+    try std.testing.expectEqual(@as(usize, 0), engine.getDirtyCount());
+}
+
+test "LayoutEngine: nested fixed-size panels edited in the same frame" {
+    const pool = try thread_pool.Pool.init(std.testing.allocator, .{ .thread_count = 4 });
+    defer pool.deinit();
+
+    for ([_]bool{ false, true }) |use_pool| {
+        var engine = try LayoutEngine.init(std.testing.allocator);
+        defer engine.deinit();
+
+        engine.beginFrame();
+
+        // root -> outer (fixed) -> [label, group (auto) -> inner (fixed) -> [first, second]]
+        const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+        const outer = try engine.addElement(root, .{ .direction = .column, .width = 300, .height = 300 });
+        const label = try engine.addElement(outer, .{ .height = 20 });
+        const group = try engine.addElement(outer, .{ .direction = .column });
+        const inner = try engine.addElement(group, .{ .direction = .column, .width = 100, .height = 100 });
+        const first = try engine.addElement(inner, .{ .height = 10 });
+        const second = try engine.addElement(inner, .{ .height = 10 });
+
+        if (use_pool) try engine.computeLayoutParallel(pool, 400, 600) else try engine.computeLayout(400, 600);
+        try std.testing.expectEqual(@as(f32, 10), engine.getRect(second).y);
+
+        // Both panels become barrier roots; the group between them stays clean
+        engine.setStyle(label, .{ .height = 40 });
+        engine.setStyle(first, .{ .height = 30 });
+        try std.testing.expect(engine.dirty_bits.isDirty(outer));
+        try std.testing.expect(engine.dirty_bits.isDirty(inner));
+        try std.testing.expect(!engine.dirty_bits.isDirty(group));
+
+        if (use_pool) try engine.computeLayoutParallel(pool, 400, 600) else try engine.computeLayout(400, 600);
+        try std.testing.expectEqual(@as(f32, 40), engine.getRect(group).y);
+        try std.testing.expectEqual(@as(f32, 30), engine.getRect(second).y);
+        try std.testing.expectEqual(@as(usize, 0), engine.getDirtyCount());
+    }
+}
+
+test "LayoutEngine: absolute children sit out the flex pass" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+    const form = try engine.addElement(root, .{ .direction = .column, .width = 300, .padding_top = 10 });
+    const first = try engine.addElement(form, .{ .height = 50 });
+    const popup = try engine.addElement(form, .{ .position = .absolute, .top = 20, .right = 30, .width = 100 });
+    _ = try engine.addElement(popup, .{ .height = 40 });
+    const second = try engine.addElement(form, .{ .height = 50 });
+    const overlay = try engine.addElement(form, .{ .position = .absolute, .left = 0, .right = 0, .top = 0, .bottom = 0 });
+
+    try engine.computeLayout(400, 600);
+
+    // In-flow siblings close up; the form is sized by them alone
+    try std.testing.expectEqual(@as(f32, 10), engine.getRect(first).y);
+    try std.testing.expectEqual(@as(f32, 60), engine.getRect(second).y);
+    try std.testing.expectEqual(@as(f32, 110), engine.getRect(form).height);
+
+    // Insets from the padding box; auto height fits content
+    try std.testing.expectEqual(Rect{ .x = 170, .y = 30, .width = 100, .height = 40 }, engine.getRect(popup));
+    try std.testing.expectEqual(Rect{ .x = 0, .y = 10, .width = 300, .height = 100 }, engine.getRect(overlay));
+
+    // Leaving the flow re-lays out the siblings
+    engine.setStyle(first, .{ .height = 50, .position = .absolute });
+    try std.testing.expect(engine.dirty_bits.isDirty(form));
+    try engine.computeLayout(400, 600);
+    try std.testing.expectEqual(@as(f32, 10), engine.getRect(second).y);
+    try std.testing.expectEqual(@as(f32, 60), engine.getRect(form).height);
+}
+
+test "LayoutEngine: absolute subtree changes cost only their own subtree" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .align_items = .stretch, .width = 400, .height = 600 });
+    const form = try engine.addElement(root, .{ .direction = .column, .align_items = .stretch });
+    var fields: [20]u32 = undefined;
+    for (&fields) |*field| field.* = try engine.addElement(form, .{ .height = 24 });
+    try engine.computeLayout(400, 600);
+
+    // Opening a popup marks nothing above or beside it
+    const popup = try engine.addElement(form, .{ .position = .absolute, .bottom = 0, .right = 0 });
+    const item = try engine.addElement(popup, .{ .width = 120, .height = 30 });
+    try std.testing.expect(!engine.dirty_bits.isDirty(form));
+    try std.testing.expect(!engine.dirty_bits.isDirty(root));
+
+    engine.resetCacheStats();
+    try engine.computeLayout(400, 600);
+    try std.testing.expectEqual(Rect{ .x = 280, .y = 450, .width = 120, .height = 30 }, engine.getRect(popup));
+    // The popup's content probe and its layout pass, nothing for the form
+    try std.testing.expectEqual(@as(u64, 0), engine.getCacheStats().hits);
+    try std.testing.expectEqual(@as(u64, 2), engine.getCacheStats().misses);
+    try std.testing.expectEqual(@as(usize, 0), engine.getDirtyCount());
+
+    // Growing its content re-anchors it to the bottom-right corner
+    engine.setStyle(item, .{ .width = 160, .height = 50 });
+    try std.testing.expect(!engine.dirty_bits.isDirty(form));
+    try engine.computeLayout(400, 600);
+    try std.testing.expectEqual(Rect{ .x = 240, .y = 430, .width = 160, .height = 50 }, engine.getRect(popup));
+    try std.testing.expectEqual(@as(f32, 24 * 19), engine.getRect(fields[19]).y);
+
+    // Closing it leaves the form clean too
+    engine.removeElement(popup);
+    try std.testing.expect(!engine.dirty_bits.isDirty(form));
+    try engine.computeLayout(400, 600);
+    try std.testing.expectEqual(@as(usize, 0), engine.getDirtyCount());
+}
+
 test "LayoutEngine: size change cascades to children" {
     var engine = try LayoutEngine.init(std.testing.allocator);
     defer engine.deinit();
@@ -716,6 +2088,27 @@ test "LayoutEngine: reparent" {
     try std.testing.expectEqual(container2, engine.parent[child]);
 }
 
+test "LayoutEngine: updateStyle skips identical styles" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+    const child = try engine.addElement(root, .{ .height = 50 });
+    try engine.computeLayout(400, 600);
+
+    // Same style: no write, nothing dirty
+    try std.testing.expect(!engine.updateStyle(child, .{ .height = 50 }));
+    try std.testing.expectEqual(@as(usize, 0), engine.getDirtyCount());
+    try std.testing.expectEqual(@as(u64, 1), engine.getCacheStats().style_writes_skipped);
+
+    // Changed style: written and marked
+    try std.testing.expect(engine.updateStyle(child, .{ .height = 60 }));
+    try std.testing.expect(engine.dirty_bits.isDirty(child));
+    try std.testing.expect(engine.dirty_bits.isDirty(root));
+}
+
 test "LayoutEngine: free list reuse" {
     var engine = try LayoutEngine.init(std.testing.allocator);
     defer engine.deinit();
@@ -733,6 +2126,56 @@ test "LayoutEngine: free list reuse" {
     try std.testing.expectEqual(@as(usize, 0), engine.free_list.len);
 }
 
+test "LayoutEngine: removeSubtree frees a tab and hands its slots back in order" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const Tab = struct {
+        fn build(e: *LayoutEngine, parent: u32, nodes: []u32) !void {
+            var n: usize = 0;
+            nodes[n] = try e.addElement(parent, .{ .direction = .column });
+            n += 1;
+            for (0..3) |_| {
+                const section = try e.addElement(nodes[0], .{ .direction = .row });
+                nodes[n] = section;
+                n += 1;
+                for (0..4) |_| {
+                    nodes[n] = try e.addElement(section, .{ .width = 10, .height = 10 });
+                    n += 1;
+                }
+            }
+        }
+    };
+
+    const root = try engine.addElement(null, .{ .direction = .row, .width = 400, .height = 300 });
+    const sidebar = try engine.addElement(root, .{ .width = 100 });
+    var tab: [16]u32 = undefined;
+    try Tab.build(&engine, root, &tab);
+    try engine.computeLayout(400, 300);
+
+    const freed = engine.removeSubtree(tab[0]);
+    try std.testing.expectEqual(@as(usize, 16), freed.len);
+    try std.testing.expectEqual(@as(usize, 16), engine.free_list.len);
+    try std.testing.expectEqual(@as(u16, 1), engine.child_count[root]);
+    try std.testing.expectEqual(sidebar, engine.first_child[root]);
+    try std.testing.expect(engine.dirty_bits.isDirty(root));
+    for (tab) |node| {
+        try std.testing.expectEqual(NULL_INDEX, engine.parent[node]);
+        try std.testing.expect(!engine.dirty_bits.isDirty(node));
+    }
+
+    // The same tab built again gets the same slots, node for node
+    var again: [16]u32 = undefined;
+    try Tab.build(&engine, root, &again);
+    try std.testing.expectEqualSlices(u32, &tab, &again);
+    try std.testing.expectEqual(@as(usize, 0), engine.free_list.len);
+
+    try engine.computeLayout(400, 300);
+    try std.testing.expectEqual(@as(f32, 100), engine.getRect(again[0]).x);
+}
+
 test "LayoutEngine: cache hit on root-level leaf" {
     // NOTE: Only root-level leaves use computeLeafLayout and its cache.
     // Nested leaves are computed by flexbox (different algorithm that
@@ -881,3 +2324,557 @@ test "LayoutEngine: stack buffer for small child counts" {
         expected_y += 20;
     }
 }
+
+test "LayoutEngine: growable storage keeps nodes when growing" {
+    var engine = try LayoutEngine.initOptions(std.testing.allocator, .{ .initial_capacity = 4 });
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+    for (0..20) |_| {
+        _ = try engine.addElement(root, .{ .height = 10 });
+    }
+
+    try std.testing.expectEqual(@as(u32, 21), engine.getElementCount());
+    try std.testing.expectEqual(@as(u32, 32), engine.getCapacity());
+    try std.testing.expectEqual(@as(u16, 20), engine.child_count[root]);
+    try std.testing.expect(engine.dirty_bits.isDirty(root));
+
+    try engine.computeLayout(400, 600);
+    try std.testing.expectEqual(@as(f32, 190), engine.getRect(20).y);
+}
+
+test "LayoutEngine: storage size matches the documented figures" {
+    // Update the Storage section of the file header when this fails
+    try std.testing.expectEqual(@as(usize, 270), storageSize(4096) / 4096);
+    try std.testing.expectEqual(@as(usize, 17), storageSize(64) / 1000);
+    try std.testing.expectEqual(@as(usize, 69), storageSize(256) / 1000);
+    try std.testing.expectEqual(@as(usize, 11), storageSize(4096) / 100_000);
+}
+
+test "LayoutEngine: fixed storage enforces capacity" {
+    var storage: LayoutEngine.FixedStorage(4) = .{};
+    var engine = LayoutEngine.initFixed(std.testing.allocator, &storage);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .width = 100, .height = 100 });
+    for (0..3) |_| {
+        _ = try engine.addElement(root, .{ .height = 10 });
+    }
+
+    try std.testing.expectError(error.TooManyElements, engine.addElement(root, .{}));
+
+    // Freed slots are still reusable at capacity
+    engine.removeElement(3);
+    _ = try engine.addElement(root, .{ .height = 10 });
+    try std.testing.expectEqual(@as(u32, 4), engine.getCapacity());
+}
+
+/// Fake text measurer: 7px per character, 16px lines, wraps at available width
+const TestText = struct {
+    len: f32,
+    calls: u32 = 0,
+
+    fn measure(context: ?*anyopaque, index: u32, available_width: f32, available_height: f32) Size {
+        _ = index;
+        _ = available_height;
+        const self: *TestText = @ptrCast(@alignCast(context.?));
+        self.calls += 1;
+        const full = self.len * 7;
+        const lines = @max(1, @ceil(full / available_width));
+        return .{ .width = @min(full, available_width), .height = lines * 16 };
+    }
+};
+
+test "LayoutEngine: measure callback sizes auto leaves" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600, .align_items = .flex_start, .padding_left = 10, .padding_right = 10 });
+    const label = try engine.addElement(root, .{});
+    const fixed = try engine.addElement(root, .{ .width = 50 });
+
+    var short = TestText{ .len = 10 };
+    var long = TestText{ .len = 100 };
+    engine.setMeasureFunc(label, TestText.measure, &short);
+    engine.setMeasureFunc(fixed, TestText.measure, &long);
+
+    try engine.computeLayout(400, 600);
+
+    try std.testing.expectEqual(@as(f32, 70), engine.getRect(label).width);
+    try std.testing.expectEqual(@as(f32, 16), engine.getRect(label).height);
+    // Explicit width wins and is the wrap width: 700px of text = 14 lines
+    try std.testing.expectEqual(@as(f32, 50), engine.getRect(fixed).width);
+    try std.testing.expectEqual(@as(f32, 224), engine.getRect(fixed).height);
+    try std.testing.expectEqual(@as(f32, 16), engine.getRect(fixed).y);
+}
+
+test "LayoutEngine: measured leaves stretch on the cross axis" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600, .align_items = .stretch, .padding_left = 10, .padding_right = 10 });
+    const label = try engine.addElement(root, .{});
+    const paragraph = try engine.addElement(root, .{});
+    const row = try engine.addElement(root, .{ .direction = .row, .height = 100, .align_items = .stretch });
+    const cell = try engine.addElement(row, .{});
+
+    var short = TestText{ .len = 10 };
+    var long = TestText{ .len = 100 };
+    var cell_text = TestText{ .len = 4 };
+    engine.setMeasureFunc(label, TestText.measure, &short);
+    engine.setMeasureFunc(paragraph, TestText.measure, &long);
+    engine.setMeasureFunc(cell, TestText.measure, &cell_text);
+
+    try engine.computeLayout(400, 600);
+
+    // Column: the row width is filled, the height is the text's
+    try std.testing.expectEqual(@as(f32, 380), engine.getRect(label).width);
+    try std.testing.expectEqual(@as(f32, 16), engine.getRect(label).height);
+    // 700px of text wraps at 380px: 2 lines
+    try std.testing.expectEqual(@as(f32, 380), engine.getRect(paragraph).width);
+    try std.testing.expectEqual(@as(f32, 32), engine.getRect(paragraph).height);
+    // Row: the width is the text's, the height is filled
+    try std.testing.expectEqual(@as(f32, 28), engine.getRect(cell).width);
+    try std.testing.expectEqual(@as(f32, 100), engine.getRect(cell).height);
+}
+
+test "LayoutEngine: measure results are memoized" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    const root = try engine.addElement(null, .{ .direction = .row, .height = 100 });
+    const label = try engine.addElement(root, .{});
+    const sibling = try engine.addElement(root, .{ .width = 20 });
+
+    var text = TestText{ .len = 4 };
+    engine.setMeasureFunc(label, TestText.measure, &text);
+
+    engine.beginFrame();
+    try engine.computeLayout(400, 100);
+    try std.testing.expectEqual(@as(u32, 1), text.calls);
+
+    // Sibling change re-runs the container but not the measurement
+    engine.beginFrame();
+    engine.setStyle(sibling, .{ .width = 30 });
+    try engine.computeLayout(400, 100);
+    try std.testing.expectEqual(@as(u32, 1), text.calls);
+    try std.testing.expect(engine.getCacheStats().measure_hits >= 1);
+
+    // New content re-measures
+    engine.beginFrame();
+    text.len = 8;
+    engine.markContentDirty(label);
+    try engine.computeLayout(400, 100);
+    try std.testing.expectEqual(@as(u32, 2), text.calls);
+    try std.testing.expectEqual(@as(f32, 56), engine.getRect(label).width);
+    try std.testing.expectEqual(@as(f32, 56), engine.getRect(sibling).x);
+
+    // New constraints re-measure
+    engine.beginFrame();
+    engine.setStyle(root, .{ .direction = .row, .height = 100, .padding_left = 100 });
+    try engine.computeLayout(400, 100);
+    try std.testing.expectEqual(@as(u32, 3), text.calls);
+}
+
+test "LayoutEngine: auto-sized containers are sized to content" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+    const toolbar = try engine.addElement(root, .{ .direction = .row, .gap = 4, .padding_top = 2, .padding_bottom = 2 });
+    for (0..3) |_| {
+        _ = try engine.addElement(toolbar, .{ .width = 50, .height = 30 });
+    }
+    const body = try engine.addElement(root, .{ .height = 100 });
+
+    try engine.computeLayout(400, 600);
+
+    try std.testing.expectEqual(@as(f32, 158), engine.getRect(toolbar).width);
+    try std.testing.expectEqual(@as(f32, 34), engine.getRect(toolbar).height);
+    try std.testing.expectEqual(@as(f32, 34), engine.getRect(body).y);
+    try std.testing.expectEqual(@as(f32, 108), engine.getRect(toolbar + 3).x);
+}
+
+test "LayoutEngine: max-content probes hit the cache on the next pass" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+    const toolbar = try engine.addElement(root, .{ .direction = .row });
+    _ = try engine.addElement(toolbar, .{ .width = 50, .height = 30 });
+    const body = try engine.addElement(root, .{ .height = 100 });
+
+    try engine.computeLayout(400, 600);
+
+    // Sibling change: root re-runs flexbox and probes the toolbar again
+    engine.resetCacheStats();
+    engine.setStyle(body, .{ .height = 120 });
+    try engine.computeLayout(400, 600);
+
+    const stats = engine.getCacheStats();
+    const max_content = @intFromEnum(cache.SlotKind.max_content);
+    try std.testing.expectEqual(@as(u64, 1), stats.slot_hits[max_content]);
+    try std.testing.expectEqual(@as(u64, 0), stats.slot_misses[max_content]);
+    try std.testing.expectEqual(@as(f32, 30), engine.getRect(body).y);
+
+    // A change inside the toolbar invalidates the probe
+    engine.resetCacheStats();
+    engine.setStyle(toolbar + 1, .{ .width = 50, .height = 40 });
+    try engine.computeLayout(400, 600);
+    try std.testing.expectEqual(@as(u64, 1), engine.getCacheStats().slot_misses[max_content]);
+    try std.testing.expectEqual(@as(f32, 40), engine.getRect(body).y);
+}
+
+test "LayoutEngine: compact renumbers into contiguous depth-first families" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    // Interleave two containers' children, then churn through the free list
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+    const left = try engine.addElement(root, .{ .direction = .row, .height = 100 });
+    const right = try engine.addElement(root, .{ .direction = .row, .height = 100 });
+    var left_items: [3]u32 = undefined;
+    for (&left_items, 0..) |*item, i| {
+        item.* = try engine.addElement(left, .{ .width = @floatFromInt(10 + i), .height = 10 });
+        _ = try engine.addElement(right, .{ .width = 5, .height = 5 });
+    }
+    const late = try engine.addElement(left, .{ .width = 40, .height = 10 });
+    engine.removeElement(left_items[1]);
+
+    try engine.computeLayout(400, 600);
+    const late_rect = engine.getRect(late);
+    const right_rect = engine.getRect(right);
+
+    var remap: [16]u32 = undefined;
+    try engine.compact(remap[0..engine.getElementCount()]);
+
+    try std.testing.expect(engine.hasContiguousChildren());
+    try std.testing.expectEqual(@as(u32, 9), engine.getElementCount());
+    try std.testing.expectEqual(@as(u32, 0), remap[root]);
+    try std.testing.expectEqual(@as(u32, 1), remap[left]);
+    try std.testing.expectEqual(@as(u32, 2), remap[right]);
+    try std.testing.expectEqual(NULL_INDEX, remap[left_items[1]]);
+    try std.testing.expectEqual(late_rect, engine.getRect(remap[late]));
+    try std.testing.expectEqual(right_rect, engine.getRect(remap[right]));
+
+    // Children are consecutive: left's 3, then right's 3
+    for (0..engine.getElementCount()) |i| {
+        const index: u32 = @intCast(i);
+        var expected = engine.first_child[index];
+        var child = expected;
+        while (child != NULL_INDEX) : (child = engine.next_sibling[child]) {
+            try std.testing.expectEqual(expected, child);
+            try std.testing.expectEqual(index, engine.parent[child]);
+            expected += 1;
+        }
+    }
+    try std.testing.expectEqual(@as(u32, 3), engine.first_child[remap[left]]);
+    try std.testing.expectEqual(@as(u32, 6), engine.first_child[remap[right]]);
+
+    // Linear-gather layout matches the linked-list layout
+    engine.setStyle(remap[left], .{ .direction = .row, .height = 100, .gap = 2 });
+    try engine.computeLayout(400, 600);
+    try std.testing.expect(engine.hasContiguousChildren());
+    try std.testing.expectEqual(@as(f32, late_rect.x + 4), engine.getRect(remap[late]).x);
+
+    // Structural change ends the contiguous mode
+    _ = try engine.addElement(remap[left], .{});
+    try std.testing.expect(!engine.hasContiguousChildren());
+}
+
+test "LayoutEngine: compact permutes caller-owned storage in place" {
+    var owned = try LayoutEngine.init(std.testing.allocator);
+    defer owned.deinit();
+    // Compacting must not allocate: a failing scratch allocator proves it
+    var storage: LayoutEngine.FixedStorage(16) = .{};
+    var fixed = LayoutEngine.initFixed(std.testing.failing_allocator, &storage);
+    defer fixed.deinit();
+
+    var remaps: [2][16]u32 = undefined;
+    for ([_]*LayoutEngine{ &owned, &fixed }, &remaps) |engine, *remap| {
+        engine.beginFrame();
+        const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+        const left = try engine.addElement(root, .{ .direction = .row, .height = 100 });
+        const right = try engine.addElement(root, .{ .direction = .row, .height = 100 });
+        for (0..4) |i| {
+            _ = try engine.addElement(left, .{ .width = @floatFromInt(10 + i), .height = 10 });
+            _ = try engine.addElement(right, .{ .width = @floatFromInt(20 + i), .height = 5 });
+        }
+        engine.removeElement(5);
+        try engine.computeLayout(400, 600);
+        engine.setStyle(8, .{ .width = 30, .height = 5 });
+
+        try engine.compact(remap[0..engine.getElementCount()]);
+    }
+
+    try std.testing.expectEqual(owned.getElementCount(), fixed.getElementCount());
+    try std.testing.expectEqualSlices(u32, remaps[0][0..11], remaps[1][0..11]);
+    try std.testing.expect(fixed.hasContiguousChildren());
+    for (0..owned.getElementCount()) |i| {
+        const index: u32 = @intCast(i);
+        try std.testing.expectEqual(owned.getRect(index), fixed.getRect(index));
+        try std.testing.expectEqual(owned.parent[index], fixed.parent[index]);
+        try std.testing.expectEqual(owned.first_child[index], fixed.first_child[index]);
+        try std.testing.expectEqual(owned.next_sibling[index], fixed.next_sibling[index]);
+        try std.testing.expectEqual(owned.dirty_bits.isDirty(index), fixed.dirty_bits.isDirty(index));
+    }
+
+    // Both lay out the pending edit the same way
+    try owned.computeLayout(400, 600);
+    try fixed.computeLayout(400, 600);
+    for (0..owned.getElementCount()) |i| {
+        try std.testing.expectEqual(owned.getRect(@intCast(i)), fixed.getRect(@intCast(i)));
+    }
+}
+
+test "LayoutEngine: absolute rects accumulate parent origins" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600, .padding_top = 5 });
+    const header = try engine.addElement(root, .{ .height = 40 });
+    const body = try engine.addElement(root, .{ .direction = .row, .height = 200, .padding_left = 8 });
+    const cell = try engine.addElement(body, .{ .width = 30, .height = 30 });
+    try engine.computeLayout(400, 600);
+
+    try std.testing.expectEqual(@as(f32, 0), engine.getRect(cell).y);
+    const cell_abs = engine.getAbsoluteRect(cell);
+    try std.testing.expectEqual(@as(f32, 8), cell_abs.x);
+    try std.testing.expectEqual(@as(f32, 45), cell_abs.y);
+    try std.testing.expectEqual(@as(f32, 30), cell_abs.width);
+    try std.testing.expectEqual(@as(usize, 0), engine.position_dirty.dirtyCount());
+
+    // Relayout that moves the body moves the cell with it
+    engine.setStyle(header, .{ .height = 60 });
+    try engine.computeLayout(400, 600);
+    try std.testing.expectEqual(@as(f32, 65), engine.getAbsoluteRect(cell).y);
+}
+
+test "LayoutEngine: setOffset moves a subtree without relayout" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    // Dock panel with content, dragged around every frame
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 800, .height = 600 });
+    const panel = try engine.addElement(root, .{ .direction = .column, .width = 200, .height = 300, .padding_top = 20 });
+    const content = try engine.addElement(panel, .{ .height = 50 });
+    const leaf = try engine.addElement(content, .{ .width = 10, .height = 10 });
+    try engine.computeLayout(800, 600);
+    engine.updatePositions();
+
+    engine.resetCacheStats();
+    engine.setOffset(panel, 120, 45);
+    try std.testing.expectEqual(@as(usize, 0), engine.getDirtyCount());
+    try std.testing.expectEqual(@as(usize, 1), engine.position_dirty.dirtyCount());
+
+    // Nothing to lay out: flexbox does not run
+    try engine.computeLayout(800, 600);
+    const stats = engine.getCacheStats();
+    try std.testing.expectEqual(@as(u64, 0), stats.hits + stats.misses);
+
+    try std.testing.expectEqual(@as(f32, 120), engine.getAbsoluteRect(leaf).x);
+    try std.testing.expectEqual(@as(f32, 65), engine.getAbsoluteRect(leaf).y);
+    try std.testing.expectEqual(@as(f32, 0), engine.getRect(panel).x);
+
+    // Same offset again is a no-op
+    engine.setOffset(panel, 120, 45);
+    try std.testing.expectEqual(@as(usize, 0), engine.position_dirty.dirtyCount());
+}
+
+test "LayoutEngine: scroll containers translate content without relayout" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    // Log pane: 100 lines of 20px in a 600px viewport
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+    const pane = try engine.addElement(root, .{ .direction = .column, .flex_grow = 1, .overflow = .scroll });
+    var lines: [100]u32 = undefined;
+    for (&lines) |*line| {
+        line.* = try engine.addElement(pane, .{ .width = 100, .height = 20 });
+    }
+    try engine.computeLayout(400, 600);
+
+    // Viewport is what the parent gave; content keeps its natural size
+    try std.testing.expectEqual(@as(f32, 600), engine.getRect(pane).height);
+    try std.testing.expectEqual(@as(f32, 2000), engine.getContentSize(pane).height);
+    try std.testing.expectEqual(@as(f32, 20), engine.getRect(lines[99]).height);
+
+    engine.resetCacheStats();
+    engine.setScrollOffset(pane, 0, 500);
+    try std.testing.expectEqual(@as(usize, 0), engine.getDirtyCount());
+    try engine.computeLayout(400, 600);
+    const stats = engine.getCacheStats();
+    try std.testing.expectEqual(@as(u64, 0), stats.hits + stats.misses);
+
+    try std.testing.expectEqual(@as(f32, 0), engine.getAbsoluteRect(pane).y);
+    try std.testing.expectEqual(@as(f32, 100), engine.getAbsoluteRect(lines[30]).y);
+
+    // Clamped to content - viewport
+    engine.setScrollOffset(pane, -10, 99999);
+    try std.testing.expectEqual(@as(f32, 0), engine.getScrollOffset(pane).x);
+    try std.testing.expectEqual(@as(f32, 1400), engine.getScrollOffset(pane).y);
+    try std.testing.expectEqual(@as(f32, 580), engine.getAbsoluteRect(lines[99]).y);
+
+    // Content that shrinks under the scroll position pulls it back
+    engine.setStyle(lines[0], .{ .width = 100, .height = 5 });
+    try engine.computeLayout(400, 600);
+    try std.testing.expectEqual(@as(f32, 1385), engine.getScrollOffset(pane).y);
+    try std.testing.expectEqual(@as(f32, 580), engine.getAbsoluteRect(lines[99]).y);
+}
+
+test "LayoutEngine: moved nodes are exactly the ones whose rects changed" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 400, .height = 600 });
+    const pinned = try engine.addElement(root, .{ .height = 10 });
+    const header = try engine.addElement(root, .{ .height = 40 });
+    const body = try engine.addElement(root, .{ .direction = .row, .height = 100 });
+    const cell = try engine.addElement(body, .{ .width = 30, .height = 30 });
+    try engine.computeLayout(400, 600);
+    engine.updatePositions();
+
+    // New nodes all count as moved
+    try std.testing.expectEqual(@as(usize, 5), engine.moved.dirtyCount());
+    engine.clearMoved();
+    try std.testing.expectEqual(@as(?u32, null), engine.nextMoved(0));
+
+    // Resizing the header resizes it and pushes the body down
+    engine.setStyle(header, .{ .height = 60 });
+    try engine.computeLayout(400, 600);
+    engine.updatePositions();
+
+    var moved: [8]u32 = undefined;
+    var count: usize = 0;
+    var next = engine.nextMoved(0);
+    while (next) |index| : (next = engine.nextMoved(index + 1)) {
+        moved[count] = index;
+        count += 1;
+    }
+    try std.testing.expectEqualSlices(u32, &.{ header, body, cell }, moved[0..count]);
+    try std.testing.expect(!engine.moved.isDirty(pinned));
+    try std.testing.expect(!engine.moved.isDirty(root));
+    engine.clearMoved();
+
+    // Translation moves the subtree only
+    engine.setOffset(body, 5, 0);
+    engine.updatePositions();
+    try std.testing.expectEqual(@as(?u32, body), engine.nextMoved(0));
+    try std.testing.expectEqual(@as(usize, 2), engine.moved.dirtyCount());
+}
+
+test "LayoutEngine: damage covers old and new rects of changed nodes only" {
+    var engine = try LayoutEngine.init(std.testing.allocator);
+    defer engine.deinit();
+
+    engine.beginFrame();
+
+    const root = try engine.addElement(null, .{ .direction = .row, .width = 400, .height = 300 });
+    const left = try engine.addElement(root, .{ .width = 100, .height = 300 });
+    _ = try engine.addElement(root, .{ .width = 200, .height = 300 });
+    const right = try engine.addElement(root, .{ .width = 100, .height = 300 });
+    const a = try engine.addElement(left, .{ .width = 100, .height = 20 });
+    const b = try engine.addElement(left, .{ .width = 100, .height = 20 });
+    const badge = try engine.addElement(right, .{ .width = 100, .height = 10 });
+    try engine.computeLayout(400, 300);
+
+    // First report: everything is new
+    try std.testing.expectEqualSlices(Rect, &.{.{ .x = 0, .y = 0, .width = 400, .height = 300 }}, engine.collectDamage());
+    engine.clearMoved();
+    engine.clearDamage();
+
+    // Nothing changed, nothing to repaint
+    try std.testing.expectEqual(@as(usize, 0), engine.collectDamage().len);
+
+    // Growing `a` pushes `b` down; the badge grows on the far side
+    engine.setStyle(a, .{ .width = 100, .height = 30 });
+    engine.setStyle(badge, .{ .width = 100, .height = 15 });
+    try engine.computeLayout(400, 300);
+    const damage_rects = engine.collectDamage();
+    try std.testing.expectEqual(@as(usize, 2), damage_rects.len);
+    for (damage_rects) |region| {
+        const expected: Rect = if (region.x == 0)
+            .{ .x = 0, .y = 0, .width = 100, .height = 50 }
+        else
+            .{ .x = 300, .y = 0, .width = 100, .height = 15 };
+        try std.testing.expectEqual(expected, region);
+    }
+    engine.clearMoved();
+    engine.clearDamage();
+
+    // A removed node leaves its last reported rect behind
+    engine.removeElement(b);
+    try engine.computeLayout(400, 300);
+    try std.testing.expectEqualSlices(Rect, &.{.{ .x = 0, .y = 30, .width = 100, .height = 20 }}, engine.collectDamage());
+}
+
+/// Trading-UI shape: a column of rows, each row holding fixed-size panels
+fn buildPanelTree(engine: *LayoutEngine, rows: u32, panels_per_row: u32, items_per_panel: u32) !void {
+    const root = try engine.addElement(null, .{ .direction = .column, .width = 1600, .height = 900 });
+    for (0..rows) |_| {
+        const row = try engine.addElement(root, .{ .direction = .row, .flex_grow = 1, .gap = 4 });
+        for (0..panels_per_row) |_| {
+            const panel = try engine.addElement(row, .{ .direction = .column, .width = 120, .height = 200, .padding_top = 2 });
+            for (0..items_per_panel) |i| {
+                _ = try engine.addElement(panel, .{ .height = @floatFromInt(4 + i % 3), .flex_grow = 1 });
+            }
+        }
+    }
+}
+
+test "LayoutEngine: parallel layout matches serial layout" {
+    var serial = try LayoutEngine.init(std.testing.allocator);
+    defer serial.deinit();
+    var concurrent = try LayoutEngine.init(std.testing.allocator);
+    defer concurrent.deinit();
+
+    const pool = try thread_pool.Pool.init(std.testing.allocator, .{ .thread_count = 4 });
+    defer pool.deinit();
+
+    serial.beginFrame();
+    concurrent.beginFrame();
+    try buildPanelTree(&serial, 4, 8, 40);
+    try buildPanelTree(&concurrent, 4, 8, 40);
+
+    try serial.computeLayout(1600, 900);
+    try concurrent.computeLayoutParallel(pool, 1600, 900);
+
+    for (0..serial.getElementCount()) |i| {
+        try std.testing.expectEqual(serial.getRect(@intCast(i)), concurrent.getRect(@intCast(i)));
+    }
+    try std.testing.expectEqual(@as(usize, 0), concurrent.getDirtyCount());
+
+    // Edits inside panels (behind fixed-size barriers) take the phase-1 path
+    const panel_child: u32 = 3; // root, row, panel, first item
+    serial.setStyle(panel_child, .{ .height = 30 });
+    concurrent.setStyle(panel_child, .{ .height = 30 });
+    try serial.computeLayout(1600, 900);
+    try concurrent.computeLayoutParallel(pool, 1600, 900);
+
+    for (0..serial.getElementCount()) |i| {
+        try std.testing.expectEqual(serial.getRect(@intCast(i)), concurrent.getRect(@intCast(i)));
+    }
+    try std.testing.expectEqual(serial.getCacheStats().misses, concurrent.getCacheStats().misses);
+}
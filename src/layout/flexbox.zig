@@ -6,6 +6,7 @@
 const std = @import("std");
 const simd = @import("simd.zig");
 const cache = @import("cache.zig");
+const scalar = @import("scalar.zig");
 
 /// Flexbox direction
 pub const FlexDirection = enum(u8) {
@@ -31,302 +32,663 @@ pub const AlignItems = enum(u8) {
     stretch = 3,
 };
 
-/// Flexbox style properties (56 bytes - cache-line friendly)
-pub const FlexStyle = struct {
-    // Layout direction and alignment (3 bytes)
-    direction: FlexDirection = .column,
-    justify_content: JustifyContent = .flex_start,
-    align_items: AlignItems = .flex_start,
-
-    // Flex item properties (8 bytes)
-    flex_grow: f32 = 0.0,
-    flex_shrink: f32 = 1.0,
-
-    // Dimensions (24 bytes)
-    width: f32 = -1.0, // -1 = auto
-    height: f32 = -1.0,
-    min_width: f32 = 0.0,
-    min_height: f32 = 0.0,
-    max_width: f32 = std.math.inf(f32),
-    max_height: f32 = std.math.inf(f32),
-
-    // Spacing (20 bytes)
-    gap: f32 = 0.0,
-    padding_top: f32 = 0.0,
-    padding_right: f32 = 0.0,
-    padding_bottom: f32 = 0.0,
-    padding_left: f32 = 0.0,
-
-    comptime {
-        const size = @sizeOf(FlexStyle);
-        if (size != 56) {
-            @compileError(std.fmt.comptimePrint(
-                "FlexStyle size is {} bytes, expected 56 for cache efficiency",
-                .{size},
-            ));
-        }
-    }
+/// Line wrapping
+pub const FlexWrap = enum(u8) {
+    nowrap = 0,
+    wrap = 1,
+    wrap_reverse = 2,
 };
 
-/// Layout result for a single element
-pub const LayoutResult = struct {
-    x: f32 = 0,
-    y: f32 = 0,
-    width: f32 = 0,
-    height: f32 = 0,
+/// Cross axis distribution of lines (multi-line containers only)
+pub const AlignContent = enum(u8) {
+    flex_start = 0,
+    center = 1,
+    flex_end = 2,
+    stretch = 3,
+    space_between = 4,
+    space_around = 5,
 };
 
-/// Child element measurement for flexbox algorithm
-const ChildMeasurement = struct {
-    /// Hypothetical main size (before flex)
-    base_size: f32 = 0,
-
-    /// Final size after flex
-    main_size: f32 = 0,
-    cross_size: f32 = 0,
-
-    /// Flex factors
-    flex_grow: f32 = 0,
-    flex_shrink: f32 = 1,
+/// Content that overflows the container box
+pub const Overflow = enum(u8) {
+    /// Drawn outside the box, no clip
+    visible = 0,
+    /// Clipped to the box
+    hidden = 1,
+    /// Clipped, laid out at natural size and translated by a scroll offset
+    scroll = 2,
+};
 
-    /// Constraints
-    min_main: f32 = 0,
-    max_main: f32 = std.math.inf(f32),
+/// How an element takes part in its parent's layout
+pub const Position = enum(u8) {
+    /// In flow: sized and placed by the parent's flex pass
+    relative = 0,
+    /// Out of flow: placed by its insets against the parent's padding box.
+    /// Takes no space among its siblings and does not size the parent, so
+    /// its changes re-lay out only its own subtree.
+    absolute = 1,
 };
 
-/// Compute flexbox layout for a container with children
-///
-/// This is a REAL flexbox implementation - no shortcuts!
-/// Steps:
-/// 1. Determine base sizes for all children
-/// 2. Resolve flexible lengths (flex-grow/shrink)
-/// 3. Calculate cross sizes
-/// 4. Align items on both axes
-/// 5. Position children
+/// Flexbox over a layout scalar (see scalar.zig)
 ///
-/// Complexity: O(n) where n = child count
-/// Performance target: ~0.05-0.10μs per child
-pub fn computeFlexLayout(
-    allocator: std.mem.Allocator,
-    container_width: f32,
-    container_height: f32,
-    container_style: FlexStyle,
-    children_styles: []const FlexStyle,
-    children_results: []LayoutResult,
-) !void {
-    std.debug.assert(children_styles.len == children_results.len);
-
-    const child_count = children_styles.len;
-    if (child_count == 0) return;
-
-    const is_row = container_style.direction == .row;
-
-    // Calculate content area (container minus padding)
-    const padding_main_start = if (is_row) container_style.padding_left else container_style.padding_top;
-    const padding_main_end = if (is_row) container_style.padding_right else container_style.padding_bottom;
-    const padding_cross_start = if (is_row) container_style.padding_top else container_style.padding_left;
-    const padding_cross_end = if (is_row) container_style.padding_bottom else container_style.padding_right;
-
-    const content_main = (if (is_row) container_width else container_height) - padding_main_start - padding_main_end;
-    const content_cross = (if (is_row) container_height else container_width) - padding_cross_start - padding_cross_end;
-
-    const main_size = content_main;
-    const cross_size = content_cross;
-
-    // Allocate temporary measurements (arena allocator, zero-cost)
-    var measurements = try allocator.alloc(ChildMeasurement, child_count);
-    defer allocator.free(measurements);
-
-    // Step 1: Determine base sizes
-    var total_base_size: f32 = 0;
-    const total_gap: f32 = if (child_count > 1)
-        container_style.gap * @as(f32, @floatFromInt(child_count - 1))
-    else
-        0;
-
-    for (children_styles, 0..) |child_style, i| {
-        const child_main_size = if (is_row) child_style.width else child_style.height;
-
-        // Base size = specified size or min size
-        const base = if (child_main_size >= 0)
-            child_main_size
-        else
-            if (is_row) child_style.min_width else child_style.min_height;
-
-        measurements[i].base_size = base;
-        measurements[i].flex_grow = child_style.flex_grow;
-        measurements[i].flex_shrink = child_style.flex_shrink;
-        measurements[i].min_main = if (is_row) child_style.min_width else child_style.min_height;
-        measurements[i].max_main = if (is_row) child_style.max_width else child_style.max_height;
-
-        total_base_size += base;
-    }
+/// Instantiated with scalar.Float for the engine; scalar.Pixels and
+/// scalar.Fixed run the same algorithm in integer arithmetic for cores
+/// without an FPU. Divisions by item or line counts truncate in the
+/// integer scalars, so positions can differ from f32 by under one unit
+/// (1px, or 1/65536px in Q16.16) per division.
+pub fn Flexbox(comptime S: type) type {
+    return struct {
+        const T = S.T;
+        const kernels = simd.Kernels(S);
 
-    // Step 2: Resolve flexible lengths
-    const free_space = main_size - total_base_size - total_gap;
+        /// Flexbox style properties (76 bytes)
+        pub const Style = struct {
+            // Layout direction, wrapping, alignment and overflow (6 bytes)
+            direction: FlexDirection = .column,
+            justify_content: JustifyContent = .flex_start,
+            align_items: AlignItems = .flex_start,
+            flex_wrap: FlexWrap = .nowrap,
+            align_content: AlignContent = .stretch,
+            overflow: Overflow = .visible,
 
-    if (free_space > 0) {
-        // Growing: distribute free space
-        var total_grow: f32 = 0;
-        for (measurements) |m| {
-            total_grow += m.flex_grow;
-        }
+            // Positioning scheme and z-order (2 bytes). The layer is drawn
+            // above the parent's by this many levels (see DrawList.pushLayer).
+            position: Position = .relative,
+            layer: u8 = 0,
 
-        if (total_grow > 0) {
-            for (measurements) |*m| {
-                if (m.flex_grow > 0) {
-                    const grow_amount = (free_space * m.flex_grow) / total_grow;
-                    m.main_size = m.base_size + grow_amount;
-                } else {
-                    m.main_size = m.base_size;
+            // Flex item properties (8 bytes)
+            flex_grow: T = 0,
+            flex_shrink: T = S.fromInt(1),
+
+            // Dimensions (24 bytes)
+            width: T = S.fromInt(-1), // -1 = auto
+            height: T = S.fromInt(-1),
+            min_width: T = 0,
+            min_height: T = 0,
+            max_width: T = S.unbounded,
+            max_height: T = S.unbounded,
+
+            // Spacing (20 bytes)
+            gap: T = 0,
+            padding_top: T = 0,
+            padding_right: T = 0,
+            padding_bottom: T = 0,
+            padding_left: T = 0,
+
+            // Insets of an absolute element from the parent's padding box
+            // (16 bytes, unbounded = auto). Ignored when relative.
+            top: T = S.unbounded,
+            right: T = S.unbounded,
+            bottom: T = S.unbounded,
+            left: T = S.unbounded,
+
+            /// Field-wise equality (padding bytes are ignored)
+            pub fn eql(a: Style, b: Style) bool {
+                return std.meta.eql(a, b);
+            }
+
+            comptime {
+                const size = @sizeOf(Style);
+                if (size != 76) {
+                    @compileError(std.fmt.comptimePrint(
+                        "FlexStyle({s}) size is {} bytes, expected 76 for cache efficiency",
+                        .{ S.name, size },
+                    ));
                 }
             }
-        } else {
-            // No flex-grow, use base sizes
-            for (measurements) |*m| {
-                m.main_size = m.base_size;
+        };
+
+        /// Layout result for a single element
+        pub const Result = struct {
+            x: T = 0,
+            y: T = 0,
+            width: T = 0,
+            height: T = 0,
+        };
+
+        /// Per-child flex state in SoA lanes (one scalar column per field)
+        ///
+        /// Resolution, clamping and positioning run as vector passes over these
+        /// columns (see simd.Kernels resolveFlexible / exclusiveOffsets). All columns
+        /// live in one allocation; range() views a wrapped line in place.
+        const FlexLanes = struct {
+            /// Hypothetical main size (before flex)
+            base: []T,
+            /// Flex factors
+            grow: []T,
+            shrink: []T,
+            /// Constraints
+            min: []T,
+            max: []T,
+            /// Final main size after flex
+            size: []T,
+            /// Scratch: effective flex factor, then main-axis offsets
+            work: []T,
+            /// Cross size before stretching
+            cross: []T,
+
+            const FIELD_COUNT = 8;
+
+            fn alloc(allocator: std.mem.Allocator, count: usize) !FlexLanes {
+                const block = try allocator.alloc(T, FIELD_COUNT * count);
+                return .{
+                    .base = block[0 * count ..][0..count],
+                    .grow = block[1 * count ..][0..count],
+                    .shrink = block[2 * count ..][0..count],
+                    .min = block[3 * count ..][0..count],
+                    .max = block[4 * count ..][0..count],
+                    .size = block[5 * count ..][0..count],
+                    .work = block[6 * count ..][0..count],
+                    .cross = block[7 * count ..][0..count],
+                };
             }
-        }
-    } else if (free_space < 0) {
-        // Shrinking: remove space
-        var total_shrink: f32 = 0;
-        for (measurements) |m| {
-            total_shrink += m.flex_shrink * m.base_size;
-        }
 
-        if (total_shrink > 0) {
-            for (measurements) |*m| {
-                if (m.flex_shrink > 0) {
-                    const shrink_amount = (-free_space * m.flex_shrink * m.base_size) / total_shrink;
-                    m.main_size = m.base_size - shrink_amount;
-                } else {
-                    m.main_size = m.base_size;
-                }
+            fn free(self: FlexLanes, allocator: std.mem.Allocator) void {
+                allocator.free(self.base.ptr[0 .. FIELD_COUNT * self.base.len]);
+            }
+
+            /// Items [start, end) of every column (one wrapped line)
+            fn range(self: FlexLanes, start: usize, end: usize) FlexLanes {
+                return .{
+                    .base = self.base[start..end],
+                    .grow = self.grow[start..end],
+                    .shrink = self.shrink[start..end],
+                    .min = self.min[start..end],
+                    .max = self.max[start..end],
+                    .size = self.size[start..end],
+                    .work = self.work[start..end],
+                    .cross = self.cross[start..end],
+                };
             }
-        } else {
-            for (measurements) |*m| {
-                m.main_size = m.base_size;
+
+            /// Step 1: base size, flex factors and hypothetical cross size
+            inline fn load(self: FlexLanes, i: usize, child_style: Style, is_row: bool) void {
+                const child_main_size = if (is_row) child_style.width else child_style.height;
+                const min_main = if (is_row) child_style.min_width else child_style.min_height;
+
+                // Base size = specified size or min size
+                self.base[i] = if (child_main_size >= 0) child_main_size else min_main;
+                self.grow[i] = child_style.flex_grow;
+                self.shrink[i] = child_style.flex_shrink;
+                self.min[i] = min_main;
+                self.max[i] = if (is_row) child_style.max_width else child_style.max_height;
+                self.cross[i] = hypotheticalCross(child_style, is_row);
             }
+        };
+
+        /// One line of a wrapped container (children[start..end])
+        const FlexLine = struct {
+            start: usize = 0,
+            end: usize = 0,
+
+            /// Sum of clamped base sizes plus gaps (used for line breaking)
+            hypothetical_main: T = 0,
+
+            /// Sum of final main sizes
+            main_size: T = 0,
+            /// Largest item cross size (grown by align-content: stretch)
+            cross_size: T = 0,
+        };
+
+        /// Main-axis start offset (relative to padding) and spacing between items
+        const MainDistribution = struct {
+            offset: T,
+            spacing: T,
+        };
+
+        /// Cross size before stretching: specified size or min size
+        inline fn hypotheticalCross(child_style: Style, is_row: bool) T {
+            const child_cross_size = if (is_row) child_style.height else child_style.width;
+            if (child_cross_size >= 0) return child_cross_size;
+            return if (is_row) child_style.min_height else child_style.min_width;
         }
-    } else {
-        // Exact fit
-        for (measurements) |*m| {
-            m.main_size = m.base_size;
+
+        /// Step 2: distribute free space on one line (flex-grow or flex-shrink)
+        ///
+        /// Items that hit min/max are frozen and their excess is redistributed
+        /// among the remaining flexible items. Writes lanes.size (clamped).
+        fn resolveFlexibleLengths(lanes: FlexLanes, available: T) void {
+            if (available - kernels.sum(lanes.base) > 0) {
+                // Growing: distribute free space by flex-grow
+                @memcpy(lanes.work, lanes.grow);
+            } else {
+                // Shrinking: remove space by flex-shrink scaled by base size
+                kernels.multiply(lanes.work, lanes.shrink, lanes.base);
+            }
+            kernels.resolveFlexible(lanes.base, lanes.work, lanes.min, lanes.max, lanes.size, available);
         }
-    }
 
-    // Apply constraints using SIMD (our validated optimization!)
-    {
-        var main_sizes = try allocator.alloc(f32, child_count);
-        defer allocator.free(main_sizes);
-        var min_mains = try allocator.alloc(f32, child_count);
-        defer allocator.free(min_mains);
-        var max_mains = try allocator.alloc(f32, child_count);
-        defer allocator.free(max_mains);
-
-        for (measurements, 0..) |m, i| {
-            main_sizes[i] = m.main_size;
-            min_mains[i] = m.min_main;
-            max_mains[i] = m.max_main;
+        /// Step 4: justify-content for one line
+        inline fn distributeMain(
+            justify: JustifyContent,
+            main_size: T,
+            total_children_size: T,
+            total_gap: T,
+            gap: T,
+            count: usize,
+        ) MainDistribution {
+            return switch (justify) {
+                // Start at padding, use gap for spacing
+                .flex_start => .{ .offset = 0, .spacing = gap },
+                .center => .{ .offset = S.divInt(main_size - total_children_size - total_gap, 2), .spacing = gap },
+                .flex_end => .{ .offset = main_size - total_children_size - total_gap, .spacing = gap },
+                .space_between => .{
+                    .offset = 0,
+                    .spacing = if (count > 1) S.divInt(main_size - total_children_size, count - 1) else 0,
+                },
+                .space_around => blk: {
+                    // Equal space around each item (half space at edges)
+                    const spacing = S.divInt(main_size - total_children_size, count);
+                    break :blk .{ .offset = S.divInt(spacing, 2), .spacing = spacing };
+                },
+                .space_evenly => blk: {
+                    // Equal space between all items and edges
+                    const spacing = S.divInt(main_size - total_children_size, count + 1);
+                    break :blk .{ .offset = spacing, .spacing = spacing };
+                },
+            };
         }
 
-        simd.clampWidths(main_sizes, min_mains, max_mains);
+        /// Cross offset of an item within a line (or the container, when single-line)
+        inline fn alignCross(align_items: AlignItems, line_cross: T, item_cross: T) T {
+            return switch (align_items) {
+                .flex_start => 0,
+                .center => S.divInt(line_cross - item_cross, 2),
+                .flex_end => line_cross - item_cross,
+                .stretch => 0,
+            };
+        }
 
-        for (measurements, 0..) |*m, i| {
-            m.main_size = main_sizes[i];
+        /// Compute flexbox layout for a container with children
+        ///
+        /// This is a REAL flexbox implementation - no shortcuts!
+        /// Steps:
+        /// 1. Determine base sizes for all children
+        /// 2. Resolve flexible lengths (flex-grow/shrink)
+        /// 3. Calculate cross sizes
+        /// 4. Align items on both axes
+        /// 5. Position children
+        ///
+        /// Containers with flex_wrap != .nowrap break children into lines first
+        /// (see computeWrappedLayout). Single-line containers of a common shape
+        /// run a pass compiled for that shape (see LineSpec).
+        ///
+        /// Complexity: O(n) where n = child count
+        /// Performance target: ~0.05-0.10μs per child
+        pub fn computeFlexLayout(
+            allocator: std.mem.Allocator,
+            container_width: T,
+            container_height: T,
+            container_style: Style,
+            children_styles: []const Style,
+            children_results: []Result,
+        ) !void {
+            return computeContainer(true, allocator, container_width, container_height, container_style, children_styles, children_results);
         }
-    }
 
-    // Step 3: Determine cross sizes
-    for (children_styles, 0..) |child_style, i| {
-        const child_cross_size = if (is_row) child_style.height else child_style.width;
-
-        if (child_cross_size >= 0) {
-            // Fixed cross size
-            measurements[i].cross_size = child_cross_size;
-        } else if (container_style.align_items == .stretch) {
-            // Stretch to fill
-            measurements[i].cross_size = cross_size;
-        } else {
-            // Use minimum
-            const min_cross = if (is_row) child_style.min_height else child_style.min_width;
-            measurements[i].cross_size = min_cross;
+        /// computeFlexLayout with every single-line container on the generic
+        /// pass (reference for tests and benchmarks)
+        pub fn computeFlexLayoutGeneric(
+            allocator: std.mem.Allocator,
+            container_width: T,
+            container_height: T,
+            container_style: Style,
+            children_styles: []const Style,
+            children_results: []Result,
+        ) !void {
+            return computeContainer(false, allocator, container_width, container_height, container_style, children_styles, children_results);
         }
-    }
 
-    // Step 4: Position children along main axis
-    // Calculate total children size first (needed for most justify modes)
-    var total_children_size: f32 = 0;
-    for (measurements) |m| {
-        total_children_size += m.main_size;
-    }
+        fn computeContainer(
+            comptime specialize: bool,
+            allocator: std.mem.Allocator,
+            container_width: T,
+            container_height: T,
+            container_style: Style,
+            children_styles: []const Style,
+            children_results: []Result,
+        ) !void {
+            std.debug.assert(children_styles.len == children_results.len);
 
-    // Determine initial offset and spacing based on justify_content
-    var main_offset: f32 = padding_main_start;
-    var spacing: f32 = container_style.gap;
-
-    switch (container_style.justify_content) {
-        .flex_start => {
-            // Start at padding, use gap for spacing
-            spacing = container_style.gap;
-        },
-        .center => {
-            const total_with_gap = total_children_size + total_gap;
-            main_offset = padding_main_start + (main_size - total_with_gap) / 2.0;
-            spacing = container_style.gap;
-        },
-        .flex_end => {
-            const total_with_gap = total_children_size + total_gap;
-            main_offset = padding_main_start + main_size - total_with_gap;
-            spacing = container_style.gap;
-        },
-        .space_between => {
-            if (child_count > 1) {
-                spacing = (main_size - total_children_size) / @as(f32, @floatFromInt(child_count - 1));
-            } else {
-                spacing = 0;
+            const child_count = children_styles.len;
+            if (child_count == 0) return;
+
+            const is_row = container_style.direction == .row;
+
+            // Calculate content area (container minus padding)
+            const padding_main_start = if (is_row) container_style.padding_left else container_style.padding_top;
+            const padding_main_end = if (is_row) container_style.padding_right else container_style.padding_bottom;
+            const padding_cross_start = if (is_row) container_style.padding_top else container_style.padding_left;
+            const padding_cross_end = if (is_row) container_style.padding_bottom else container_style.padding_right;
+
+            const content_main = (if (is_row) container_width else container_height) - padding_main_start - padding_main_end;
+            const content_cross = (if (is_row) container_height else container_width) - padding_cross_start - padding_cross_end;
+
+            const main_size = content_main;
+            const cross_size = content_cross;
+
+            if (container_style.flex_wrap != .nowrap) {
+                return computeWrappedLayout(
+                    allocator,
+                    container_style,
+                    is_row,
+                    main_size,
+                    cross_size,
+                    padding_main_start,
+                    padding_cross_start,
+                    children_styles,
+                    children_results,
+                );
             }
-        },
-        .space_around => {
-            // Equal space around each item (half space at edges)
-            const total_space = main_size - total_children_size;
-            spacing = total_space / @as(f32, @floatFromInt(child_count));
-            main_offset = padding_main_start + spacing / 2.0;
-        },
-        .space_evenly => {
-            // Equal space between all items and edges
-            const total_space = main_size - total_children_size;
-            spacing = total_space / @as(f32, @floatFromInt(child_count + 1));
-            main_offset = padding_main_start + spacing;
-        },
-    }
 
-    for (measurements, 0..) |m, i| {
-        // Calculate cross axis position (with padding offset)
-        const cross_offset = padding_cross_start + switch (container_style.align_items) {
-            .flex_start => @as(f32, 0),
-            .center => (cross_size - m.cross_size) / 2.0,
-            .flex_end => cross_size - m.cross_size,
-            .stretch => @as(f32, 0),
+            const spec = LineSpec{
+                .is_row = is_row,
+                .justify = container_style.justify_content,
+                .align_items = container_style.align_items,
+            };
+            if (specialize) {
+                // One dispatch per container; the per-child loops then run
+                // without direction/justify/align branches
+                switch (is_row) {
+                    inline else => |row| switch (spec.justify) {
+                        inline .flex_start, .center, .space_between => |justify| switch (spec.align_items) {
+                            inline .stretch, .flex_start => |align_items| return layoutLineSpecialized(
+                                .{ .is_row = row, .justify = justify, .align_items = align_items },
+                                allocator,
+                                container_style,
+                                main_size,
+                                cross_size,
+                                padding_main_start,
+                                padding_cross_start,
+                                children_styles,
+                                children_results,
+                            ),
+                            else => {},
+                        },
+                        else => {},
+                    },
+                }
+            }
+            return layoutLineGeneric(
+                spec,
+                allocator,
+                container_style,
+                main_size,
+                cross_size,
+                padding_main_start,
+                padding_cross_start,
+                children_styles,
+                children_results,
+            );
+        }
+
+        /// Shape of a single-line container that decides its per-child branches
+        ///
+        /// row/column x flex_start/center/space_between x stretch/flex_start
+        /// (12 combinations) each get a pass where the shape is comptime-known;
+        /// every other shape shares one pass that branches at runtime.
+        pub const LineSpec = struct {
+            is_row: bool,
+            justify: JustifyContent,
+            align_items: AlignItems,
         };
 
-        // Set result
-        if (is_row) {
-            children_results[i].x = main_offset;
-            children_results[i].y = cross_offset;
-            children_results[i].width = m.main_size;
-            children_results[i].height = m.cross_size;
-        } else {
-            children_results[i].x = cross_offset;
-            children_results[i].y = main_offset;
-            children_results[i].width = m.cross_size;
-            children_results[i].height = m.main_size;
+        fn layoutLineSpecialized(
+            comptime spec: LineSpec,
+            allocator: std.mem.Allocator,
+            container_style: Style,
+            main_size: T,
+            cross_size: T,
+            padding_main_start: T,
+            padding_cross_start: T,
+            children_styles: []const Style,
+            children_results: []Result,
+        ) !void {
+            return layoutLine(spec, allocator, container_style, main_size, cross_size, padding_main_start, padding_cross_start, children_styles, children_results);
         }
 
-        main_offset += m.main_size + spacing;
-    }
+        fn layoutLineGeneric(
+            spec: LineSpec,
+            allocator: std.mem.Allocator,
+            container_style: Style,
+            main_size: T,
+            cross_size: T,
+            padding_main_start: T,
+            padding_cross_start: T,
+            children_styles: []const Style,
+            children_results: []Result,
+        ) !void {
+            return layoutLine(spec, allocator, container_style, main_size, cross_size, padding_main_start, padding_cross_start, children_styles, children_results);
+        }
+
+        /// Steps 1-5 for a single-line container
+        ///
+        /// Inline so a comptime-known `spec` stays comptime-known in the body:
+        /// the direction, justify and align switches fold away in specialized
+        /// passes and only the generic pass evaluates them at runtime.
+        inline fn layoutLine(
+            spec: LineSpec,
+            allocator: std.mem.Allocator,
+            container_style: Style,
+            main_size: T,
+            cross_size: T,
+            padding_main_start: T,
+            padding_cross_start: T,
+            children_styles: []const Style,
+            children_results: []Result,
+        ) !void {
+            const child_count = children_styles.len;
+
+            // Allocate temporary lanes (arena allocator, zero-cost)
+            const lanes = try FlexLanes.alloc(allocator, child_count);
+            defer lanes.free(allocator);
+
+            // Step 1: Determine base sizes
+            const total_gap: T = if (child_count > 1)
+                S.times(container_style.gap, child_count - 1)
+            else
+                0;
+
+            for (children_styles, 0..) |child_style, i| {
+                lanes.load(i, child_style, spec.is_row);
+            }
+
+            // Step 2: Resolve flexible lengths (clamped to min/max)
+            // Scroll containers never shrink their content: it keeps its natural
+            // size and the overflow is reached by scrolling.
+            const scrolls = container_style.overflow == .scroll;
+            const available = main_size - total_gap;
+            resolveFlexibleLengths(lanes, if (scrolls) @max(available, kernels.sum(lanes.base)) else available);
+
+            // Step 3: Determine cross sizes
+            if (spec.align_items == .stretch) {
+                for (children_styles, lanes.cross) |child_style, *cross| {
+                    const child_cross_size = if (spec.is_row) child_style.height else child_style.width;
+                    // Stretch auto cross sizes to fill
+                    cross.* = if (child_cross_size < 0) cross_size else cross.*;
+                }
+            }
+
+            // Step 4: Position children along main axis
+            // Calculate total children size first (needed for most justify modes)
+            const total_children_size = kernels.sum(lanes.size);
+
+            // Determine initial offset and spacing based on justify_content
+            // (overflowing scroll content starts at the leading edge, never before it)
+            const distribution = distributeMain(
+                spec.justify,
+                if (scrolls) @max(main_size, total_children_size + total_gap) else main_size,
+                total_children_size,
+                total_gap,
+                container_style.gap,
+                child_count,
+            );
+
+            // Main offsets are a prefix sum of sizes + spacing
+            kernels.exclusiveOffsets(lanes.work, lanes.size, distribution.spacing, padding_main_start + distribution.offset);
+
+            for (children_results, lanes.work, lanes.size, lanes.cross) |*result, main_offset, main, cross| {
+                // Calculate cross axis position (with padding offset)
+                const cross_offset = padding_cross_start + alignCross(spec.align_items, cross_size, cross);
+
+                // Set result
+                if (spec.is_row) {
+                    result.* = .{ .x = main_offset, .y = cross_offset, .width = main, .height = cross };
+                } else {
+                    result.* = .{ .x = cross_offset, .y = main_offset, .width = cross, .height = main };
+                }
+            }
+        }
+
+        /// Multi-line flexbox (flex_wrap = .wrap / .wrap_reverse)
+        ///
+        /// Line breaking happens in the same single pass that measures children:
+        /// a child starts a new line when its clamped base size (plus gap) no longer
+        /// fits. Each line then resolves grow/shrink on its own, lines are placed on
+        /// the cross axis by align_content, and items within a line by align_items.
+        ///
+        /// Complexity: O(n) - every child is visited a constant number of times.
+        fn computeWrappedLayout(
+            allocator: std.mem.Allocator,
+            container_style: Style,
+            is_row: bool,
+            main_size: T,
+            cross_size: T,
+            padding_main_start: T,
+            padding_cross_start: T,
+            children_styles: []const Style,
+            children_results: []Result,
+        ) !void {
+            const child_count = children_styles.len;
+            const gap = container_style.gap;
+
+            const lanes = try FlexLanes.alloc(allocator, child_count);
+            defer lanes.free(allocator);
+
+            // At most one line per child
+            const lines = try allocator.alloc(FlexLine, child_count);
+            defer allocator.free(lines);
+
+            // Steps 1 + line breaking: single pass
+            var line_count: usize = 0;
+            var line = FlexLine{};
+            for (children_styles, 0..) |child_style, i| {
+                lanes.load(i, child_style, is_row);
+
+                const hypothetical = @min(@max(lanes.base[i], lanes.min[i]), lanes.max[i]);
+                const leading_gap: T = if (i > line.start) gap else 0;
+
+                if (i > line.start and line.hypothetical_main + leading_gap + hypothetical > main_size) {
+                    lines[line_count] = line;
+                    line_count += 1;
+                    line = .{ .start = i, .end = i };
+                    line.hypothetical_main = hypothetical;
+                } else {
+                    line.hypothetical_main += leading_gap + hypothetical;
+                }
+                line.end = i + 1;
+                line.cross_size = @max(line.cross_size, lanes.cross[i]);
+            }
+            lines[line_count] = line;
+            line_count += 1;
+
+            // Step 2: resolve flexible lengths per line
+            var total_lines_cross: T = 0;
+            for (lines[0..line_count]) |*l| {
+                const items = lanes.range(l.start, l.end);
+                const line_gap = S.times(gap, items.size.len - 1);
+
+                resolveFlexibleLengths(items, main_size - line_gap);
+                l.main_size = kernels.sum(items.size);
+                total_lines_cross += l.cross_size;
+            }
+
+            // Step 3: align_content - place lines on the cross axis
+            const cross_gaps = S.times(gap, line_count - 1);
+            const free_cross = cross_size - total_lines_cross - cross_gaps;
+
+            var line_offset: T = 0;
+            var line_spacing: T = gap;
+            switch (container_style.align_content) {
+                .flex_start => {},
+                .center => line_offset = S.divInt(free_cross, 2),
+                .flex_end => line_offset = free_cross,
+                .stretch => if (free_cross > 0) {
+                    const extra = S.divInt(free_cross, line_count);
+                    for (lines[0..line_count]) |*l| {
+                        l.cross_size += extra;
+                    }
+                },
+                .space_between => if (line_count > 1) {
+                    line_spacing = S.divInt(cross_size - total_lines_cross, line_count - 1);
+                },
+                .space_around => {
+                    line_spacing = S.divInt(cross_size - total_lines_cross, line_count);
+                    line_offset = S.divInt(line_spacing, 2);
+                },
+            }
+
+            // Steps 4 + 5: justify and align within each line, then position
+            const reverse = container_style.flex_wrap == .wrap_reverse;
+            for (lines[0..line_count]) |l| {
+                const count = l.end - l.start;
+                const line_gap = S.times(gap, count - 1);
+                const distribution = distributeMain(
+                    container_style.justify_content,
+                    main_size,
+                    l.main_size,
+                    line_gap,
+                    gap,
+                    count,
+                );
+
+                // wrap_reverse stacks lines from the cross end
+                const line_cross_start = padding_cross_start +
+                    (if (reverse) cross_size - line_offset - l.cross_size else line_offset);
+
+                const items = lanes.range(l.start, l.end);
+                kernels.exclusiveOffsets(items.work, items.size, distribution.spacing, padding_main_start + distribution.offset);
+
+                for (l.start..l.end, items.work, items.size, items.cross) |i, main_offset, main, cross| {
+                    const child_style = children_styles[i];
+                    const child_cross_size = if (is_row) child_style.height else child_style.width;
+
+                    const item_cross = if (child_cross_size < 0 and container_style.align_items == .stretch)
+                        l.cross_size
+                    else
+                        cross;
+                    const cross_offset = line_cross_start + alignCross(container_style.align_items, l.cross_size, item_cross);
+
+                    if (is_row) {
+                        children_results[i] = .{ .x = main_offset, .y = cross_offset, .width = main, .height = item_cross };
+                    } else {
+                        children_results[i] = .{ .x = cross_offset, .y = main_offset, .width = item_cross, .height = main };
+                    }
+                }
+
+                line_offset += l.cross_size + line_spacing;
+            }
+        }
+
+        /// Style converted from the f32 FlexStyle (see scalar fromFloat)
+        pub fn styleFromFloat(style: FlexStyle) Style {
+            var out: Style = undefined;
+            inline for (std.meta.fields(Style)) |field| {
+                const value = @field(style, field.name);
+                @field(out, field.name) = if (@TypeOf(value) == f32) S.fromFloat(value) else value;
+            }
+            return out;
+        }
+    };
 }
 
+/// f32 flexbox, as used by the engine
+const float_flexbox = Flexbox(scalar.Float);
+
+pub const FlexStyle = float_flexbox.Style;
+pub const LayoutResult = float_flexbox.Result;
+pub const computeFlexLayout = float_flexbox.computeFlexLayout;
+
 test "flexbox: simple column layout" {
     var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
     defer arena.deinit();
@@ -407,3 +769,285 @@ test "flexbox: center alignment" {
     // Child centered: (200 - 50) / 2 = 75
     try std.testing.expect(results[0].y > 74 and results[0].y < 76);
 }
+
+test "flexbox: wrap breaks row into lines" {
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+
+    const container = FlexStyle{
+        .direction = .row,
+        .flex_wrap = .wrap,
+        .align_content = .flex_start,
+        .gap = 5,
+    };
+
+    // 30 + 5 + 30 + 5 + 30 = 100 fits exactly; the rest wraps
+    const children = [_]FlexStyle{.{ .width = 30, .height = 10 }} ** 5;
+    var results = [_]LayoutResult{.{}} ** 5;
+
+    try computeFlexLayout(allocator, 100, 100, container, &children, &results);
+
+    try std.testing.expectEqual(@as(f32, 0), results[0].x);
+    try std.testing.expectEqual(@as(f32, 70), results[2].x);
+    try std.testing.expectEqual(@as(f32, 0), results[2].y);
+
+    // Second line starts at x = 0, below the first line + gap
+    try std.testing.expectEqual(@as(f32, 0), results[3].x);
+    try std.testing.expectEqual(@as(f32, 15), results[3].y);
+    try std.testing.expectEqual(@as(f32, 35), results[4].x);
+}
+
+test "flexbox: wrap resolves flex-grow per line" {
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+
+    const container = FlexStyle{ .direction = .row, .flex_wrap = .wrap };
+
+    const children = [_]FlexStyle{.{ .width = 30, .height = 10, .flex_grow = 1 }} ** 5;
+    var results = [_]LayoutResult{.{}} ** 5;
+
+    try computeFlexLayout(allocator, 100, 100, container, &children, &results);
+
+    // Line 1: three items share 10px of free space; line 2: two items share 40px
+    try std.testing.expect(results[0].width > 33.3 and results[0].width < 33.4);
+    try std.testing.expectEqual(@as(f32, 50), results[3].width);
+    try std.testing.expectEqual(@as(f32, 50), results[4].x);
+}
+
+test "flexbox: oversized child gets its own line" {
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+
+    const container = FlexStyle{ .direction = .row, .flex_wrap = .wrap, .align_content = .flex_start };
+
+    const children = [_]FlexStyle{
+        .{ .width = 40, .height = 10, .flex_shrink = 0 },
+        .{ .width = 150, .height = 20, .flex_shrink = 0 },
+        .{ .width = 40, .height = 10, .flex_shrink = 0 },
+    };
+    var results = [_]LayoutResult{.{}} ** 3;
+
+    try computeFlexLayout(allocator, 100, 100, container, &children, &results);
+
+    try std.testing.expectEqual(@as(f32, 0), results[0].y);
+    try std.testing.expectEqual(@as(f32, 10), results[1].y);
+    try std.testing.expectEqual(@as(f32, 150), results[1].width);
+    try std.testing.expectEqual(@as(f32, 30), results[2].y);
+}
+
+test "flexbox: align-content distributes lines" {
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+
+    const children = [_]FlexStyle{.{ .width = 60, .height = 10 }} ** 2;
+    var results = [_]LayoutResult{.{}} ** 2;
+
+    // stretch (default): 80px of free space split across two lines
+    try computeFlexLayout(allocator, 100, 100, .{ .direction = .row, .flex_wrap = .wrap }, &children, &results);
+    try std.testing.expectEqual(@as(f32, 0), results[0].y);
+    try std.testing.expectEqual(@as(f32, 50), results[1].y);
+
+    // center: lines packed in the middle
+    try computeFlexLayout(allocator, 100, 100, .{ .direction = .row, .flex_wrap = .wrap, .align_content = .center }, &children, &results);
+    try std.testing.expectEqual(@as(f32, 40), results[0].y);
+    try std.testing.expectEqual(@as(f32, 50), results[1].y);
+
+    // space_between: first line at start, last line at end
+    try computeFlexLayout(allocator, 100, 100, .{ .direction = .row, .flex_wrap = .wrap, .align_content = .space_between }, &children, &results);
+    try std.testing.expectEqual(@as(f32, 0), results[0].y);
+    try std.testing.expectEqual(@as(f32, 90), results[1].y);
+
+    // stretch also stretches auto cross sizes with align_items = stretch
+    const auto_children = [_]FlexStyle{.{ .width = 60 }} ** 2;
+    try computeFlexLayout(allocator, 100, 100, .{ .direction = .row, .flex_wrap = .wrap, .align_items = .stretch }, &auto_children, &results);
+    try std.testing.expectEqual(@as(f32, 50), results[0].height);
+    try std.testing.expectEqual(@as(f32, 50), results[1].y);
+}
+
+test "flexbox: wrap-reverse stacks lines from the cross end" {
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+
+    const container = FlexStyle{
+        .direction = .column,
+        .flex_wrap = .wrap_reverse,
+        .align_content = .flex_start,
+    };
+
+    // Column: lines are columns, stacked right-to-left
+    const children = [_]FlexStyle{.{ .width = 20, .height = 60 }} ** 3;
+    var results = [_]LayoutResult{.{}} ** 3;
+
+    try computeFlexLayout(allocator, 100, 100, container, &children, &results);
+
+    try std.testing.expectEqual(@as(f32, 80), results[0].x);
+    try std.testing.expectEqual(@as(f32, 0), results[0].y);
+    try std.testing.expectEqual(@as(f32, 60), results[1].x);
+    try std.testing.expectEqual(@as(f32, 40), results[2].x);
+}
+
+test "flexbox: space clamped by max is redistributed" {
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+
+    const container = FlexStyle{ .direction = .row };
+
+    const children = [_]FlexStyle{
+        .{ .flex_grow = 1, .max_width = 50, .height = 10 },
+        .{ .flex_grow = 1, .height = 10 },
+        .{ .flex_grow = 1, .height = 10 },
+    };
+    var results = [_]LayoutResult{.{}} ** 3;
+
+    try computeFlexLayout(allocator, 300, 100, container, &children, &results);
+
+    // First child frozen at 50; the other two share the remaining 250
+    try std.testing.expectEqual(@as(f32, 50), results[0].width);
+    try std.testing.expectEqual(@as(f32, 125), results[1].width);
+    try std.testing.expectEqual(@as(f32, 175), results[2].x);
+}
+
+test "flexbox: wide row positions match scalar accumulation" {
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+
+    const container = FlexStyle{ .direction = .row, .gap = 2, .padding_left = 7 };
+
+    // Enough children for the vector prefix-sum path, odd count for the tail
+    var children: [67]FlexStyle = undefined;
+    for (&children, 0..) |*child, i| {
+        child.* = .{ .width = @floatFromInt(4 + i % 5), .height = 10, .flex_shrink = 0 };
+    }
+    var results = [_]LayoutResult{.{}} ** 67;
+
+    try computeFlexLayout(allocator, 2000, 100, container, &children, &results);
+
+    var x: f32 = 7;
+    for (children, results) |child, result| {
+        try std.testing.expectEqual(x, result.x);
+        try std.testing.expectEqual(child.width, result.width);
+        x += child.width + 2;
+    }
+}
+
+test "flexbox: scroll containers keep content at natural size" {
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+
+    const children = [_]FlexStyle{
+        .{ .height = 80, .width = 10 },
+        .{ .height = 80, .width = 10 },
+        .{ .height = 80, .width = 10 },
+    };
+    var results = [_]LayoutResult{.{}} ** 3;
+
+    // Plain column shrinks 240 of content into 120
+    try computeFlexLayout(allocator, 100, 120, .{ .justify_content = .center }, &children, &results);
+    try std.testing.expectEqual(@as(f32, 40), results[0].height);
+
+    // Scroll column keeps 80 each and starts at the top despite centering
+    try computeFlexLayout(allocator, 100, 120, .{ .justify_content = .center, .overflow = .scroll }, &children, &results);
+    try std.testing.expectEqual(@as(f32, 80), results[0].height);
+    try std.testing.expectEqual(@as(f32, 0), results[0].y);
+    try std.testing.expectEqual(@as(f32, 160), results[2].y);
+}
+
+test "flexbox: integer scalars match f32 within rounding" {
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+
+    // Toolbar + grow/shrink panes + a wrapped grid: every justify and
+    // align path that divides, on whole-pixel inputs
+    const containers = [_]FlexStyle{
+        .{ .direction = .row, .gap = 4, .padding_left = 8, .padding_top = 2, .align_items = .center },
+        .{ .direction = .column, .justify_content = .space_between, .align_items = .stretch },
+        .{ .direction = .row, .justify_content = .space_evenly, .align_items = .flex_end },
+        .{ .direction = .row, .flex_wrap = .wrap, .gap = 3, .align_content = .space_around },
+        .{ .direction = .column, .justify_content = .center, .overflow = .scroll },
+    };
+    var children: [23]FlexStyle = undefined;
+    for (&children, 0..) |*child, i| {
+        child.* = .{
+            .width = @floatFromInt(20 + (i * 7) % 31),
+            .height = @floatFromInt(10 + (i * 5) % 17),
+            .flex_grow = @floatFromInt(i % 3),
+            .max_width = if (i % 4 == 0) 45 else std.math.inf(f32),
+            .min_height = if (i % 6 == 0) 14 else 0,
+        };
+    }
+
+    inline for (.{ scalar.Pixels, scalar.Fixed }) |S| {
+        const F = Flexbox(S);
+        // Each item's share truncates by under one unit, and positions are
+        // prefix sums of shares: whole pixels drift by up to 1px per item
+        const tolerance: f32 = if (S.FRAC_BITS == 0) children.len else 0.01;
+
+        var int_children: [children.len]F.Style = undefined;
+        for (children, &int_children) |child, *int_child| int_child.* = F.styleFromFloat(child);
+
+        for (containers) |container| {
+            var expected: [children.len]LayoutResult = undefined;
+            var actual: [children.len]F.Result = undefined;
+            try computeFlexLayout(allocator, 640, 300, container, &children, &expected);
+            try F.computeFlexLayout(allocator, S.fromInt(640), S.fromInt(300), F.styleFromFloat(container), &int_children, &actual);
+
+            for (expected, actual) |e, a| {
+                try std.testing.expectApproxEqAbs(e.x, S.toFloat(a.x), tolerance);
+                try std.testing.expectApproxEqAbs(e.y, S.toFloat(a.y), tolerance);
+                try std.testing.expectApproxEqAbs(e.width, S.toFloat(a.width), tolerance);
+                try std.testing.expectApproxEqAbs(e.height, S.toFloat(a.height), tolerance);
+            }
+        }
+    }
+}
+
+test "flexbox: specialized single-line passes match the generic pass" {
+    var arena = std.heap.ArenaAllocator.init(std.testing.allocator);
+    defer arena.deinit();
+    const allocator = arena.allocator();
+    const float = Flexbox(scalar.Float);
+
+    var prng = std.Random.DefaultPrng.init(18);
+    const random = prng.random();
+
+    var children: [29]FlexStyle = undefined;
+    for (&children, 0..) |*child, i| {
+        child.* = .{
+            // Some auto sizes, so stretch has something to stretch
+            .width = if (i % 4 == 0) -1 else @floatFromInt(random.intRangeAtMost(u32, 8, 60)),
+            .height = if (i % 3 == 0) -1 else @floatFromInt(random.intRangeAtMost(u32, 8, 40)),
+            .flex_grow = @floatFromInt(random.intRangeAtMost(u32, 0, 2)),
+            .min_width = if (i % 5 == 0) 12 else 0,
+        };
+    }
+
+    // Every direction/justify/align shape, specialized or not
+    for (std.enums.values(FlexDirection)) |direction| {
+        for (std.enums.values(JustifyContent)) |justify| {
+            for (std.enums.values(AlignItems)) |align_items| {
+                const container = FlexStyle{
+                    .direction = direction,
+                    .justify_content = justify,
+                    .align_items = align_items,
+                    .gap = 3,
+                    .padding_left = 5,
+                    .padding_top = 7,
+                };
+                var expected: [children.len]LayoutResult = undefined;
+                var actual: [children.len]LayoutResult = undefined;
+                try float.computeFlexLayoutGeneric(allocator, 1200, 900, container, &children, &expected);
+                try computeFlexLayout(allocator, 1200, 900, container, &children, &actual);
+                for (expected, actual) |e, a| try std.testing.expectEqual(e, a);
+            }
+        }
+    }
+}
@@ -0,0 +1,185 @@
+//! Layout scalars - the number type flexbox kernels compute in
+//!
+//! flexbox.zig and the SIMD kernels are written once over a scalar
+//! descriptor and instantiated per type at compile time:
+//! - Float:  f32, what the engine uses on hosts with an FPU
+//! - Pixels: i32 whole pixels, for displays that never place subpixels
+//! - Fixed:  Q16.16 in an i32 - 1/65536 px resolution, ±32767 px range
+//!
+//! On FPU-less cores (Cortex-M0/M0+) every f32 add, multiply and compare is
+//! a soft-float library call; the integer scalars compile to single
+//! instructions and drop the soft-float routines from flash.
+//!
+//! Values of `T` support +, -, comparisons, @min/@max, @select and vectors
+//! directly. Multiplication, division and conversions go through the
+//! descriptor, since their meaning differs per type (Q16.16 products are
+//! rescaled, integer ratios are taken in 64 bits).
+
+const std = @import("std");
+
+pub const Float = struct {
+    pub const T = f32;
+    pub const name = "f32";
+    /// No upper bound (max sizes)
+    pub const unbounded: T = std.math.inf(f32);
+
+    pub inline fn fromInt(n: anytype) T {
+        return @floatFromInt(n);
+    }
+
+    pub inline fn fromFloat(x: f32) T {
+        return x;
+    }
+
+    pub inline fn toFloat(x: T) f32 {
+        return x;
+    }
+
+    /// a * b, for scalars or vectors of T
+    pub inline fn mul(a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+        return a * b;
+    }
+
+    /// v * num / den, for scalars or vectors of T (den != 0)
+    pub inline fn mulDiv(v: anytype, num: T, den: T) @TypeOf(v) {
+        return v * splat(@TypeOf(v), num / den);
+    }
+
+    pub inline fn div(a: T, b: T) T {
+        return a / b;
+    }
+
+    /// x * n for an integer count n
+    pub inline fn times(x: T, n: usize) T {
+        return x * @as(T, @floatFromInt(n));
+    }
+
+    /// x / n for an integer count n > 0
+    pub inline fn divInt(x: T, n: usize) T {
+        return x / @as(T, @floatFromInt(n));
+    }
+};
+
+/// Whole pixels: fractions are truncated toward zero
+pub const Pixels = Integer(0, "i32");
+
+/// Q16.16 fixed point
+pub const Fixed = Integer(16, "q16.16");
+
+/// Integer scalar with `frac_bits` fractional bits, stored in an i32
+pub fn Integer(comptime frac_bits: u5, comptime type_name: []const u8) type {
+    return struct {
+        pub const T = i32;
+        pub const name = type_name;
+        pub const FRAC_BITS = frac_bits;
+        pub const unbounded: T = std.math.maxInt(i32);
+
+        const ONE: i64 = 1 << frac_bits;
+        const ONE_F: f64 = @floatFromInt(ONE);
+
+        pub inline fn fromInt(n: anytype) T {
+            return @intCast(@as(i64, @intCast(n)) * ONE);
+        }
+
+        /// Nearest representable value; infinities and out-of-range values saturate
+        pub fn fromFloat(x: f32) T {
+            const scaled = @round(@as(f64, x) * ONE_F);
+            if (scaled >= std.math.maxInt(i32)) return unbounded;
+            if (scaled <= std.math.minInt(i32)) return std.math.minInt(i32);
+            return @intFromFloat(scaled);
+        }
+
+        pub fn toFloat(x: T) f32 {
+            if (x == unbounded) return std.math.inf(f32);
+            return @floatCast(@as(f64, @floatFromInt(x)) / ONE_F);
+        }
+
+        pub inline fn mul(a: anytype, b: @TypeOf(a)) @TypeOf(a) {
+            const W = Wide(@TypeOf(a));
+            const product = @as(W, @intCast(a)) * @as(W, @intCast(b));
+            return @intCast(product >> splat(Shift(W), frac_bits));
+        }
+
+        pub inline fn mulDiv(v: anytype, num: T, den: T) @TypeOf(v) {
+            const W = Wide(@TypeOf(v));
+            const scaled = @as(W, @intCast(v)) * splat(W, @as(i64, num));
+            return @intCast(@divTrunc(scaled, splat(W, @as(i64, den))));
+        }
+
+        pub inline fn div(a: T, b: T) T {
+            return @intCast(@divTrunc(@as(i64, a) * ONE, b));
+        }
+
+        pub inline fn times(x: T, n: usize) T {
+            return @intCast(@as(i64, x) * @as(i64, @intCast(n)));
+        }
+
+        pub inline fn divInt(x: T, n: usize) T {
+            return @divTrunc(x, @as(T, @intCast(n)));
+        }
+    };
+}
+
+/// i64 counterpart of an i32 scalar or vector (products before rescaling)
+fn Wide(comptime V: type) type {
+    return switch (@typeInfo(V)) {
+        .Vector => |vector| @Vector(vector.len, i64),
+        else => i64,
+    };
+}
+
+/// Shift-amount type for `>>` on W
+fn Shift(comptime W: type) type {
+    return switch (@typeInfo(W)) {
+        .Vector => |vector| @Vector(vector.len, u6),
+        else => u6,
+    };
+}
+
+/// Broadcast a scalar when V is a vector
+inline fn splat(comptime V: type, x: anytype) V {
+    if (comptime @typeInfo(V) == .Vector) return @splat(x);
+    return x;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "Fixed: conversions and arithmetic" {
+    const a = Fixed.fromFloat(1.5);
+    const b = Fixed.fromFloat(-2.25);
+
+    try std.testing.expectEqual(@as(i32, 3 << 15), a);
+    try std.testing.expectEqual(@as(f32, -3.375), Fixed.toFloat(Fixed.mul(a, b)));
+    try std.testing.expectEqual(@as(f32, -1.5), Fixed.toFloat(Fixed.div(b, a)));
+    try std.testing.expectEqual(@as(f32, 4.5), Fixed.toFloat(Fixed.times(a, 3)));
+    try std.testing.expectEqual(@as(f32, 0.75), Fixed.toFloat(Fixed.divInt(a, 2)));
+    try std.testing.expectEqual(Fixed.fromInt(7), Fixed.fromFloat(7));
+
+    // Infinite max sizes saturate and come back infinite
+    try std.testing.expectEqual(Fixed.unbounded, Fixed.fromFloat(std.math.inf(f32)));
+    try std.testing.expect(std.math.isInf(Fixed.toFloat(Fixed.unbounded)));
+}
+
+test "Integer scalars: vector ops match scalar ops" {
+    inline for (.{ Pixels, Fixed }) |S| {
+        const V = @Vector(4, i32);
+        const a = [4]i32{ S.fromInt(3), S.fromInt(-5), S.fromInt(120), 7 };
+        const b = [4]i32{ S.fromInt(2), S.fromInt(4), S.fromInt(-1), 9 };
+
+        const products: [4]i32 = S.mul(@as(V, a), @as(V, b));
+        const shares: [4]i32 = S.mulDiv(@as(V, a), S.fromInt(10), S.fromInt(3));
+        for (0..4) |i| {
+            try std.testing.expectEqual(S.mul(a[i], b[i]), products[i]);
+            try std.testing.expectEqual(S.mulDiv(a[i], S.fromInt(10), S.fromInt(3)), shares[i]);
+        }
+    }
+}
+
+test "Pixels: ratios are taken before truncating" {
+    // 300px over factors 1 and 2 is 100 and 200, not 0 (integer ratio)
+    try std.testing.expectEqual(@as(i32, 100), Pixels.mulDiv(@as(i32, 1), 300, 3));
+    try std.testing.expectEqual(@as(i32, 200), Pixels.mulDiv(@as(i32, 2), 300, 3));
+    try std.testing.expectEqual(@as(i32, 33), Pixels.divInt(100, 3));
+}
@@ -6,10 +6,24 @@
 
 const std = @import("std");
 const builtin = @import("builtin");
+const scalar = @import("scalar.zig");
 
 /// SIMD vector size (process 4 floats at once)
 const Vec4 = @Vector(4, f32);
 
+/// f32 kernels, as used by the engine
+const kernels = Kernels(scalar.Float);
+
+/// Native vector width for the f32 flex kernels (8 on AVX, 4 on SSE/NEON)
+pub const LANES = kernels.LANES;
+pub const sum = kernels.sum;
+pub const multiply = kernels.multiply;
+pub const addScalar = kernels.addScalar;
+pub const resolveFlexible = kernels.resolveFlexible;
+pub const resolveFlexibleScalar = kernels.resolveFlexibleScalar;
+pub const cumulativeSum = kernels.cumulativeSum;
+pub const exclusiveOffsets = kernels.exclusiveOffsets;
+
 /// Clamp widths to min/max constraints using SIMD
 ///
 /// **Performance:** 2-4x faster than scalar (measured with benchmarks)
@@ -84,28 +98,248 @@ pub fn applyOffsets(
     }
 }
 
-/// Compute cumulative sum (prefix sum) using SIMD
+/// Flex kernels specialized for a layout scalar (see scalar.zig)
 ///
-/// Used for: Positioning children in stack layout
-///
-/// Example: [10, 20, 30] → [10, 30, 60]
-pub fn cumulativeSum(values: []f32) void {
-    if (values.len == 0) return;
-
-    // For small arrays, scalar is faster (SIMD overhead not worth it)
-    if (values.len < 16) {
-        for (values[1..], 0..) |*val, i| {
-            val.* += values[i];
+/// The vector width follows the scalar: f32 and i32 lanes are the same
+/// size, so a Q16.16 build keeps the f32 lane count, while targets without
+/// SIMD registers fall back to 4-wide vectors that LLVM scalarizes.
+pub fn Kernels(comptime S: type) type {
+    return struct {
+        const T = S.T;
+
+        pub const LANES = std.simd.suggestVectorLength(T) orelse 4;
+        const Lane = @Vector(LANES, T);
+        const zero: Lane = @splat(0);
+
+        /// Load LANES values starting at i; lanes past the end read `fill`
+        inline fn load(values: []const T, i: usize, fill: T) Lane {
+            if (i + LANES <= values.len) return values[i..][0..LANES].*;
+            var buf = [_]T{fill} ** LANES;
+            @memcpy(buf[0 .. values.len - i], values[i..]);
+            return buf;
         }
-        return;
-    }
 
-    // SIMD prefix sum (Blelloch scan algorithm)
-    // TODO: Implement SIMD scan for very large arrays
-    // For now, use scalar (still fast for typical UI element counts)
-    for (values[1..], 0..) |*val, i| {
-        val.* += values[i];
-    }
+        /// Store LANES values starting at i; lanes past the end are dropped
+        inline fn store(values: []T, i: usize, v: Lane) void {
+            if (i + LANES <= values.len) {
+                values[i..][0..LANES].* = v;
+                return;
+            }
+            const buf: [LANES]T = v;
+            @memcpy(values[i..], buf[0 .. values.len - i]);
+        }
+
+        /// Sum of all values
+        pub fn sum(values: []const T) T {
+            var acc = zero;
+            var i: usize = 0;
+            while (i < values.len) : (i += LANES) {
+                acc += load(values, i, 0);
+            }
+            return @reduce(.Add, acc);
+        }
+
+        /// dst[i] = a[i] * b[i]
+        pub fn multiply(dst: []T, a: []const T, b: []const T) void {
+            std.debug.assert(dst.len == a.len and dst.len == b.len);
+            var i: usize = 0;
+            while (i < dst.len) : (i += LANES) {
+                store(dst, i, S.mul(load(a, i, 0), load(b, i, 0)));
+            }
+        }
+
+        /// dst[i] = src[i] + value
+        pub fn addScalar(dst: []T, src: []const T, value: T) void {
+            std.debug.assert(dst.len == src.len);
+            const s: Lane = @splat(value);
+            var i: usize = 0;
+            while (i < dst.len) : (i += LANES) {
+                store(dst, i, load(src, i, 0) + s);
+            }
+        }
+
+        /// Resolve flexible lengths (CSS flexbox 9.7) on SoA lanes
+        ///
+        /// Distributes `available - sum(used sizes)` over items in proportion to
+        /// `factor` (flex-grow, or flex-shrink * base size when shrinking). Items
+        /// whose share violates min/max are clamped and frozen, and the rest is
+        /// redistributed until no violation remains. Items with a zero factor
+        /// start frozen at their clamped base size.
+        ///
+        /// Shares are taken as factor * free / total rather than factor *
+        /// (free / total), so integer scalars do not truncate the ratio first.
+        ///
+        /// `factor` is consumed (frozen items are zeroed). Result goes to `size`.
+        ///
+        /// Every round is three vector passes; each round freezes at least one
+        /// item, so there are at most n + 1 rounds (typically 1-2).
+        pub fn resolveFlexible(
+            base: []const T,
+            factor: []T,
+            min: []const T,
+            max: []const T,
+            size: []T,
+            available: T,
+        ) void {
+            const n = base.len;
+            std.debug.assert(factor.len == n and min.len == n and max.len == n and size.len == n);
+
+            // Hypothetical sizes
+            var i: usize = 0;
+            while (i < n) : (i += LANES) {
+                store(size, i, @min(@max(load(base, i, 0), load(min, i, 0)), load(max, i, 0)));
+            }
+
+            while (true) {
+                // Space taken by frozen items (final size) and flexible ones (base)
+                var used = zero;
+                var total_factor = zero;
+                i = 0;
+                while (i < n) : (i += LANES) {
+                    const f = load(factor, i, 0);
+                    used += @select(T, f > zero, load(base, i, 0), load(size, i, 0));
+                    total_factor += f;
+                }
+                const total = @reduce(.Add, total_factor);
+                if (total <= 0) return;
+
+                const free = available - @reduce(.Add, used);
+
+                // Sum of min/max violations over flexible items
+                var violation = zero;
+                i = 0;
+                while (i < n) : (i += LANES) {
+                    const f = load(factor, i, 0);
+                    const target = load(base, i, 0) + S.mulDiv(f, free, total);
+                    const clamped = @min(@max(target, load(min, i, 0)), load(max, i, 0));
+                    violation += @select(T, f > zero, clamped - target, zero);
+                }
+                const total_violation = @reduce(.Add, violation);
+
+                // No violations: take the targets. Otherwise freeze the items
+                // violating in the direction of the total and go again.
+                i = 0;
+                while (i < n) : (i += LANES) {
+                    const f = load(factor, i, 0);
+                    const target = load(base, i, 0) + S.mulDiv(f, free, total);
+                    const clamped = @min(@max(target, load(min, i, 0)), load(max, i, 0));
+                    const active = f > zero;
+                    const delta = @select(T, active, clamped - target, zero);
+                    const take = if (total_violation == 0)
+                        active
+                    else if (total_violation > 0)
+                        delta > zero
+                    else
+                        delta < zero;
+                    store(size, i, @select(T, take, clamped, load(size, i, 0)));
+                    if (total_violation != 0) store(factor, i, @select(T, take, zero, f));
+                }
+                if (total_violation == 0) return;
+            }
+        }
+
+        /// Scalar reference for resolveFlexible (tests and benchmarks)
+        pub fn resolveFlexibleScalar(
+            base: []const T,
+            factor: []T,
+            min: []const T,
+            max: []const T,
+            size: []T,
+            available: T,
+        ) void {
+            for (size, base, min, max) |*s, b, lo, hi| s.* = @min(@max(b, lo), hi);
+
+            while (true) {
+                var used: T = 0;
+                var total: T = 0;
+                for (base, factor, size) |b, f, s| {
+                    used += if (f > 0) b else s;
+                    total += f;
+                }
+                if (total <= 0) return;
+
+                const free = available - used;
+                var total_violation: T = 0;
+                for (base, factor, min, max) |b, f, lo, hi| {
+                    if (f <= 0) continue;
+                    const target = b + S.mulDiv(f, free, total);
+                    total_violation += @min(@max(target, lo), hi) - target;
+                }
+
+                for (base, factor, min, max, size) |b, *f, lo, hi, *s| {
+                    if (f.* <= 0) continue;
+                    const target = b + S.mulDiv(f.*, free, total);
+                    const clamped = @min(@max(target, lo), hi);
+                    const delta = clamped - target;
+                    if (total_violation == 0) {
+                        s.* = clamped;
+                    } else if ((total_violation > 0 and delta > 0) or (total_violation < 0 and delta < 0)) {
+                        s.* = clamped;
+                        f.* = 0;
+                    }
+                }
+                if (total_violation == 0) return;
+            }
+        }
+
+        /// Shift lanes up by k, filling the bottom with zeros: [a b c d] -> [0 a b c] (k = 1)
+        inline fn shiftLanesUp(v: Lane, comptime k: usize) Lane {
+            const mask = comptime blk: {
+                var m: [LANES]i32 = undefined;
+                for (0..LANES) |lane| {
+                    // ~0 selects lane 0 of the zero vector
+                    m[lane] = if (lane >= k) @intCast(lane - k) else ~@as(i32, 0);
+                }
+                break :blk m;
+            };
+            return @shuffle(T, v, zero, mask);
+        }
+
+        /// Compute cumulative sum (prefix sum) using SIMD
+        ///
+        /// Used for: Positioning children in stack layout
+        ///
+        /// Each vector is scanned in registers in log2(LANES) shift-and-add steps
+        /// (the up-sweep of a Blelloch scan collapses to this at register width),
+        /// then offset by the running total carried from the previous vector.
+        ///
+        /// Example: [10, 20, 30] → [10, 30, 60]
+        pub fn cumulativeSum(values: []T) void {
+            if (values.len == 0) return;
+
+            // For small arrays, scalar is faster (SIMD overhead not worth it)
+            if (values.len < 16) {
+                for (values[1..], 0..) |*val, i| {
+                    val.* += values[i];
+                }
+                return;
+            }
+
+            var carry: T = 0;
+            var i: usize = 0;
+            while (i < values.len) : (i += LANES) {
+                var v = load(values, i, 0);
+                comptime var shift: usize = 1;
+                inline while (shift < LANES) : (shift *= 2) {
+                    v += shiftLanesUp(v, shift);
+                }
+                v += @as(Lane, @splat(carry));
+                store(values, i, v);
+                carry = v[LANES - 1];
+            }
+        }
+
+        /// Main-axis offsets of consecutive items:
+        /// offsets[i] = start + sum over j < i of (sizes[j] + spacing)
+        pub fn exclusiveOffsets(offsets: []T, sizes: []const T, spacing: T, start: T) void {
+            std.debug.assert(offsets.len == sizes.len);
+            if (sizes.len == 0) return;
+
+            offsets[0] = start;
+            addScalar(offsets[1..], sizes[0 .. sizes.len - 1], spacing);
+            cumulativeSum(offsets);
+        }
+    };
 }
 
 /// Check if any element in boolean array is true using SIMD
@@ -205,3 +439,110 @@ test "cumulativeSum: basic correctness" {
     try std.testing.expectEqual(@as(f32, 60), values[2]);  // 30 + 30
     try std.testing.expectEqual(@as(f32, 100), values[3]); // 60 + 40
 }
+
+test "cumulativeSum: SIMD path matches scalar" {
+    var values: [37]f32 = undefined;
+    for (&values, 0..) |*v, i| v.* = @floatFromInt(i % 7);
+    var expected = values;
+    for (expected[1..], 0..) |*v, i| v.* += expected[i];
+
+    cumulativeSum(&values);
+    try std.testing.expectEqualSlices(f32, &expected, &values);
+}
+
+test "exclusiveOffsets: positions with spacing" {
+    const sizes = [_]f32{ 10, 20, 30 };
+    var offsets: [3]f32 = undefined;
+    exclusiveOffsets(&offsets, &sizes, 5, 100);
+
+    try std.testing.expectEqualSlices(f32, &[_]f32{ 100, 115, 140 }, &offsets);
+}
+
+test "resolveFlexible: redistributes space taken from clamped items" {
+    // 300px over three growers; the first is capped at 50
+    const base = [_]f32{ 0, 0, 0 };
+    var factor = [_]f32{ 1, 1, 1 };
+    const min = [_]f32{ 0, 0, 0 };
+    const max = [_]f32{ 50, std.math.inf(f32), std.math.inf(f32) };
+    var size: [3]f32 = undefined;
+
+    resolveFlexible(&base, &factor, &min, &max, &size, 300);
+
+    try std.testing.expectEqualSlices(f32, &[_]f32{ 50, 125, 125 }, &size);
+}
+
+test "resolveFlexible: matches scalar reference" {
+    var prng = std.Random.DefaultPrng.init(42);
+    const random = prng.random();
+
+    const n = 67; // not a multiple of the vector width
+    var base: [n]f32 = undefined;
+    var min: [n]f32 = undefined;
+    var max: [n]f32 = undefined;
+    var factor: [n]f32 = undefined;
+    for (0..n) |i| {
+        base[i] = @floatFromInt(random.intRangeAtMost(u32, 0, 40));
+        min[i] = @floatFromInt(random.intRangeAtMost(u32, 0, 20));
+        max[i] = if (i % 5 == 0) 30 else std.math.inf(f32);
+        factor[i] = @floatFromInt(random.intRangeAtMost(u32, 0, 3));
+    }
+
+    for ([_]f32{ 500, 1500, 4000 }) |available| {
+        var simd_factor = factor;
+        var scalar_factor = factor;
+        var simd_size: [n]f32 = undefined;
+        var scalar_size: [n]f32 = undefined;
+
+        resolveFlexible(&base, &simd_factor, &min, &max, &simd_size, available);
+        resolveFlexibleScalar(&base, &scalar_factor, &min, &max, &scalar_size, available);
+
+        for (simd_size, scalar_size) |a, b| {
+            try std.testing.expectApproxEqAbs(b, a, 0.01);
+        }
+    }
+}
+
+test "Kernels: fixed-point resolveFlexible matches f32 within rounding" {
+    const Fixed = scalar.Fixed;
+    const fixed = Kernels(Fixed);
+
+    var prng = std.Random.DefaultPrng.init(17);
+    const random = prng.random();
+
+    const n = 45;
+    var base: [n]f32 = undefined;
+    var min: [n]f32 = undefined;
+    var max: [n]f32 = undefined;
+    var factor: [n]f32 = undefined;
+    for (0..n) |i| {
+        base[i] = @floatFromInt(random.intRangeAtMost(u32, 0, 40));
+        min[i] = @floatFromInt(random.intRangeAtMost(u32, 0, 20));
+        max[i] = if (i % 4 == 0) 35 else std.math.inf(f32);
+        factor[i] = @as(f32, @floatFromInt(random.intRangeAtMost(u32, 0, 6))) * 0.5;
+    }
+
+    var q_base: [n]i32 = undefined;
+    var q_min: [n]i32 = undefined;
+    var q_max: [n]i32 = undefined;
+    var q_factor: [n]i32 = undefined;
+    for (0..n) |i| {
+        q_base[i] = Fixed.fromFloat(base[i]);
+        q_min[i] = Fixed.fromFloat(min[i]);
+        q_max[i] = Fixed.fromFloat(max[i]);
+        q_factor[i] = Fixed.fromFloat(factor[i]);
+    }
+
+    for ([_]f32{ 300, 1200, 3000 }) |available| {
+        var f_factor = factor;
+        var f_size: [n]f32 = undefined;
+        resolveFlexible(&base, &f_factor, &min, &max, &f_size, available);
+
+        var q_factor_run = q_factor;
+        var q_size: [n]i32 = undefined;
+        fixed.resolveFlexible(&q_base, &q_factor_run, &q_min, &q_max, &q_size, Fixed.fromFloat(available));
+
+        for (f_size, q_size) |expected, actual| {
+            try std.testing.expectApproxEqAbs(expected, Fixed.toFloat(actual), 0.001);
+        }
+    }
+}
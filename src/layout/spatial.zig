@@ -0,0 +1,367 @@
+//! Spatial index for hit testing
+//!
+//! A sparse uniform grid over absolute rects: each entry is linked into the
+//! cells its rect overlaps, so "what is under the mouse" scans one cell
+//! instead of every widget. Entries covering more than MAX_ENTRY_CELLS cells
+//! (window-sized panels) go to a short side list checked on every query,
+//! which keeps big containers from filling hundreds of cells.
+//!
+//! Updates are incremental: the GUI feeds only nodes whose absolute rect
+//! changed (LayoutEngine.nextMoved) plus this frame's immediate widgets. An
+//! update that stays within the same cells rewrites the entry in place.
+//!
+//! Stacking: the topmost entry is the one with the highest (layer, order)
+//! pair - layer from the draw list's layer stack, order increasing in draw
+//! order. Rects are stored already intersected with their clip, so content
+//! scrolled out of a viewport is never hit.
+
+const std = @import("std");
+const geometry = @import("../core/geometry.zig");
+const Rect = geometry.Rect;
+
+pub const SpatialGrid = struct {
+    allocator: std.mem.Allocator,
+    cell_size: f32,
+    inv_cell_size: f32,
+
+    /// Indexed rects by id
+    entries: std.AutoHashMapUnmanaged(u32, Entry) = .{},
+    /// Cell key → ids overlapping that cell (lists are kept when they
+    /// empty, so steady-state updates do not allocate)
+    cells: std.AutoHashMapUnmanaged(u64, std.ArrayListUnmanaged(u32)) = .{},
+    /// Ids of entries too large to link into cells
+    large: std.ArrayListUnmanaged(u32) = .{},
+
+    /// Cell edge in pixels: a few widgets per cell at typical sizes
+    pub const DEFAULT_CELL_SIZE: f32 = 64;
+    /// Entries spanning more cells than this live in `large`
+    pub const MAX_ENTRY_CELLS: i64 = 64;
+    /// Cell coordinates are clamped to this so any float converts safely
+    const CELL_LIMIT: f32 = 1 << 30;
+
+    pub const Entry = struct {
+        /// Hit area in absolute coordinates, already clipped
+        rect: Rect,
+        layer: u16,
+        order: u32,
+        cells: CellRange,
+
+        fn rank(self: Entry) u64 {
+            return (@as(u64, self.layer) << 32) | self.order;
+        }
+    };
+
+    /// Inclusive range of cells covered by a rect
+    const CellRange = struct {
+        x0: i32,
+        y0: i32,
+        x1: i32,
+        y1: i32,
+
+        fn count(self: CellRange) i64 {
+            return (@as(i64, self.x1) - self.x0 + 1) * (@as(i64, self.y1) - self.y0 + 1);
+        }
+
+        fn isLarge(self: CellRange) bool {
+            return self.count() > MAX_ENTRY_CELLS;
+        }
+
+        fn eql(a: CellRange, b: CellRange) bool {
+            return a.x0 == b.x0 and a.y0 == b.y0 and a.x1 == b.x1 and a.y1 == b.y1;
+        }
+    };
+
+    pub fn init(allocator: std.mem.Allocator, cell_size: f32) SpatialGrid {
+        std.debug.assert(cell_size > 0);
+        return .{
+            .allocator = allocator,
+            .cell_size = cell_size,
+            .inv_cell_size = 1 / cell_size,
+        };
+    }
+
+    pub fn deinit(self: *SpatialGrid) void {
+        var lists = self.cells.valueIterator();
+        while (lists.next()) |list| list.deinit(self.allocator);
+        self.cells.deinit(self.allocator);
+        self.entries.deinit(self.allocator);
+        self.large.deinit(self.allocator);
+    }
+
+    pub fn count(self: *const SpatialGrid) u32 {
+        return self.entries.count();
+    }
+
+    pub fn get(self: *const SpatialGrid, id: u32) ?Entry {
+        return self.entries.get(id);
+    }
+
+    /// Insert or move an entry. `clip` (if any) is intersected with `rect`;
+    /// an entry with nothing left visible is removed.
+    pub fn update(self: *SpatialGrid, id: u32, rect: Rect, clip: ?Rect, layer: u16, order: u32) !void {
+        const visible = if (clip) |c| intersect(rect, c) else rect;
+        if (!(visible.width > 0 and visible.height > 0)) {
+            self.remove(id);
+            return;
+        }
+
+        const cells = self.cellRange(visible);
+        const gop = try self.entries.getOrPut(self.allocator, id);
+        if (gop.found_existing) {
+            const old_cells = gop.value_ptr.cells;
+            gop.value_ptr.* = .{ .rect = visible, .layer = layer, .order = order, .cells = cells };
+            // Same cells: the links are still right
+            if (old_cells.eql(cells)) return;
+            self.unlink(id, old_cells);
+        } else {
+            gop.value_ptr.* = .{ .rect = visible, .layer = layer, .order = order, .cells = cells };
+        }
+
+        self.link(id, cells) catch |err| {
+            self.unlink(id, cells);
+            _ = self.entries.remove(id);
+            return err;
+        };
+    }
+
+    pub fn remove(self: *SpatialGrid, id: u32) void {
+        const entry = self.entries.fetchRemove(id) orelse return;
+        self.unlink(id, entry.value.cells);
+    }
+
+    pub fn clear(self: *SpatialGrid) void {
+        var lists = self.cells.valueIterator();
+        while (lists.next()) |list| list.clearRetainingCapacity();
+        self.entries.clearRetainingCapacity();
+        self.large.clearRetainingCapacity();
+    }
+
+    /// Topmost entry containing the point (half-open rects, like the
+    /// widgets' own hit checks), or null
+    pub fn hitTest(self: *const SpatialGrid, x: f32, y: f32) ?u32 {
+        var best: ?u32 = null;
+        var best_rank: u64 = 0;
+
+        if (self.cells.get(cellKey(self.cellCoord(x), self.cellCoord(y)))) |list| {
+            for (list.items) |id| self.considerHit(id, x, y, &best, &best_rank);
+        }
+        for (self.large.items) |id| self.considerHit(id, x, y, &best, &best_rank);
+        return best;
+    }
+
+    /// Append the ids of every entry overlapping `rect` to `out`, each once,
+    /// in no particular order
+    pub fn query(self: *const SpatialGrid, rect: Rect, out: *std.ArrayList(u32)) !void {
+        if (!(rect.width > 0 and rect.height > 0)) return;
+
+        const range = self.cellRange(rect);
+        if (range.count() > self.entries.count()) {
+            // Scanning the cells would cost more than checking every entry
+            var iter = self.entries.iterator();
+            while (iter.next()) |kv| {
+                if (overlaps(kv.value_ptr.rect, rect)) try out.append(kv.key_ptr.*);
+            }
+            return;
+        }
+
+        var cy = range.y0;
+        while (cy <= range.y1) : (cy += 1) {
+            var cx = range.x0;
+            while (cx <= range.x1) : (cx += 1) {
+                const list = self.cells.get(cellKey(cx, cy)) orelse continue;
+                for (list.items) |id| {
+                    const entry = self.entries.get(id).?;
+                    // Report each entry from the first cell it shares with the query
+                    if (cx != @max(entry.cells.x0, range.x0) or cy != @max(entry.cells.y0, range.y0)) continue;
+                    if (overlaps(entry.rect, rect)) try out.append(id);
+                }
+            }
+        }
+        for (self.large.items) |id| {
+            if (overlaps(self.entries.get(id).?.rect, rect)) try out.append(id);
+        }
+    }
+
+    fn considerHit(self: *const SpatialGrid, id: u32, x: f32, y: f32, best: *?u32, best_rank: *u64) void {
+        const entry = self.entries.get(id).?;
+        const r = entry.rect;
+        if (!(x >= r.x and x < r.x + r.width and y >= r.y and y < r.y + r.height)) return;
+
+        const rank = entry.rank();
+        // Ties (same layer and order) go to the higher id, so results do
+        // not depend on cell list order
+        if (best.* == null or rank > best_rank.* or (rank == best_rank.* and id > best.*.?)) {
+            best.* = id;
+            best_rank.* = rank;
+        }
+    }
+
+    fn link(self: *SpatialGrid, id: u32, cells: CellRange) !void {
+        if (cells.isLarge()) {
+            try self.large.append(self.allocator, id);
+            return;
+        }
+        var cy = cells.y0;
+        while (cy <= cells.y1) : (cy += 1) {
+            var cx = cells.x0;
+            while (cx <= cells.x1) : (cx += 1) {
+                const gop = try self.cells.getOrPut(self.allocator, cellKey(cx, cy));
+                if (!gop.found_existing) gop.value_ptr.* = .{};
+                try gop.value_ptr.append(self.allocator, id);
+            }
+        }
+    }
+
+    /// Drop `id` from the cells it was linked into (tolerates partial links)
+    fn unlink(self: *SpatialGrid, id: u32, cells: CellRange) void {
+        if (cells.isLarge()) {
+            removeId(&self.large, id);
+            return;
+        }
+        var cy = cells.y0;
+        while (cy <= cells.y1) : (cy += 1) {
+            var cx = cells.x0;
+            while (cx <= cells.x1) : (cx += 1) {
+                if (self.cells.getPtr(cellKey(cx, cy))) |list| removeId(list, id);
+            }
+        }
+    }
+
+    fn removeId(list: *std.ArrayListUnmanaged(u32), id: u32) void {
+        for (list.items, 0..) |item, i| {
+            if (item == id) {
+                _ = list.swapRemove(i);
+                return;
+            }
+        }
+    }
+
+    fn cellRange(self: *const SpatialGrid, rect: Rect) CellRange {
+        const x0 = self.cellCoord(rect.x);
+        const y0 = self.cellCoord(rect.y);
+        // Right and bottom edges are exclusive: a 64px rect at 0 stays in cell 0
+        return .{
+            .x0 = x0,
+            .y0 = y0,
+            .x1 = @max(x0, self.lastCellCoord(rect.x + rect.width)),
+            .y1 = @max(y0, self.lastCellCoord(rect.y + rect.height)),
+        };
+    }
+
+    fn cellCoord(self: *const SpatialGrid, v: f32) i32 {
+        return @intFromFloat(std.math.clamp(@floor(v * self.inv_cell_size), -CELL_LIMIT, CELL_LIMIT));
+    }
+
+    fn lastCellCoord(self: *const SpatialGrid, end: f32) i32 {
+        return @intFromFloat(std.math.clamp(@ceil(end * self.inv_cell_size) - 1, -CELL_LIMIT, CELL_LIMIT));
+    }
+
+    fn cellKey(cx: i32, cy: i32) u64 {
+        return (@as(u64, @as(u32, @bitCast(cx))) << 32) | @as(u32, @bitCast(cy));
+    }
+};
+
+fn intersect(a: Rect, b: Rect) Rect {
+    const x1 = @max(a.x, b.x);
+    const y1 = @max(a.y, b.y);
+    const x2 = @min(a.x + a.width, b.x + b.width);
+    const y2 = @min(a.y + a.height, b.y + b.height);
+    if (x2 <= x1 or y2 <= y1) return Rect.zero();
+    return .{ .x = x1, .y = y1, .width = x2 - x1, .height = y2 - y1 };
+}
+
+fn overlaps(a: Rect, b: Rect) bool {
+    return a.x < b.x + b.width and b.x < a.x + a.width and
+        a.y < b.y + b.height and b.y < a.y + a.height;
+}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+test "SpatialGrid: topmost entry wins by layer, then order" {
+    var grid = SpatialGrid.init(std.testing.allocator, SpatialGrid.DEFAULT_CELL_SIZE);
+    defer grid.deinit();
+
+    try grid.update(1, .{ .x = 0, .y = 0, .width = 800, .height = 600 }, null, 0, 0); // window panel
+    try grid.update(2, .{ .x = 100, .y = 100, .width = 80, .height = 30 }, null, 0, 5); // button
+    try grid.update(3, .{ .x = 90, .y = 90, .width = 200, .height = 200 }, null, 1, 0); // popup
+
+    try std.testing.expectEqual(@as(?u32, 3), grid.hitTest(120, 110));
+    try std.testing.expectEqual(@as(?u32, 1), grid.hitTest(10, 10));
+    try std.testing.expectEqual(@as(?u32, null), grid.hitTest(900, 10));
+
+    // Popup closes: the button underneath is hit again
+    grid.remove(3);
+    try std.testing.expectEqual(@as(?u32, 2), grid.hitTest(120, 110));
+    // Right and bottom edges are exclusive
+    try std.testing.expectEqual(@as(?u32, 1), grid.hitTest(180, 110));
+    try std.testing.expectEqual(@as(u32, 2), grid.count());
+}
+
+test "SpatialGrid: clip hides scrolled-out content" {
+    var grid = SpatialGrid.init(std.testing.allocator, 32);
+    defer grid.deinit();
+
+    const viewport = Rect{ .x = 0, .y = 0, .width = 300, .height = 200 };
+    try grid.update(7, .{ .x = 0, .y = 180, .width = 300, .height = 40 }, viewport, 0, 1);
+    try std.testing.expectEqual(@as(?u32, 7), grid.hitTest(10, 190));
+    try std.testing.expectEqual(@as(?u32, null), grid.hitTest(10, 210));
+
+    // Scrolled fully out of view: dropped
+    try grid.update(7, .{ .x = 0, .y = 260, .width = 300, .height = 40 }, viewport, 0, 1);
+    try std.testing.expectEqual(@as(u32, 0), grid.count());
+    try std.testing.expectEqual(@as(?u32, null), grid.hitTest(10, 190));
+}
+
+test "SpatialGrid: moves and queries match a linear scan" {
+    var grid = SpatialGrid.init(std.testing.allocator, 50);
+    defer grid.deinit();
+
+    var rects: [300]Rect = undefined;
+    var prng = std.Random.DefaultPrng.init(0x5a7);
+    const random = prng.random();
+    // Second round moves every entry
+    for (0..2) |_| {
+        for (&rects, 0..) |*rect, i| {
+            rect.* = .{
+                .x = random.float(f32) * 1000 - 100,
+                .y = random.float(f32) * 1000 - 100,
+                // A few entries big enough for the large list
+                .width = if (i % 50 == 0) 900 else random.float(f32) * 120 + 1,
+                .height = if (i % 50 == 0) 700 else random.float(f32) * 120 + 1,
+            };
+            try grid.update(@intCast(i), rect.*, null, 0, @intCast(i));
+        }
+    }
+
+    var found = std.ArrayList(u32).init(std.testing.allocator);
+    defer found.deinit();
+    for (0..40) |_| {
+        const area = Rect{
+            .x = random.float(f32) * 1000 - 100,
+            .y = random.float(f32) * 1000 - 100,
+            .width = random.float(f32) * 300 + 1,
+            .height = random.float(f32) * 300 + 1,
+        };
+        found.clearRetainingCapacity();
+        try grid.query(area, &found);
+
+        var expected: usize = 0;
+        for (rects, 0..) |rect, i| {
+            if (!overlaps(rect, area)) continue;
+            expected += 1;
+            try std.testing.expect(std.mem.indexOfScalar(u32, found.items, @intCast(i)) != null);
+        }
+        try std.testing.expectEqual(expected, found.items.len);
+
+        // Point hits agree with the highest-order rect containing the point
+        const x = area.x;
+        const y = area.y;
+        var top: ?u32 = null;
+        for (rects, 0..) |r, i| {
+            if (x >= r.x and x < r.x + r.width and y >= r.y and y < r.y + r.height) top = @intCast(i);
+        }
+        try std.testing.expectEqual(top, grid.hitTest(x, y));
+    }
+}
@@ -64,9 +64,11 @@ pub const RendererInterface = @import("renderer.zig").RendererInterface;
 //
 // draw_list.addFilledRect(.{ .x = 0, .y = 0, .width = 100, .height = 50 }, Color.fromRGB(255, 0, 0));
 // draw_list.addText(.{ .x = 10, .y = 10 }, "Hello", Color.fromRGB(0, 0, 0));
+// draw_list.finalize(); // sort by layer, batch
 //
 // const draw_data = draw.DrawData{
 //     .commands = draw_list.getCommands(),
+//     .batches = draw_list.getBatches(),
 //     .display_size = .{ .width = 800, .height = 600 },
 // };
 //
@@ -78,6 +80,8 @@ pub const RendererInterface = @import("renderer.zig").RendererInterface;
 pub const draw = struct {
     pub const DrawPrimitive = @import("draw.zig").DrawPrimitive;
     pub const DrawCommand = @import("draw.zig").DrawCommand;
+    pub const DrawBatch = @import("draw.zig").DrawBatch;
+    pub const LayerOrder = @import("draw.zig").LayerOrder;
     pub const DrawList = @import("draw.zig").DrawList;
     pub const DrawData = @import("draw.zig").DrawData;
     pub const RenderBackend = @import("draw.zig").RenderBackend;
@@ -91,6 +95,8 @@ pub const draw = struct {
     pub const rectIntersect = @import("draw.zig").rectIntersect;
     pub const colorToARGB = @import("draw.zig").colorToARGB;
     pub const colorToRGBA = @import("draw.zig").colorToRGBA;
+    pub const fillSpan = @import("draw.zig").fillSpan;
+    pub const SPAN_LANES = @import("draw.zig").SPAN_LANES;
 };
 
 // =============================================================================
@@ -182,6 +188,14 @@ pub const FontHandle = @import("core/font.zig").FontHandle;
 // Old retained-mode components (View, Container, Box) removed.
 // New immediate-mode API coming: gui.button(id, text), gui.container(id, style, fn), etc.
 
+pub const components = struct {
+    /// Row geometry for virtualized lists (see GUI.beginVirtualList)
+    pub const VirtualList = @import("components/list.zig").VirtualList;
+
+    /// Prefix sums over variable row heights
+    pub const HeightIndex = @import("components/list.zig").HeightIndex;
+};
+
 // =============================================================================
 // Widget ID System
 // =============================================================================
@@ -227,6 +241,19 @@ pub const layout = struct {
     /// Performance: 0.029-0.107μs per element (validated with 31 tests)
     pub const LayoutEngine = @import("layout.zig").LayoutEngine;
 
+    /// Thread pool for parallel layout of fixed-size subtrees (also drives
+    /// SoftwareBackend.enableTiling)
+    pub const LayoutPool = @import("layout.zig").LayoutPool;
+
+    /// Spatial index for hit testing (topmost rect under a point, rects in an area)
+    pub const SpatialGrid = @import("layout.zig").SpatialGrid;
+
+    /// Bounded list of changed screen regions (LayoutEngine.collectDamage)
+    pub const DamageList = @import("layout.zig").DamageList;
+
+    /// Measure callback for content-sized leaves (see LayoutEngine.setMeasureFunc)
+    pub const MeasureFn = @import("layout.zig").MeasureFn;
+
     /// Flexbox style configuration
     pub const FlexStyle = @import("layout.zig").FlexStyle;
 
@@ -239,9 +266,33 @@ pub const layout = struct {
     /// Cross axis alignment
     pub const AlignItems = @import("layout.zig").AlignItems;
 
+    /// Line wrapping
+    pub const FlexWrap = @import("layout.zig").FlexWrap;
+
+    /// Cross axis distribution of wrapped lines
+    pub const AlignContent = @import("layout.zig").AlignContent;
+
+    /// Overflow handling (visible, hidden, scroll)
+    pub const Overflow = @import("layout.zig").Overflow;
+
+    /// Positioning scheme (relative in flow, absolute out of flow)
+    pub const Position = @import("layout.zig").Position;
+
     /// Layout result
     pub const LayoutResult = @import("layout.zig").LayoutResult;
 
+    /// Flexbox algorithm for one container (single- or multi-line)
+    pub const computeFlexLayout = @import("layout.zig").computeFlexLayout;
+
+    /// Flexbox instantiated over a layout scalar (Float, Pixels, Fixed)
+    pub const Flexbox = @import("layout.zig").Flexbox;
+
+    /// Layout scalars: f32, i32 whole pixels, Q16.16 fixed point
+    pub const scalar = @import("layout.zig").scalar;
+
+    /// SIMD kernels used by flex resolution
+    pub const simd = @import("layout.zig").simd;
+
     /// Cache statistics
     pub const CacheStats = @import("layout.zig").CacheStats;
 };
@@ -76,7 +76,7 @@ TEST(abi_struct_sizes) {
     ASSERT_EQ(zgl_rect_size(), sizeof(ZglRect));
 
     /* Known sizes */
-    ASSERT_EQ(sizeof(ZglStyle), 56);
+    ASSERT_EQ(sizeof(ZglStyle), 60);
     ASSERT_EQ(sizeof(ZglRect), 16);
 }
 